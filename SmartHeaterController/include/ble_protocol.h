@@ -0,0 +1,150 @@
+#ifndef BLE_PROTOCOL_H
+#define BLE_PROTOCOL_H
+
+#include <stdint.h>
+
+/**
+ * BLE Protocol Constants - Oil Heater
+ *
+ * Service UUID MUST match SERVICE_UUIDS.OIL_HEATER in @crewchiefsteve/ble
+ * (packages/ble/src/constants/uuids.ts).
+ */
+
+// ================================================================
+// SERVICE UUID - Oil Heater (0001)
+// ================================================================
+#define SERVICE_UUID        "4fafc201-0001-459e-8fcc-c5c9c331914b"
+
+// ================================================================
+// CHARACTERISTIC UUIDs
+// ================================================================
+
+/**
+ * TEMPERATURE (26a8)
+ * Properties: READ, NOTIFY
+ * Format: ASCII "%.1f" (°F)
+ */
+#define TEMP_CHAR_UUID      "beb5483e-36e1-4688-b7f5-ea07361b26a8"
+
+/**
+ * SETPOINT (26a9)
+ * Properties: READ, WRITE, WRITE_NR, NOTIFY
+ * Format: ASCII "%.1f" (°F)
+ */
+#define SETPOINT_CHAR_UUID  "beb5483e-36e1-4688-b7f5-ea07361b26a9"
+
+/**
+ * STATUS (26aa)
+ * Properties: READ, NOTIFY
+ * Format: JSON UTF-8
+ * Example: {"heater":true,"safetyShutdown":false,"sensorError":false,"eta":1260}
+ *
+ * eta: whole seconds until the setpoint is reached at full power
+ *   0  = at temperature
+ *   -1 = unknown (model still learning, HeatupEstimator::ETA_UNKNOWN)
+ *   -2 = setpoint above what the heater can reach (ETA_UNREACHABLE)
+ */
+#define STATUS_CHAR_UUID    "beb5483e-36e1-4688-b7f5-ea07361b26aa"
+
+/**
+ * HISTORY (26ab)
+ * Properties: WRITE, NOTIFY
+ * Purpose: Bulk download of the on-device temperature history
+ *
+ * Request (write):
+ *   empty            - send everything held
+ *   uint32 LE index  - send samples from this running index on
+ *
+ * Response (notify, one or more chunks sized to the negotiated MTU):
+ *   HistoryChunkHeader followed by `count` int16 LE samples.
+ *   Each sample is (tenths of °F << 1) | relay bit.
+ *   A chunk with count == 0 ends the transfer; its firstIndex is the index
+ *   the next sample will get, so the app can resume from there later.
+ *
+ * Sample i was recorded (endIndex - i) * intervalS seconds before the
+ * terminating chunk was sent.
+ */
+#define HISTORY_CHAR_UUID   "beb5483e-36e1-4688-b7f5-ea07361b26ab"
+
+struct __attribute__((packed)) HistoryChunkHeader {
+    uint32_t firstIndex;    // Running index of the first sample in this chunk
+    uint16_t count;         // Samples that follow (0 = end of transfer)
+    uint16_t intervalS;     // Seconds between samples
+};
+
+/**
+ * TELEMETRY (26ac)
+ * Properties: READ, NOTIFY
+ * Format: TelemetryFrame, 11 bytes, little-endian, packed
+ * Purpose: Everything the three ASCII/JSON characteristics carry, in one
+ *          notification per change with no string parsing. The ASCII
+ *          characteristics are kept for older app versions.
+ *
+ * A frame is notified when the temperature or setpoint changes by 0.1°F
+ * or any flag changes. sequence increments per notified frame (wraps), so
+ * the app can detect dropped notifications.
+ */
+#define TELEMETRY_CHAR_UUID "beb5483e-36e1-4688-b7f5-ea07361b26ac"
+
+#define TELEMETRY_FLAG_HEATER_ON        0x01
+#define TELEMETRY_FLAG_SAFETY_SHUTDOWN  0x02
+#define TELEMETRY_FLAG_SENSOR_ERROR     0x04
+#define TELEMETRY_FLAG_AUTOTUNING       0x08
+#define TELEMETRY_FLAG_PREHEAT_HOLD     0x10    // Held off by a preheat schedule
+
+struct __attribute__((packed)) TelemetryFrame {
+    int16_t tempDeciF;          // Filtered temperature, tenths of °F
+    int16_t setpointDeciF;      // Setpoint, tenths of °F
+    uint8_t flags;              // TELEMETRY_FLAG_*
+    uint16_t sequence;          // Per notified frame
+    uint32_t uptimeS;           // Seconds since boot
+};
+
+static_assert(sizeof(TelemetryFrame) == 11, "TelemetryFrame wire size");
+
+/**
+ * PREHEAT (26ad)
+ * Properties: READ, WRITE, NOTIFY
+ * Purpose: "Ready at HH:MM" schedule and wall-clock sync
+ *
+ * Write: PreheatCommandFrame (7 bytes). localTime is the phone's current
+ * local time as seconds since 1970 (UTC epoch + UTC offset); 0 leaves the
+ * clock alone. The device has no RTC, so the app should send
+ * PREHEAT_OP_SYNC_CLOCK on every connect; an armed schedule survives a
+ * power cycle but holds the heater off until the clock is set again.
+ *
+ * Read/notify: PreheatStatusFrame (13 bytes), notified when the state or
+ * start time changes. Times are in the same local seconds.
+ */
+#define PREHEAT_CHAR_UUID   "beb5483e-36e1-4688-b7f5-ea07361b26ad"
+
+#define PREHEAT_OP_SYNC_CLOCK   0
+#define PREHEAT_OP_ARM          1   // Ready at hour:minute (next occurrence)
+#define PREHEAT_OP_CANCEL       2
+
+struct __attribute__((packed)) PreheatCommandFrame {
+    uint8_t op;                 // PREHEAT_OP_*
+    uint8_t hour;               // 0-23 (ARM)
+    uint8_t minute;             // 0-59 (ARM)
+    uint32_t localTime;         // Current local time, 0 = don't set
+};
+
+struct __attribute__((packed)) PreheatStatusFrame {
+    uint8_t state;              // PreheatScheduler::State
+    uint32_t readyTime;         // 0 when idle
+    uint32_t startTime;         // Latest start time (0 until computed)
+    uint32_t localTime;         // Device clock, 0 = not set
+};
+
+static_assert(sizeof(PreheatCommandFrame) == 7, "PreheatCommandFrame wire size");
+static_assert(sizeof(PreheatStatusFrame) == 13, "PreheatStatusFrame wire size");
+
+/**
+ * CALIBRATION (26ae) - reserved
+ * Used under this service by the oil-heater-system controller (its
+ * BLE_CHAR_CAL_UUID: ASCII command write / JSON read). Not implemented here;
+ * do not reuse 26ae for another characteristic of the oil heater service.
+ */
+#define CALIBRATION_CHAR_UUID "beb5483e-36e1-4688-b7f5-ea07361b26ae"
+
+#endif // BLE_PROTOCOL_H
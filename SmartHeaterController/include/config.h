@@ -7,6 +7,9 @@
 #define I2C_SDA_PIN 32
 #define I2C_SCL_PIN 25
 #define I2C_FREQUENCY 100000  // 100kHz
+#define I2C_FAST_FREQUENCY 400000  // 400kHz, used only if the bus verifies clean
+#define I2C_TRY_FAST_MODE 1        // Set to 0 to always stay at I2C_FREQUENCY
+#define I2C_FAST_VERIFY_READS 16   // Clean readbacks required before switching
 
 // ========================================
 // MCP23017 I/O Expander Configuration
@@ -45,11 +48,34 @@
 // Thermostat Configuration
 // ========================================
 #define DEFAULT_SETPOINT_F 180.0f      // Default setpoint in Fahrenheit (race oil)
-#define TEMP_HYSTERESIS_F 1.0f         // Temperature hysteresis band (±1°F)
 #define MIN_SETPOINT_F 50.0f           // Minimum allowed setpoint
 #define MAX_SETPOINT_F 280.0f          // Maximum allowed setpoint
 #define SETPOINT_INCREMENT 5.0f        // Increment/decrement step for setpoint
 
+// ========================================
+// PID Control Configuration
+// ========================================
+#define PID_WINDOW_MS 60000            // Time-proportioning window (relay slow PWM period)
+#define PID_DEFAULT_KP 0.08f           // Duty per °F of error (12.5°F error = full on)
+#define PID_DEFAULT_KI 0.0004f         // Duty per °F·s of accumulated error
+#define PID_DEFAULT_KD 0.0f            // Duty per °F/s of temperature change
+#define PID_DERIVATIVE_FILTER_S 10.0f  // Derivative low-pass time constant (seconds)
+
+// Relay-feedback autotune (serial 't')
+#define AUTOTUNE_HYSTERESIS_F 2.0f     // Relay switches at setpoint ±2°F
+#define AUTOTUNE_CYCLES 3              // Measured oscillations to average
+#define AUTOTUNE_TIMEOUT_MS (3UL * 60UL * 60UL * 1000UL)  // Give up after 3 hours
+
+// ========================================
+// NVS Storage
+// ========================================
+#define NVS_NAMESPACE "oilheater"
+#define NVS_PID_KP_KEY "pid_kp"
+#define NVS_PID_KI_KEY "pid_ki"
+#define NVS_PID_KD_KEY "pid_kd"
+#define NVS_PREHEAT_READY_KEY "pre_ready"   // Armed ready time (0 = none)
+#define NVS_HEATUP_MODEL_KEY "heat_model"   // HeatupEstimator::Model blob
+
 // ========================================
 // Safety Configuration
 // ========================================
@@ -60,11 +86,64 @@
 // ========================================
 // Timing Configuration
 // ========================================
-#define TEMP_READ_INTERVAL 15000        // Read temperature every 15 seconds (ms)
+#define SAMPLE_INTERVAL_MS 250          // Read MAX6675 at its native conversion rate (~4 Hz)
+#define MEDIAN_WINDOW 5                 // Median-of-N spike rejection on raw samples
+#define CONTROL_INTERVAL_MS 1000        // Thermostat evaluation period (ms)
+#define STATUS_LOG_INTERVAL_MS 15000    // Serial system-state dump period (ms)
 #define DISPLAY_UPDATE_INTERVAL 1000    // Update display every 1 second (ms)
-#define TOUCH_DEBOUNCE_MS 200          // Touch debounce delay (ms)
 #define RELAY_MIN_CYCLE_TIME 10000     // Minimum relay on/off cycle time (10s in ms)
 
+// ========================================
+// Heat-Up ETA Estimator
+// ========================================
+#define ESTIMATOR_INTERVAL_MS 15000    // RLS model update period
+#define ESTIMATOR_FORGETTING 0.998f    // Per update (memory ~2h at 15s)
+#define ESTIMATOR_WARMUP_UPDATES 20    // Updates before an ETA is shown (5 min)
+#define ETA_AT_TEMP_BAND_F 2.0f        // Within this of setpoint counts as "at temp"
+#define ESTIMATOR_SAVE_INTERVAL_MS (30UL * 60UL * 1000UL)  // Persist the learned model
+
+// ========================================
+// Scheduled Preheat ("ready at HH:MM")
+// ========================================
+#define PREHEAT_MARGIN_FRACTION 0.15f  // Start 15% earlier than the predicted heat-up...
+#define PREHEAT_MARGIN_S 300           // ...plus 5 minutes
+#define PREHEAT_FALLBACK_RATE_F_PER_MIN 1.0f  // Assumed heat-up rate until a model is learned
+#define PREHEAT_EDIT_STEP_MIN 15       // Touch edit step for the ready time
+#define PREHEAT_EDIT_TIMEOUT_MS 10000  // Leave touch edit mode after 10s without a touch
+#define CLOCK_VALID_EPOCH 1700000000UL // Wall clock counts as set after this (Nov 2023)
+
+// ========================================
+// Temperature History / Trend Chart
+// ========================================
+#define HISTORY_INTERVAL_MS 15000      // One history sample every 15s
+#define HISTORY_CAPACITY 5760          // 24h at 15s (int16 each, 11.5 KB)
+#define CHART_X 170                    // Trend chart between the buttons
+#define CHART_Y 200
+#define CHART_WIDTH 140
+#define CHART_HEIGHT 92
+#define CHART_SAMPLES_PER_COLUMN 4     // 1 minute per pixel column (~2.3h on screen)
+#define CHART_MIN_F 50.0f              // Fixed vertical scale
+#define CHART_MAX_F 300.0f
+#define CHART_GRID_F 50.0f             // Dotted grid line spacing
+#define HISTORY_EXPORT_PACING_MS 4     // Gap between BLE history chunks
+#define HISTORY_EXPORT_MAX_PAYLOAD 244 // Largest chunk notified (bytes)
+
+// ========================================
+// Task Configuration (FreeRTOS)
+// ========================================
+// Control must preempt UI on core 1; BLE runs on core 0 with the BT stack.
+#define CONTROL_TASK_PRIORITY 3
+#define CONTROL_TASK_CORE 1
+#define CONTROL_TASK_STACK 4096
+#define UI_TASK_PRIORITY 1
+#define UI_TASK_CORE 1
+#define UI_TASK_STACK 8192
+#define UI_TASK_PERIOD_MS 10           // Touch poll / serial poll period
+#define BLE_TASK_PRIORITY 1
+#define BLE_TASK_CORE 0
+#define BLE_TASK_STACK 4096
+#define COMMAND_QUEUE_LENGTH 8         // Pending commands for the control task
+
 // ========================================
 // Touch Button Configuration
 // ========================================
@@ -80,6 +159,26 @@
 #define BUTTON_DOWN_X 320
 #define BUTTON_DOWN_Y BUTTON_Y_POS
 
+// ========================================
+// Touch Input (XPT2046 pen IRQ on TOUCH_IRQ, see platformio.ini)
+// ========================================
+#define TOUCH_PRESSURE_THRESHOLD 300   // getTouch() z threshold
+#define TOUCH_SAMPLE_MS 20             // Sample period while the panel is pressed
+#define TOUCH_RELEASE_SAMPLES 2        // Missed samples before a release counts
+#define TOUCH_HOLD_DELAY_MS 500        // Hold a button this long to start repeating
+#define TOUCH_REPEAT_MS 150            // Repeat period while held
+#define TOUCH_SWIPE_MIN_PX 60          // Minimum vertical travel for a swipe
+#define TOUCH_SWIPE_MAX_MS 600         // Slower strokes are ignored
+#define TOUCH_SLOP_PX 15               // Movement that cancels hold-to-repeat
+#define TOUCH_SWIPE_STEP_F 10.0f       // Setpoint change per swipe (outside the buttons)
+#define TOUCH_LATENCY_TIMEOUT_MS 2000  // Give up on a latency sample after this
+
+// Preheat schedule field (tap to edit, tap again to arm)
+#define SCHEDULE_TOUCH_X 0
+#define SCHEDULE_TOUCH_Y 200
+#define SCHEDULE_TOUCH_W 165
+#define SCHEDULE_TOUCH_H 38
+
 // Touch calibration (adjust these if touch is not accurate)
 #define TOUCH_MIN_X 200
 #define TOUCH_MAX_X 3700
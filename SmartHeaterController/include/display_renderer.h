@@ -0,0 +1,145 @@
+#ifndef DISPLAY_RENDERER_H
+#define DISPLAY_RENDERER_H
+
+#include <Arduino.h>
+#include <TFT_eSPI.h>
+
+// ========================================
+// Render Statistics
+// ========================================
+struct RenderStats {
+    uint32_t frames;            // updateDisplay() calls since reset
+    uint32_t idleFrames;        // Frames that pushed nothing
+    uint32_t lastFrameBytes;    // Bytes pushed to the panel in the last frame
+    uint32_t lastFrameMicros;   // Time spent in the last frame
+    uint32_t maxFrameBytes;
+    uint32_t maxFrameMicros;
+    uint64_t totalBytes;
+};
+
+// ========================================
+// Retained-Mode Text Field
+// ========================================
+// A fixed-width line of GLCD text rendered into its own sprite. The text is
+// always padded to the same number of character cells, so every character has
+// a fixed position. draw() compares the new string against what is on screen
+// and pushes only the runs of cells that changed; an unchanged value costs no
+// SPI traffic at all.
+//
+// If the sprite cannot be allocated the field falls back to drawing straight
+// to the panel (the old full-band redraw), so the display keeps working.
+class SpriteTextField {
+public:
+    static constexpr uint8_t MAX_COLS = 24;
+
+private:
+    static constexpr uint8_t GLCD_CHAR_W = 6;   // 5px glyph + 1px spacing
+    static constexpr uint8_t GLCD_CHAR_H = 8;
+
+    TFT_eSPI* tft;
+    TFT_eSprite sprite;
+    int16_t centerX;
+    int16_t centerY;
+    uint8_t cols;
+    uint8_t textSize;
+    int16_t cellW;
+    int16_t cellH;
+    int16_t originX;
+    int16_t originY;
+
+    char shown[MAX_COLS + 1];
+    uint16_t shownFg = 0;
+    uint16_t shownBg = 0;
+    bool valid = false;
+    bool spriteReady = false;
+
+    // Center text inside exactly `cols` cells
+    void pad(const char* text, char* out) const {
+        size_t len = strlen(text);
+        if (len > cols) len = cols;
+        size_t left = (cols - len) / 2;
+
+        memset(out, ' ', cols);
+        memcpy(out + left, text, len);
+        out[cols] = '\0';
+    }
+
+public:
+    SpriteTextField(TFT_eSPI* display, int16_t cx, int16_t cy, uint8_t columns, uint8_t size)
+        : tft(display), sprite(display), centerX(cx), centerY(cy),
+          cols(columns > MAX_COLS ? MAX_COLS : columns), textSize(size) {
+        cellW = GLCD_CHAR_W * textSize;
+        cellH = GLCD_CHAR_H * textSize;
+        originX = centerX - (cols * cellW) / 2;
+        originY = centerY - cellH / 2;
+        shown[0] = '\0';
+    }
+
+    // Allocate the sprite (call after tft.init())
+    bool begin() {
+        spriteReady = sprite.createSprite(cols * cellW, cellH) != nullptr;
+        if (spriteReady) {
+            sprite.setTextSize(textSize);
+            sprite.setTextDatum(TL_DATUM);
+        }
+        return spriteReady;
+    }
+
+    // Force a full push on the next draw (e.g. after the screen was cleared)
+    void invalidate() { valid = false; }
+
+    // Update the field; returns the number of bytes pushed to the panel
+    uint32_t draw(const char* text, uint16_t fg, uint16_t bg) {
+        char next[MAX_COLS + 1];
+        pad(text, next);
+
+        bool full = !valid || fg != shownFg || bg != shownBg;
+        if (!full && memcmp(next, shown, cols) == 0) {
+            return 0;
+        }
+
+        if (!spriteReady) {
+            tft->fillRect(originX, originY, cols * cellW, cellH, bg);
+            tft->setTextColor(fg, bg);
+            tft->setTextSize(textSize);
+            tft->setTextDatum(TL_DATUM);
+            tft->drawString(next, originX, originY);
+            memcpy(shown, next, cols + 1);
+            shownFg = fg;
+            shownBg = bg;
+            valid = true;
+            return (uint32_t)cols * cellW * cellH * 2;
+        }
+
+        // Compose in RAM (no SPI traffic)
+        sprite.fillSprite(bg);
+        sprite.setTextColor(fg, bg);
+        sprite.drawString(next, 0, 0);
+
+        // Push each run of changed cells as one window
+        uint32_t bytes = 0;
+        uint8_t col = 0;
+        while (col < cols) {
+            if (!full && next[col] == shown[col]) {
+                col++;
+                continue;
+            }
+            uint8_t start = col;
+            while (col < cols && (full || next[col] != shown[col])) {
+                col++;
+            }
+            int16_t sx = start * cellW;
+            int16_t sw = (col - start) * cellW;
+            sprite.pushSprite(originX + sx, originY, sx, 0, sw, cellH);
+            bytes += (uint32_t)sw * cellH * 2;
+        }
+
+        memcpy(shown, next, cols + 1);
+        shownFg = fg;
+        shownBg = bg;
+        valid = true;
+        return bytes;
+    }
+};
+
+#endif // DISPLAY_RENDERER_H
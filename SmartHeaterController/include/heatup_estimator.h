@@ -0,0 +1,185 @@
+#ifndef HEATUP_ESTIMATOR_H
+#define HEATUP_ESTIMATOR_H
+
+#include <stdint.h>
+#include <math.h>
+
+// ========================================
+// Heat-Up Estimator (Recursive Least Squares)
+// ========================================
+// First-order thermal model of heater + oil sump:
+//
+//     dT/dt = a·u + b·T + c        (°F per minute, u = heater duty 0..1)
+//
+// a is the heating rate at full power, -1/b the thermal time constant and
+// -c/b the ambient temperature. The three parameters are learned online by
+// RLS with exponential forgetting, so the model follows changes in oil volume
+// or ambient over the course of a day. Each update is a fixed 3x3 step: O(1),
+// no allocation. Doubles are used for the covariance (the ESP32 emulates them
+// in software, which is irrelevant at one update every few seconds).
+//
+// During a full-power heat-up u is constant, so a and c cannot be told apart;
+// the ETA only needs a + c and b, which stay identifiable. The covariance is
+// capped so the unexcited direction does not wind up under forgetting.
+class HeatupEstimator {
+public:
+    enum Eta {
+        ETA_UNKNOWN = -1,       // Not enough data, or model not physical yet
+        ETA_UNREACHABLE = -2    // Full power levels off below the setpoint
+    };
+
+    // Learned state, for persisting across power cycles (plain data)
+    struct Model {
+        uint32_t version;
+        uint32_t updates;
+        double theta[3];
+        double P[3][3];
+    };
+
+    static constexpr uint32_t MODEL_VERSION = 1;
+
+private:
+    static constexpr double INITIAL_COVARIANCE = 1000.0;
+    static constexpr double MAX_COVARIANCE_TRACE = 1.0e5;
+    static constexpr double TEMP_SCALE = 100.0;     // Regressor T is in 100s of °F
+
+    double theta[3];            // a, b·TEMP_SCALE, c
+    double P[3][3];
+    double forgetting;
+    uint32_t updates = 0;
+    uint32_t minUpdates;
+
+public:
+    HeatupEstimator(float lambda = 0.998f, uint32_t warmupUpdates = 8)
+        : forgetting(lambda), minUpdates(warmupUpdates) {
+        reset();
+    }
+
+    void reset() {
+        for (uint8_t i = 0; i < 3; i++) {
+            theta[i] = 0.0;
+            for (uint8_t j = 0; j < 3; j++) {
+                P[i][j] = (i == j) ? INITIAL_COVARIANCE : 0.0;
+            }
+        }
+        updates = 0;
+    }
+
+    // One observation: temperature went from startF to endF over dtSeconds
+    // with the heater at average duty u over that interval.
+    void update(float startF, float endF, float duty, float dtSeconds) {
+        if (dtSeconds <= 0.0f) {
+            return;
+        }
+
+        const double x[3] = { duty, startF / TEMP_SCALE, 1.0 };
+        const double y = (endF - startF) * 60.0 / dtSeconds;   // °F per minute
+
+        double px[3];
+        double denom = forgetting;
+        for (uint8_t i = 0; i < 3; i++) {
+            px[i] = P[i][0] * x[0] + P[i][1] * x[1] + P[i][2] * x[2];
+            denom += x[i] * px[i];
+        }
+
+        double error = y - (theta[0] * x[0] + theta[1] * x[1] + theta[2] * x[2]);
+        double trace = 0.0;
+        for (uint8_t i = 0; i < 3; i++) {
+            double k = px[i] / denom;
+            theta[i] += k * error;
+            for (uint8_t j = 0; j < 3; j++) {
+                P[i][j] = (P[i][j] - k * px[j]) / forgetting;
+            }
+            trace += P[i][i];
+        }
+
+        // Keep P symmetric and bounded
+        double scale = (trace > MAX_COVARIANCE_TRACE) ? MAX_COVARIANCE_TRACE / trace : 1.0;
+        for (uint8_t i = 0; i < 3; i++) {
+            for (uint8_t j = i; j < 3; j++) {
+                double v = 0.5 * (P[i][j] + P[j][i]) * scale;
+                P[i][j] = v;
+                P[j][i] = v;
+            }
+        }
+
+        updates++;
+    }
+
+    void exportModel(Model& out) const {
+        out.version = MODEL_VERSION;
+        out.updates = updates;
+        for (uint8_t i = 0; i < 3; i++) {
+            out.theta[i] = theta[i];
+            for (uint8_t j = 0; j < 3; j++) {
+                out.P[i][j] = P[i][j];
+            }
+        }
+    }
+
+    // Returns false (and leaves the estimator untouched) for a foreign or
+    // corrupt model
+    bool importModel(const Model& in) {
+        if (in.version != MODEL_VERSION) {
+            return false;
+        }
+        for (uint8_t i = 0; i < 3; i++) {
+            if (!isfinite(in.theta[i])) return false;
+            for (uint8_t j = 0; j < 3; j++) {
+                if (!isfinite(in.P[i][j])) return false;
+            }
+        }
+        updates = in.updates;
+        for (uint8_t i = 0; i < 3; i++) {
+            theta[i] = in.theta[i];
+            for (uint8_t j = 0; j < 3; j++) {
+                P[i][j] = in.P[i][j];
+            }
+        }
+        return true;
+    }
+
+    uint32_t getUpdates() const { return updates; }
+
+    // Model is usable: warmed up, heats with power, and cools toward ambient
+    bool isValid() const {
+        return updates >= minUpdates && theta[0] > 0.0 && theta[1] < 0.0;
+    }
+
+    float heatingRate() const { return (float)theta[0]; }                 // °F/min at full power
+    float coolingCoefficient() const { return (float)(theta[1] / TEMP_SCALE); }  // 1/min (negative)
+    float timeConstantMinutes() const {
+        return theta[1] < 0.0 ? (float)(-TEMP_SCALE / theta[1]) : INFINITY;
+    }
+    float ambientF() const {
+        return theta[1] < 0.0 ? (float)(-theta[2] * TEMP_SCALE / theta[1]) : NAN;
+    }
+
+    // Temperature the sump would settle at with the heater at `duty`
+    float steadyStateF(float duty) const {
+        if (theta[1] >= 0.0) return INFINITY;
+        return (float)(-(theta[0] * duty + theta[2]) * TEMP_SCALE / theta[1]);
+    }
+
+    // Seconds to go from currentF to setpointF at full power. Returns 0 when
+    // already there, or one of the Eta codes.
+    float etaSeconds(float currentF, float setpointF) const {
+        if (currentF >= setpointF) {
+            return 0.0f;
+        }
+        if (!isValid()) {
+            return ETA_UNKNOWN;
+        }
+
+        float finalF = steadyStateF(1.0f);
+        if (finalF <= setpointF) {
+            return ETA_UNREACHABLE;
+        }
+
+        // T(t) = T∞ - (T∞ - T0)·e^(-t/τ)  =>  t = τ·ln((T∞ - T0) / (T∞ - Tsp))
+        float minutes = timeConstantMinutes() * logf((finalF - currentF) / (finalF - setpointF));
+        return minutes * 60.0f;
+    }
+};
+
+#endif // HEATUP_ESTIMATOR_H
@@ -0,0 +1,71 @@
+#ifndef JITTER_HISTOGRAM_H
+#define JITTER_HISTOGRAM_H
+
+#include <stdint.h>
+
+// ========================================
+// Wake-Up Lateness Histogram
+// ========================================
+// Counts how late a periodic task woke up relative to its ideal schedule.
+// Bucket limits are fixed and roughly logarithmic, so one histogram covers
+// both scheduler tick noise (< 1ms) and a task that is being starved (tens of
+// ms). Plain counters only, so it can be copied through a SeqLock.
+class JitterHistogram {
+public:
+    static constexpr uint8_t BUCKETS = 10;
+
+    // Upper bound of bucket i in µs (the last bucket is open-ended)
+    static uint32_t bucketLimitUs(uint8_t i) {
+        static const uint32_t limits[BUCKETS] = {
+            100, 250, 500, 1000, 2000, 5000, 10000, 20000, 50000, 0xFFFFFFFFUL
+        };
+        return limits[i < BUCKETS ? i : BUCKETS - 1];
+    }
+
+private:
+    uint32_t counts[BUCKETS];
+    uint32_t samples;
+    uint32_t maxLatenessUs;
+    uint64_t totalLatenessUs;
+    uint32_t maxRunUs;
+
+public:
+    JitterHistogram() { reset(); }
+
+    void reset() {
+        for (uint8_t i = 0; i < BUCKETS; i++) {
+            counts[i] = 0;
+        }
+        samples = 0;
+        maxLatenessUs = 0;
+        totalLatenessUs = 0;
+        maxRunUs = 0;
+    }
+
+    // latenessUs: actual wake time minus scheduled wake time
+    void record(uint32_t latenessUs) {
+        uint8_t i = 0;
+        while (i < BUCKETS - 1 && latenessUs >= bucketLimitUs(i)) {
+            i++;
+        }
+        counts[i]++;
+        samples++;
+        totalLatenessUs += latenessUs;
+        if (latenessUs > maxLatenessUs) maxLatenessUs = latenessUs;
+    }
+
+    // Time the task spent working in one iteration
+    void recordRunTime(uint32_t runUs) {
+        if (runUs > maxRunUs) maxRunUs = runUs;
+    }
+
+    uint32_t count(uint8_t i) const { return counts[i]; }
+    uint32_t getSamples() const { return samples; }
+    uint32_t getMaxUs() const { return maxLatenessUs; }
+    uint32_t getMaxRunUs() const { return maxRunUs; }
+    uint32_t getMeanUs() const {
+        return samples ? (uint32_t)(totalLatenessUs / samples) : 0;
+    }
+};
+
+#endif // JITTER_HISTOGRAM_H
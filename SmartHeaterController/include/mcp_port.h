@@ -0,0 +1,143 @@
+#ifndef MCP_PORT_H
+#define MCP_PORT_H
+
+#include <Arduino.h>
+#include <Wire.h>
+
+// ========================================
+// MCP23017 Register Map (IOCON.BANK = 0)
+// ========================================
+#define MCP_REG_IODIRA  0x00
+#define MCP_REG_IOCON   0x0A
+#define MCP_REG_GPIOA   0x12
+#define MCP_REG_OLATA   0x14
+#define MCP_REG_OLATB   0x15
+
+#define MCP_IOCON_SEQOP 0x20   // 1 = byte mode (BANK = 0: pointer toggles A/B)
+
+// ========================================
+// MCP23017 Port A Engine
+// ========================================
+// Port-level access to GPIOA. The output latch is cached locally, so changing
+// an output is one register write instead of the library's read-modify-write
+// (two transactions).
+//
+// SEQOP is set (byte mode). With BANK = 0, which the Adafruit library relies
+// on, byte mode makes the address pointer toggle OLATA -> OLATB -> OLATA, so
+// a multi-byte write interleaves the cached OLATB value between the port A
+// states. A whole clock pulse is still a single I2C transaction and port B
+// keeps its outputs.
+//
+// Every bus access goes through this class so the transaction and error
+// counters are exact.
+class McpPortA {
+private:
+    static constexpr uint8_t MAX_SEQUENCE = 8;
+
+    TwoWire* wire = nullptr;
+    uint8_t address = 0;
+    uint8_t olat = 0;
+    uint8_t olatB = 0;
+    uint32_t transactions = 0;
+    uint32_t errors = 0;
+
+    bool endTransmission(bool stop = true) {
+        transactions++;
+        if (wire->endTransmission(stop) != 0) {
+            errors++;
+            return false;
+        }
+        return true;
+    }
+
+    bool writeRegister(uint8_t reg, uint8_t value) {
+        wire->beginTransmission(address);
+        wire->write(reg);
+        wire->write(value);
+        return endTransmission();
+    }
+
+public:
+    // Take over port A after the pins have been configured. initialLatch is
+    // the output state the pins were left in (the library does not expose it).
+    bool begin(uint8_t i2cAddress, uint8_t initialLatch, TwoWire& bus = Wire) {
+        wire = &bus;
+        address = i2cAddress;
+        olat = initialLatch;
+
+        // Byte mode, BANK = 0: the pointer toggles between OLATA and OLATB
+        if (!writeRegister(MCP_REG_IOCON, MCP_IOCON_SEQOP)) {
+            return false;
+        }
+        // Port B is not ours; remember its latch so sequences rewrite it as is
+        if (!readRegister(MCP_REG_OLATB, olatB)) {
+            return false;
+        }
+        return writeRegister(MCP_REG_OLATA, olat);
+    }
+
+    // Read a single register (one combined write/read transaction)
+    bool readRegister(uint8_t reg, uint8_t& value) {
+        wire->beginTransmission(address);
+        wire->write(reg);
+        if (!endTransmission(false)) {
+            return false;
+        }
+        if (wire->requestFrom(address, (uint8_t)1) != 1) {
+            errors++;
+            return false;
+        }
+        value = (uint8_t)wire->read();
+        return true;
+    }
+
+    // Write the whole output latch
+    bool write(uint8_t value) {
+        olat = value;
+        return writeRegister(MCP_REG_OLATA, olat);
+    }
+
+    // Latch up to MAX_SEQUENCE output states in one transaction. The pointer
+    // toggles to OLATB after each byte, so OLATB is rewritten in between.
+    bool writeSequence(const uint8_t* values, uint8_t count) {
+        if (count == 0 || count > MAX_SEQUENCE) {
+            return false;
+        }
+        wire->beginTransmission(address);
+        wire->write(MCP_REG_OLATA);
+        for (uint8_t i = 0; i < count; i++) {
+            if (i > 0) {
+                wire->write(olatB);
+            }
+            wire->write(values[i]);
+        }
+        olat = values[count - 1];
+        return endTransmission();
+    }
+
+    // Change one output pin using the cached latch (no read-back)
+    bool writePin(uint8_t pin, bool state) {
+        uint8_t mask = (uint8_t)(1 << pin);
+        return write(state ? (olat | mask) : (olat & ~mask));
+    }
+
+    // Read the pin levels of port A
+    uint8_t read() {
+        uint8_t value = 0;
+        readRegister(MCP_REG_GPIOA, value);
+        return value;
+    }
+
+    uint8_t latch() const { return olat; }
+
+    // Running count of I2C transactions issued through this port
+    uint32_t transactionCount() const { return transactions; }
+
+    // Transactions that were not acknowledged (endTransmission/requestFrom)
+    uint32_t errorCount() const { return errors; }
+
+    // Account for transactions issued outside this class (legacy library path)
+    void addExternalTransactions(uint32_t count) { transactions += count; }
+};
+
+#endif // MCP_PORT_H
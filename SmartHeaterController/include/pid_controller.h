@@ -0,0 +1,257 @@
+#ifndef PID_CONTROLLER_H
+#define PID_CONTROLLER_H
+
+#include <stdint.h>
+#include <math.h>
+
+// ========================================
+// PID Gains
+// ========================================
+// Output is a heater duty cycle (0.0 - 1.0), input is °F, time is seconds.
+struct PidGains {
+    float kp;   // duty per °F of error
+    float ki;   // duty per °F·s of accumulated error
+    float kd;   // duty per °F/s of temperature change
+};
+
+// ========================================
+// PID Controller
+// ========================================
+// Derivative is taken on the measurement (no kick on setpoint changes). The
+// integral term is clamped to the output range and frozen while the output is
+// saturated, so a long heat-up does not wind it up (anti-windup).
+class PidController {
+private:
+    PidGains gains = {0.0f, 0.0f, 0.0f};
+    float integralTerm = 0.0f;
+    float lastInput = 0.0f;
+    float derivativeTau = 0.0f;     // seconds, 0 = unfiltered
+    float filteredDerivative = 0.0f;
+    bool primed = false;
+    float output = 0.0f;
+
+    static float clampDuty(float value) {
+        if (value < 0.0f) return 0.0f;
+        if (value > 1.0f) return 1.0f;
+        return value;
+    }
+
+public:
+    void setGains(const PidGains& newGains) { gains = newGains; }
+    const PidGains& getGains() const { return gains; }
+
+    // First-order low-pass on the derivative, so sensor quantization at a
+    // fast control rate does not turn into duty cycle noise
+    void setDerivativeFilter(float tauSeconds) { derivativeTau = tauSeconds; }
+
+    void reset() {
+        integralTerm = 0.0f;
+        filteredDerivative = 0.0f;
+        primed = false;
+        output = 0.0f;
+    }
+
+    // Compute new duty cycle. dtSeconds is the time since the previous call.
+    float update(float setpoint, float input, float dtSeconds) {
+        float error = setpoint - input;
+
+        if (!primed || dtSeconds <= 0.0f) {
+            lastInput = input;
+            primed = true;
+            dtSeconds = 0.0f;
+        }
+
+        if (dtSeconds > 0.0f) {
+            float derivative = (input - lastInput) / dtSeconds;
+            filteredDerivative += (derivative - filteredDerivative) *
+                                  (dtSeconds / (derivativeTau + dtSeconds));
+        }
+        lastInput = input;
+
+        float proportional = gains.kp * error;
+
+        // Conditional integration: stop accumulating while P + I is already
+        // saturated in the direction the error is pushing it. The derivative
+        // is left out so braking during a heat-up ramp does not wind it up.
+        float candidate = integralTerm + gains.ki * error * dtSeconds;
+        bool saturatedHigh = (proportional + candidate > 1.0f && error > 0.0f);
+        bool saturatedLow = (proportional + candidate < 0.0f && error < 0.0f);
+        if (!saturatedHigh && !saturatedLow) {
+            integralTerm = clampDuty(candidate);
+        }
+
+        output = clampDuty(proportional + integralTerm - gains.kd * filteredDerivative);
+        return output;
+    }
+
+    float getOutput() const { return output; }
+    float getIntegral() const { return integralTerm; }
+};
+
+// ========================================
+// Time-Proportioned Relay Output
+// ========================================
+// Turns a duty cycle into on/off time inside a fixed window (slow PWM).
+// On and off periods shorter than the relay minimum cycle time are rounded to
+// fully off or fully on, and a state change is never requested while the
+// minimum cycle time since the last change has not elapsed.
+class TimeProportionalOutput {
+private:
+    uint32_t windowMs;
+    uint32_t minCycleMs;
+    uint32_t windowStart = 0;
+    float duty = 0.0f;
+
+public:
+    TimeProportionalOutput(uint32_t window, uint32_t minCycle)
+        : windowMs(window), minCycleMs(minCycle) {}
+
+    void setDuty(float newDuty) { duty = newDuty; }
+    float getDuty() const { return duty; }
+
+    void restart(uint32_t nowMs) { windowStart = nowMs; }
+
+    // On-time for the current window after minimum cycle rounding
+    uint32_t onTimeMs() const {
+        uint32_t onTime = (uint32_t)(duty * windowMs + 0.5f);
+        if (onTime < minCycleMs) return 0;
+        if (windowMs - onTime < minCycleMs) return windowMs;
+        return onTime;
+    }
+
+    // Desired relay state at nowMs, given the current state and last change
+    bool decide(uint32_t nowMs, bool relayOn, uint32_t lastChangeMs) {
+        while (nowMs - windowStart >= windowMs) {
+            windowStart += windowMs;
+        }
+
+        bool want = (nowMs - windowStart) < onTimeMs();
+
+        if (want != relayOn && (nowMs - lastChangeMs) < minCycleMs) {
+            return relayOn;
+        }
+        return want;
+    }
+};
+
+// ========================================
+// Relay-Feedback Autotuner
+// ========================================
+// Åström-Hägglund relay test: the heater is driven fully on below
+// (setpoint - hysteresis) and fully off above (setpoint + hysteresis). The
+// resulting oscillation gives the ultimate gain Ku and period Tu, which are
+// turned into conservative Tyreus-Luyben gains.
+class RelayAutotuner {
+public:
+    enum State {
+        IDLE,
+        RUNNING,
+        DONE,
+        FAILED
+    };
+
+private:
+    State state = IDLE;
+    float setpoint = 0.0f;
+    float hysteresis = 1.0f;
+    uint8_t cyclesWanted = 3;
+    uint32_t timeoutMs = 0;
+
+    bool heating = true;
+    uint32_t startMs = 0;
+    uint32_t lastCycleStartMs = 0;
+    bool haveCycleStart = false;
+    float cycleMax = 0.0f;
+    float cycleMin = 0.0f;
+    uint8_t cyclesDone = 0;
+    float periodSum = 0.0f;
+    float amplitudeSum = 0.0f;
+    PidGains result = {0.0f, 0.0f, 0.0f};
+
+    void finish() {
+        float tu = periodSum / cyclesDone;           // seconds
+        float a = amplitudeSum / cyclesDone;         // °F, peak amplitude
+        // Correct for the relay hysteresis band
+        float aEff = (a > hysteresis) ? sqrtf(a * a - hysteresis * hysteresis) : a;
+        if (tu <= 0.0f || aEff <= 0.0f) {
+            state = FAILED;
+            return;
+        }
+
+        // Relay swings duty 0..1, i.e. amplitude d = 0.5 about the midpoint
+        const float d = 0.5f;
+        float ku = 4.0f * d / (3.14159265f * aEff);
+
+        // Tyreus-Luyben: Kp = Ku/2.2, Ti = 2.2Tu, Td = Tu/6.3. Much less
+        // overshoot than Ziegler-Nichols on a slow, lagging oil sump.
+        result.kp = ku / 2.2f;
+        result.ki = result.kp / (2.2f * tu);
+        result.kd = result.kp * (tu / 6.3f);
+        state = DONE;
+    }
+
+public:
+    void start(float targetF, float hysteresisF, uint8_t cycles, uint32_t timeout, uint32_t nowMs) {
+        state = RUNNING;
+        setpoint = targetF;
+        hysteresis = hysteresisF;
+        cyclesWanted = cycles;
+        timeoutMs = timeout;
+        heating = true;
+        startMs = nowMs;
+        haveCycleStart = false;
+        cyclesDone = 0;
+        periodSum = 0.0f;
+        amplitudeSum = 0.0f;
+    }
+
+    void abort() {
+        if (state == RUNNING) state = FAILED;
+    }
+
+    // Feed a temperature sample; returns the desired relay state
+    bool update(float tempF, uint32_t nowMs) {
+        if (state != RUNNING) {
+            return false;
+        }
+        if (nowMs - startMs > timeoutMs) {
+            state = FAILED;
+            return false;
+        }
+
+        if (haveCycleStart) {
+            if (tempF > cycleMax) cycleMax = tempF;
+            if (tempF < cycleMin) cycleMin = tempF;
+        }
+
+        if (heating && tempF > setpoint + hysteresis) {
+            heating = false;
+        } else if (!heating && tempF < setpoint - hysteresis) {
+            heating = true;
+
+            // A full oscillation ends each time the heater turns back on.
+            // The first cycle starts from ambient and is not measured.
+            if (haveCycleStart) {
+                periodSum += (nowMs - lastCycleStartMs) / 1000.0f;
+                amplitudeSum += (cycleMax - cycleMin) / 2.0f;
+                cyclesDone++;
+                if (cyclesDone >= cyclesWanted) {
+                    finish();
+                    return false;
+                }
+            }
+            haveCycleStart = true;
+            lastCycleStartMs = nowMs;
+            cycleMax = tempF;
+            cycleMin = tempF;
+        }
+
+        return heating;
+    }
+
+    State getState() const { return state; }
+    uint8_t getCyclesDone() const { return cyclesDone; }
+    const PidGains& getResult() const { return result; }
+};
+
+#endif // PID_CONTROLLER_H
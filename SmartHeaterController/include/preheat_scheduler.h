@@ -0,0 +1,96 @@
+#ifndef PREHEAT_SCHEDULER_H
+#define PREHEAT_SCHEDULER_H
+
+#include <stdint.h>
+
+// ========================================
+// Preheat Scheduler
+// ========================================
+// "Ready at" schedule: holds the heater in standby and starts it at the
+// latest time that still reaches the setpoint by the ready time. The start
+// time is recomputed on every update from the current ETA, so oil that cools
+// while waiting simply moves the start earlier. Once heating has started it
+// stays started (a shrinking ETA must not switch the heater back off), and
+// at the ready time the schedule completes and normal control continues.
+//
+// Times are seconds on the device's wall clock (local time, set by the app);
+// 0 means the clock has not been set since boot.
+class PreheatScheduler {
+public:
+    enum State {
+        IDLE,               // No schedule
+        WAITING_FOR_CLOCK,  // Armed, but the clock is not set yet (heater held off)
+        STANDBY,            // Armed, waiting for the start time (heater held off)
+        HEATING             // Started; normal control until the ready time
+    };
+
+    enum Result {
+        NONE,
+        STARTED,            // Standby -> heating this update
+        COMPLETED,          // Ready time reached
+        MISSED              // Clock came up after the ready time had passed
+    };
+
+private:
+    State state = IDLE;
+    uint32_t ready = 0;
+    uint32_t start = 0;
+    float marginFraction;
+    uint32_t marginSeconds;
+
+public:
+    PreheatScheduler(float marginFrac, uint32_t marginS)
+        : marginFraction(marginFrac), marginSeconds(marginS) {}
+
+    void arm(uint32_t readyTime) {
+        ready = readyTime;
+        start = 0;
+        state = WAITING_FOR_CLOCK;
+    }
+
+    void cancel() {
+        state = IDLE;
+        ready = 0;
+        start = 0;
+    }
+
+    // etaSeconds: time to setpoint at full power from the current temperature
+    // (0 when already there). Pass a conservative fallback if no model yet.
+    Result update(uint32_t now, float etaSeconds) {
+        if (state == IDLE) {
+            return NONE;
+        }
+        if (now == 0) {
+            if (state != HEATING) state = WAITING_FOR_CLOCK;
+            return NONE;
+        }
+        if (now >= ready) {
+            bool missed = (state != HEATING);
+            cancel();
+            return missed ? MISSED : COMPLETED;
+        }
+        if (state == HEATING) {
+            return NONE;
+        }
+
+        float lead = etaSeconds * (1.0f + marginFraction) + marginSeconds;
+        start = (lead >= (float)ready) ? 0 : ready - (uint32_t)lead;
+
+        if (now >= start) {
+            state = HEATING;
+            return STARTED;
+        }
+        state = STANDBY;
+        return NONE;
+    }
+
+    // Heater must be held off
+    bool holding() const { return state == WAITING_FOR_CLOCK || state == STANDBY; }
+
+    State getState() const { return state; }
+    bool isArmed() const { return state != IDLE; }
+    uint32_t readyTime() const { return ready; }
+    uint32_t startTime() const { return start; }
+};
+
+#endif // PREHEAT_SCHEDULER_H
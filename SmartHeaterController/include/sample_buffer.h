@@ -0,0 +1,55 @@
+#ifndef SAMPLE_BUFFER_H
+#define SAMPLE_BUFFER_H
+
+#include <stdint.h>
+
+// ========================================
+// Median Ring Buffer
+// ========================================
+// Holds the last N raw samples. median() rejects single-sample spikes (a
+// noisy MAX6675 bit or a loose connector) without the lag of a long average.
+// N is small, so the sort is a copy plus insertion sort on the stack.
+template <uint8_t N>
+class MedianRing {
+private:
+    float samples[N];
+    uint8_t index = 0;
+    uint8_t count = 0;
+
+public:
+    void push(float value) {
+        samples[index] = value;
+        index = (index + 1) % N;
+        if (count < N) {
+            count++;
+        }
+    }
+
+    void clear() {
+        index = 0;
+        count = 0;
+    }
+
+    uint8_t size() const { return count; }
+
+    // Median of the samples held so far (call only when size() > 0)
+    float median() const {
+        float sorted[N];
+        for (uint8_t i = 0; i < count; i++) {
+            float value = samples[i];
+            int8_t j = (int8_t)i - 1;
+            while (j >= 0 && sorted[j] > value) {
+                sorted[j + 1] = sorted[j];
+                j--;
+            }
+            sorted[j + 1] = value;
+        }
+
+        if (count % 2 == 1) {
+            return sorted[count / 2];
+        }
+        return (sorted[count / 2 - 1] + sorted[count / 2]) / 2.0f;
+    }
+};
+
+#endif // SAMPLE_BUFFER_H
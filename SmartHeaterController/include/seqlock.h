@@ -0,0 +1,58 @@
+#ifndef SEQLOCK_H
+#define SEQLOCK_H
+
+#include <stdint.h>
+#include <string.h>
+#include <atomic>
+#include <type_traits>
+
+// ========================================
+// Single-Writer Sequence Lock
+// ========================================
+// Publishes a small struct from one task to any number of readers without a
+// mutex. The writer makes the sequence odd, copies the value in, then makes
+// it even again; a reader copies the value out and retries if the sequence
+// was odd or moved while it was copying. The writer never waits on a reader,
+// so a slow reader (a display redraw, a BLE notify) cannot delay the control
+// task that owns the value.
+//
+// Exactly one task may call write(). T must be trivially copyable.
+template <typename T>
+class SeqLock {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "SeqLock values are copied with memcpy");
+
+private:
+    std::atomic<uint32_t> sequence{0};
+    T value;
+
+public:
+    SeqLock() : value() {}
+
+    void write(const T& next) {
+        uint32_t seq = sequence.load(std::memory_order_relaxed);
+        sequence.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        memcpy(&value, &next, sizeof(T));
+        sequence.store(seq + 2, std::memory_order_release);
+    }
+
+    T read() const {
+        T copy;
+        uint32_t before, after;
+        do {
+            before = sequence.load(std::memory_order_acquire);
+            memcpy(&copy, &value, sizeof(T));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            after = sequence.load(std::memory_order_relaxed);
+        } while ((before & 1) || before != after);
+        return copy;
+    }
+
+    // Number of completed writes (changes whenever a new value is published)
+    uint32_t version() const {
+        return sequence.load(std::memory_order_acquire) >> 1;
+    }
+};
+
+#endif // SEQLOCK_H
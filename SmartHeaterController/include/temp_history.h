@@ -0,0 +1,73 @@
+#ifndef TEMP_HISTORY_H
+#define TEMP_HISTORY_H
+
+#include <stdint.h>
+
+// ========================================
+// Temperature History Ring
+// ========================================
+// One int16 per sample: temperature in tenths of a °F shifted left by one,
+// with the relay state in bit 0. 5760 samples (24 h at 15 s) fit in 11.5 KB.
+//
+// Samples are addressed by a running index that starts at 0 at boot and never
+// goes backwards, so a reader (the trend chart, a BLE download) can ask for
+// "everything after index N" and tell exactly what it missed if the ring has
+// since overwritten it.
+//
+// The caller handles any locking between the writer and readers.
+template <uint16_t N>
+class TempHistory {
+private:
+    int16_t samples[N];
+    uint32_t total = 0;     // Samples ever recorded (index of the next sample)
+
+public:
+    static const int16_t DECI_MAX = 16383;
+    static const int16_t DECI_MIN = -16384;
+
+    static int16_t encode(float tempF, bool relayOn) {
+        float deci = tempF * 10.0f;
+        int32_t rounded = (int32_t)(deci + (deci >= 0.0f ? 0.5f : -0.5f));
+        if (rounded > DECI_MAX) rounded = DECI_MAX;
+        if (rounded < DECI_MIN) rounded = DECI_MIN;
+        return (int16_t)((rounded * 2) | (relayOn ? 1 : 0));
+    }
+
+    static float decodeTemp(int16_t sample) { return (sample >> 1) / 10.0f; }
+    static bool decodeRelay(int16_t sample) { return (sample & 1) != 0; }
+
+    void push(float tempF, bool relayOn) {
+        samples[total % N] = encode(tempF, relayOn);
+        total++;
+    }
+
+    void clear() { total = 0; }
+
+    uint16_t capacity() const { return N; }
+    uint16_t size() const { return total < N ? (uint16_t)total : N; }
+
+    // Index of the next sample to be recorded
+    uint32_t endIndex() const { return total; }
+
+    // Oldest index still held
+    uint32_t beginIndex() const { return total - size(); }
+
+    // Raw sample by running index (must be in [beginIndex(), endIndex()))
+    int16_t at(uint32_t index) const { return samples[index % N]; }
+
+    // Copy up to maxCount samples starting at running index `from`, clamped
+    // to what is still held. Returns the count; `from` is moved to the first
+    // index actually copied.
+    uint16_t copy(uint32_t& from, int16_t* out, uint16_t maxCount) const {
+        if (from < beginIndex()) from = beginIndex();
+        if (from >= total) return 0;
+        uint32_t available = total - from;
+        uint16_t count = available < maxCount ? (uint16_t)available : maxCount;
+        for (uint16_t i = 0; i < count; i++) {
+            out[i] = samples[(from + i) % N];
+        }
+        return count;
+    }
+};
+
+#endif // TEMP_HISTORY_H
@@ -0,0 +1,141 @@
+#ifndef TOUCH_GESTURE_H
+#define TOUCH_GESTURE_H
+
+#include <stdint.h>
+#include <stdlib.h>
+
+// ========================================
+// Touch Events
+// ========================================
+enum TouchEventType {
+    TOUCH_NONE,
+    TOUCH_PRESS,        // Finger down (fires immediately, at the press point)
+    TOUCH_REPEAT,       // Finger held still past the hold delay, then every repeat period
+    TOUCH_SWIPE,        // Quick stroke, reported on release
+    TOUCH_RELEASE       // Finger up, not a swipe
+};
+
+enum SwipeDirection {
+    SWIPE_UP,
+    SWIPE_DOWN,
+    SWIPE_LEFT,
+    SWIPE_RIGHT
+};
+
+struct TouchEvent {
+    TouchEventType type;
+    int16_t x;                  // Where the touch started
+    int16_t y;
+    int16_t dx;                 // Displacement from the start (SWIPE / RELEASE)
+    int16_t dy;
+    SwipeDirection direction;   // SWIPE only
+    uint16_t repeatCount;       // REPEAT only: 1 for the first repeat
+};
+
+// ========================================
+// Touch Gesture Detector
+// ========================================
+// Turns a stream of touch samples into press / hold-to-repeat / swipe
+// events. A touch that moves more than the slop distance stops repeating, so
+// a swipe that starts on a button does not also auto-repeat it. A short run
+// of missing samples is tolerated before release, because resistive panels
+// drop single readings near the pressure threshold.
+class TouchGestureDetector {
+public:
+    struct Config {
+        uint16_t holdDelayMs;       // Press-to-first-repeat
+        uint16_t repeatMs;          // Repeat period while held
+        uint16_t swipeMinPx;        // Minimum travel along the main axis
+        uint16_t swipeMaxMs;        // Longer strokes are drags, not swipes
+        uint16_t slopPx;            // Movement that cancels hold-to-repeat
+        uint8_t releaseSamples;     // Consecutive "not pressed" samples for release
+    };
+
+private:
+    Config config;
+    bool down = false;
+    bool moved = false;
+    uint8_t missing = 0;
+    int16_t startX = 0;
+    int16_t startY = 0;
+    int16_t lastX = 0;
+    int16_t lastY = 0;
+    uint32_t startMs = 0;
+    uint32_t nextRepeatMs = 0;
+    uint16_t repeats = 0;
+
+    TouchEvent event(TouchEventType type) const {
+        TouchEvent e;
+        e.type = type;
+        e.x = startX;
+        e.y = startY;
+        e.dx = lastX - startX;
+        e.dy = lastY - startY;
+        e.direction = SWIPE_UP;
+        e.repeatCount = repeats;
+        return e;
+    }
+
+public:
+    explicit TouchGestureDetector(const Config& cfg) : config(cfg) {}
+
+    // True from press until release (including the release debounce)
+    bool isActive() const { return down; }
+
+    void reset() { down = false; }
+
+    // Feed one sample; returns at most one event
+    TouchEvent update(bool pressed, int16_t x, int16_t y, uint32_t nowMs) {
+        if (!down) {
+            if (!pressed) {
+                return event(TOUCH_NONE);
+            }
+            down = true;
+            moved = false;
+            missing = 0;
+            repeats = 0;
+            startX = lastX = x;
+            startY = lastY = y;
+            startMs = nowMs;
+            nextRepeatMs = nowMs + config.holdDelayMs;
+            return event(TOUCH_PRESS);
+        }
+
+        if (!pressed) {
+            if (++missing < config.releaseSamples) {
+                return event(TOUCH_NONE);
+            }
+            down = false;
+
+            TouchEvent e = event(TOUCH_RELEASE);
+            int16_t adx = abs(e.dx);
+            int16_t ady = abs(e.dy);
+            bool quick = (nowMs - startMs) <= config.swipeMaxMs;
+            if (quick && (adx >= config.swipeMinPx || ady >= config.swipeMinPx)) {
+                e.type = TOUCH_SWIPE;
+                if (ady >= adx) {
+                    e.direction = (e.dy < 0) ? SWIPE_UP : SWIPE_DOWN;
+                } else {
+                    e.direction = (e.dx < 0) ? SWIPE_LEFT : SWIPE_RIGHT;
+                }
+            }
+            return e;
+        }
+
+        missing = 0;
+        lastX = x;
+        lastY = y;
+        if (abs(lastX - startX) > config.slopPx || abs(lastY - startY) > config.slopPx) {
+            moved = true;
+        }
+
+        if (!moved && (int32_t)(nowMs - nextRepeatMs) >= 0) {
+            nextRepeatMs += config.repeatMs;
+            repeats++;
+            return event(TOUCH_REPEAT);
+        }
+        return event(TOUCH_NONE);
+    }
+};
+
+#endif // TOUCH_GESTURE_H
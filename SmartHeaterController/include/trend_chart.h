@@ -0,0 +1,109 @@
+#ifndef TREND_CHART_H
+#define TREND_CHART_H
+
+#include <Arduino.h>
+#include <TFT_eSPI.h>
+
+// ========================================
+// Scrolling Trend Chart
+// ========================================
+// A strip chart held in its own sprite. Each column covers a fixed number of
+// history samples and shows their min..max temperature as a vertical bar, the
+// setpoint as a dot and the relay state as a strip along the bottom. Starting
+// a new column scrolls the sprite one pixel left and draws only the new
+// column; nothing already plotted is redrawn.
+//
+// The vertical scale is fixed, so old columns never need rescaling. If the
+// sprite cannot be allocated the chart is simply not shown.
+class TrendChart {
+private:
+    static constexpr int16_t RELAY_STRIP_H = 3;
+    static constexpr uint16_t COLOR_GRID = 0x2104;   // Very dark grey
+    static constexpr uint16_t COLOR_LINE = TFT_CYAN;
+    static constexpr uint16_t COLOR_SET = TFT_YELLOW;
+    static constexpr uint16_t COLOR_RELAY = TFT_RED;
+
+    TFT_eSPI* tft;
+    TFT_eSprite sprite;
+    int16_t x;
+    int16_t y;
+    int16_t w;
+    int16_t h;
+    float minF;
+    float maxF;
+    float gridStepF;
+    bool ready = false;
+
+    // Plot area row for a temperature (0 = top), clamped to the plot area
+    int16_t rowFor(float tempF) const {
+        int16_t plotH = h - RELAY_STRIP_H - 1;
+        float frac = (tempF - minF) / (maxF - minF);
+        if (frac < 0.0f) frac = 0.0f;
+        if (frac > 1.0f) frac = 1.0f;
+        return (int16_t)((plotH - 1) * (1.0f - frac) + 0.5f);
+    }
+
+    void drawGrid(int16_t col) {
+        for (float g = minF + gridStepF; g < maxF; g += gridStepF) {
+            sprite.drawPixel(col, rowFor(g), COLOR_GRID);
+        }
+    }
+
+public:
+    TrendChart(TFT_eSPI* display, int16_t px, int16_t py, int16_t width, int16_t height,
+               float lowF, float highF, float gridF)
+        : tft(display), sprite(display), x(px), y(py), w(width), h(height),
+          minF(lowF), maxF(highF), gridStepF(gridF) {}
+
+    // Allocate the sprite (call after tft.init())
+    bool begin() {
+        ready = sprite.createSprite(w, h) != nullptr;
+        if (ready) {
+            clear();
+        }
+        return ready;
+    }
+
+    void clear() {
+        if (!ready) return;
+        sprite.fillSprite(TFT_BLACK);
+        for (int16_t col = 0; col < w; col++) {
+            drawGrid(col);
+        }
+    }
+
+    // Plot the newest column. newColumn scrolls the chart left first;
+    // otherwise the rightmost column is redrawn with the updated range.
+    void plot(float lowF, float highF, float setpointF, bool heated, bool newColumn) {
+        if (!ready) return;
+
+        if (newColumn) {
+            sprite.scroll(-1, 0);
+        }
+
+        int16_t col = w - 1;
+        sprite.drawFastVLine(col, 0, h, TFT_BLACK);
+        drawGrid(col);
+
+        sprite.drawPixel(col, rowFor(setpointF), COLOR_SET);
+
+        int16_t top = rowFor(highF);
+        int16_t bottom = rowFor(lowF);
+        sprite.drawFastVLine(col, top, bottom - top + 1, COLOR_LINE);
+
+        if (heated) {
+            sprite.drawFastVLine(col, h - RELAY_STRIP_H, RELAY_STRIP_H, COLOR_RELAY);
+        }
+    }
+
+    // Push the whole chart to the panel; returns bytes pushed
+    uint32_t push() {
+        if (!ready) return 0;
+        sprite.pushSprite(x, y);
+        return (uint32_t)w * h * 2;
+    }
+
+    int16_t columns() const { return w; }
+};
+
+#endif // TREND_CHART_H
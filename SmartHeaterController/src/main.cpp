@@ -7,29 +7,64 @@
 #include <BLEServer.h>
 #include <BLEUtils.h>
 #include <BLE2902.h>
+#include <Preferences.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/queue.h>
+#include <atomic>
 #include <cmath>  // For fabsf()
 #include "config.h"
+#include "mcp_port.h"
+#include "pid_controller.h"
+#include "display_renderer.h"
+#include "sample_buffer.h"
+#include "seqlock.h"
+#include "jitter_histogram.h"
+#include "temp_history.h"
+#include "trend_chart.h"
+#include "ble_protocol.h"
+#include "heatup_estimator.h"
+#include "touch_gesture.h"
+#include "preheat_scheduler.h"
+#include <time.h>
+#include <sys/time.h>
 
 // ========================================
 // Global Objects
 // ========================================
 TFT_eSPI tft = TFT_eSPI();
+
+// Retained-mode display fields (each pushes only the glyph cells that change)
+SpriteTextField tempField(&tft, 240, 100, 10, 3);
+SpriteTextField setpointField(&tft, 240, 145, 16, 2);
+SpriteTextField statusField(&tft, 240, 180, 16, 2);
+SpriteTextField bleField(&tft, 240, 305, 17, 1);
+SpriteTextField etaField(&tft, 80, 222, 12, 2);
+TrendChart trendChart(&tft, CHART_X, CHART_Y, CHART_WIDTH, CHART_HEIGHT,
+                      CHART_MIN_F, CHART_MAX_F, CHART_GRID_F);
+RenderStats renderStats = {};
 Adafruit_MCP23X17 mcp;
+McpPortA mcpPort;  // Port-level GPIOA access (relay + MAX6675 bit-bang)
+Preferences preferences;
+
+// Temperature control
+PidController pid;
+TimeProportionalOutput relayWindow(PID_WINDOW_MS, RELAY_MIN_CYCLE_TIME);
+RelayAutotuner autotuner;
+HeatupEstimator estimator(ESTIMATOR_FORGETTING, ESTIMATOR_WARMUP_UPDATES);
+PreheatScheduler preheat(PREHEAT_MARGIN_FRACTION, PREHEAT_MARGIN_S);
 
 // BLE objects
 BLEServer* pServer = nullptr;
 BLECharacteristic* pTempCharacteristic = nullptr;
 BLECharacteristic* pSetpointCharacteristic = nullptr;
 BLECharacteristic* pStatusCharacteristic = nullptr;
-volatile bool deviceConnected = false;
+BLECharacteristic* pHistoryCharacteristic = nullptr;
+BLECharacteristic* pTelemetryCharacteristic = nullptr;
+BLECharacteristic* pPreheatCharacteristic = nullptr;
+std::atomic<bool> deviceConnected(false);
 
-// BLE UUIDs
-// Service UUID - MUST match SERVICE_UUIDS.OIL_HEATER in @crewchiefsteve/ble package
-// See packages/ble/src/constants/uuids.ts for all device UUIDs
-#define SERVICE_UUID        "4fafc201-0001-459e-8fcc-c5c9c331914b"
-#define TEMP_CHAR_UUID      "beb5483e-36e1-4688-b7f5-ea07361b26a8"
-#define SETPOINT_CHAR_UUID  "beb5483e-36e1-4688-b7f5-ea07361b26a9"
-#define STATUS_CHAR_UUID    "beb5483e-36e1-4688-b7f5-ea07361b26aa"
+// BLE UUIDs are in ble_protocol.h
 
 // BLE Server Callbacks (static instance)
 class MyServerCallbacks: public BLEServerCallbacks {
@@ -54,64 +89,224 @@ static MyServerCallbacks serverCallbacks;
 uint16_t calData[5] = {326, 3433, 551, 3091, 7};
 
 // ========================================
-// State Variables (volatile for thread safety with BLE callbacks)
+// Task Model
 // ========================================
-volatile float currentTemp = 0.0f;
-volatile float setpointTemp = DEFAULT_SETPOINT_F;
-volatile bool heaterOn = false;
-volatile bool sensorError = false;
-volatile bool safetyShutdown = false;
+// controlTask (core 1, highest priority) owns the MAX6675, the relay, the PID
+// and every variable below marked "control-owned". Other tasks never touch
+// them: they read the published HeaterState snapshot and ask for changes by
+// posting a HeaterCommand to the command queue.
+//
+// uiTask (core 1) handles touch, the TFT and serial commands.
+// bleTask (core 0, next to the Bluetooth stack) sends notifications.
+
+// Published once per control iteration (see publishState())
+struct HeaterState {
+    float currentTemp;
+    float rawTemp;
+    float setpointTemp;
+    float duty;
+    float etaSeconds;           // Time to setpoint at full power (HeatupEstimator::Eta codes if < 0)
+    uint32_t lastRelayChange;
+    uint32_t preheatReady;      // Wall-clock seconds, 0 = no schedule
+    uint32_t preheatStart;      // Latest start time, 0 until computed
+    uint16_t rawWord;
+    uint8_t preheatState;       // PreheatScheduler::State
+    bool heaterOn;
+    bool sensorError;
+    bool safetyShutdown;
+    bool autotuning;
+};
+
+enum HeaterCommandType {
+    CMD_SET_SETPOINT,       // value = new setpoint °F (BLE write)
+    CMD_ADJUST_SETPOINT,    // value = step °F (touch buttons)
+    CMD_TOGGLE_AUTOTUNE,
+    CMD_TOGGLE_LEGACY_BITBANG,
+    CMD_PRINT_I2C_STATS,
+    CMD_PRINT_PID,
+    CMD_RESET_JITTER,
+    CMD_PRINT_ESTIMATOR,
+    CMD_PREHEAT_ARM,        // value = ready time, minutes after local midnight
+    CMD_PREHEAT_CANCEL
+};
+
+struct HeaterCommand {
+    HeaterCommandType type;
+    float value;
+};
+
+static SeqLock<HeaterState> heaterState;
+static SeqLock<JitterHistogram> controlJitter;
+static QueueHandle_t commandQueue = nullptr;
+static TaskHandle_t controlTaskHandle = nullptr;
+static TaskHandle_t uiTaskHandle = nullptr;
+static TaskHandle_t bleTaskHandle = nullptr;
 
-// Temperature smoothing (moving average)
+// ========================================
+// State Variables (control-owned)
+// ========================================
+static float currentTemp = 0.0f;
+static float setpointTemp = DEFAULT_SETPOINT_F;
+static bool heaterOn = false;
+static bool sensorError = false;
+static bool safetyShutdown = false;
+static JitterHistogram jitter;
+
+// Heat-up estimator inputs (control-owned)
+static unsigned long lastEstimatorTime = 0;
+static float estimatorStartTemp = 0.0f;
+static bool estimatorStartValid = false;
+static uint32_t estimatorRelayOnMs = 0;
+static unsigned long lastModelSave = 0;
+
+// ========================================
+// Temperature History
+// ========================================
+// Written by the control task, read by the trend chart (UI task) and the BLE
+// history export (BLE task). Copies are short, so a spinlock is enough.
+static TempHistory<HISTORY_CAPACITY> history;
+static portMUX_TYPE historyLock = portMUX_INITIALIZER_UNLOCKED;
+static unsigned long lastHistoryTime = 0;      // control-owned
+static bool historyRelaySeen = false;          // control-owned: relay on during interval
+
+// Trend chart progress (UI-owned)
+static uint32_t chartNextIndex = 0;
+static float chartColumnLow = 0.0f;
+static float chartColumnHigh = 0.0f;
+static bool chartColumnHeated = false;
+
+// History export (BLE-owned, requested from the BLE callback)
+static std::atomic<bool> historyExportPending(false);
+static std::atomic<uint32_t> historyExportFrom(0);
+static bool historyExportActive = false;
+static uint32_t historyExportCursor = 0;
+static uint32_t historyExportChunks = 0;
+
+// Temperature filtering: median-of-N on raw samples, then moving average
 #define TEMP_HISTORY_SIZE 8
+static MedianRing<MEDIAN_WINDOW> rawSamples;
 static float tempHistory[TEMP_HISTORY_SIZE];
 static uint8_t tempHistoryIndex = 0;
 static uint8_t tempHistoryCount = 0;
+static float lastRawTempF = 0.0f;
+static uint16_t lastRawWord = 0;
 
-// Timing variables (only used in main loop, no need for volatile)
-unsigned long lastTempRead = 0;
-unsigned long lastDisplayUpdate = 0;
-unsigned long lastTouchTime = 0;
+// Timing variables (control-owned)
+unsigned long lastControlTime = 0;
 unsigned long lastRelayChange = 0;
+unsigned long lastPidUpdate = 0;
+
+// Timing variables (UI-owned)
+unsigned long lastStatusLog = 0;
+unsigned long lastDisplayUpdate = 0;
 
 // Button feedback state (non-blocking)
 unsigned long buttonFeedbackStart = 0;
 int activeButton = 0;  // 0=none, 1=UP, 2=DOWN
 bool buttonFeedbackActive = false;
 
-// Touch state for press-only detection (ignore hold)
-static bool wasTouched = false;
-
-// BLE notification tracking (to avoid unnecessary notifications)
+// ========================================
+// Touch Input (UI-owned unless noted)
+// ========================================
+// The XPT2046 pulls TOUCH_IRQ low while the panel is pressed. The ISR only
+// wakes the UI task; the panel is read over SPI only from the pen-down
+// interrupt until release, so an idle panel costs no SPI traffic. The chip
+// also pulls the line low while it converts, so the ISR ignores edges
+// during a read and a burst only starts while the line is still low.
+static TouchGestureDetector touchGestures({
+    TOUCH_HOLD_DELAY_MS, TOUCH_REPEAT_MS, TOUCH_SWIPE_MIN_PX,
+    TOUCH_SWIPE_MAX_MS, TOUCH_SLOP_PX, TOUCH_RELEASE_SAMPLES
+});
+static std::atomic<bool> touchIrqFlag(false);      // Set by the ISR
+static std::atomic<bool> touchReading(false);      // SPI read in progress: ISR ignores edges
+static volatile uint32_t touchIrqUs = 0;           // Set by the ISR
+static bool touchSampling = false;
+static unsigned long lastTouchSample = 0;
+
+// Touch-to-redraw latency: pen-down (or repeat) to the new setpoint on screen
+struct TouchStats {
+    uint32_t irqs;
+    uint32_t spiReads;
+    uint32_t latencySamples;
+    uint32_t lastLatencyUs;
+    uint32_t minLatencyUs;
+    uint32_t maxLatencyUs;
+    uint64_t totalLatencyUs;
+};
+static TouchStats touchStats = {};
+static bool latencyPending = false;
+static uint32_t latencyStartUs = 0;
+static float latencyFromSetpoint = 0.0f;
+
+// Preheat schedule touch editing (UI-owned)
+static bool scheduleEditing = false;
+static int16_t scheduleEditMinutes = 0;
+static unsigned long lastScheduleTouch = 0;
+static unsigned long scheduleMessageUntil = 0;     // "NO CLOCK" hint
+
+// BLE notification tracking (BLE task only)
 float lastNotifiedTemp = -999.0f;
 float lastNotifiedSetpoint = -999.0f;
 bool lastNotifiedHeaterOn = false;
 bool lastNotifiedSafetyShutdown = false;
 bool lastNotifiedSensorError = false;
+long lastNotifiedEtaMinutes = -100;
+TelemetryFrame lastTelemetry = {};
+bool telemetrySent = false;
+PreheatStatusFrame lastPreheatStatus = {};
 
-// BLE connection display tracking
-bool lastDisplayedBleState = false;
-
-// Flag to force display update from main loop
-volatile bool forceDisplayUpdate = false;
+// Set by the control task after applying a command, or by touch
+std::atomic<bool> forceDisplayUpdate(false);
 
 // Global display buffer to avoid stack allocation
 static char displayBuffer[32];
 
+// MAX6675 read cost (I2C transactions and time per 16-bit sample, control-owned)
+struct SampleCost {
+    uint32_t lastTransactions;
+    uint32_t lastMicros;
+    uint32_t samples;
+    uint64_t totalTransactions;
+    uint64_t totalMicros;
+};
+static SampleCost max6675Cost = {};
+static bool useLegacyBitBang = false;   // 'l' over serial toggles for before/after comparison
+static uint32_t i2cClockHz = I2C_FREQUENCY;
+
+// Adafruit library cost per call: digitalWrite is a read-modify-write of GPIO
+// (2 transactions), digitalRead is a single register read (1 transaction)
+static constexpr uint32_t LEGACY_WRITE_TX = 2;
+static constexpr uint32_t LEGACY_READ_TX = 1;
+static constexpr uint32_t LEGACY_SAMPLE_TX =
+    2 * LEGACY_WRITE_TX + 16 * (2 * LEGACY_WRITE_TX + LEGACY_READ_TX);
+
 // ========================================
 // Function Prototypes
 // ========================================
 void initI2C();
 void initMCP23017();
+void tryFastI2C();
 void initDisplay();
 void initBluetooth();
 void updateBluetooth();
 void calibrateTouch();
 float readMAX6675();
 float computeSmoothedTemp(float newReading);
+void resetTempFilter();
+void sampleTemperature();
+void runControl();
+void logSystemState();
 uint16_t readMAX6675Raw();
+uint16_t readMAX6675RawPort();
+uint16_t readMAX6675RawLegacy();
 void bitBangSPI(uint8_t& byte1, uint8_t& byte2);
+void printI2CStats();
 void updateThermostat();
+void updateRelayOutput();
+void loadPidGains();
+void savePidGains();
+void toggleAutotune();
+void printPidStatus();
 void updateDisplay();
 void handleTouch();
 void handleButtonFeedback();
@@ -119,6 +314,40 @@ void setRelay(bool state);
 void tryResetSafetyShutdown();
 void drawButton(int x, int y, int w, int h, const char* label, uint16_t color);
 void drawUI();
+void printRenderStats();
+void controlTask(void* param);
+void uiTask(void* param);
+void bleTask(void* param);
+void publishState();
+void applyCommand(const HeaterCommand& cmd);
+bool postCommand(HeaterCommandType type, float value);
+void handleSerialCommand(char cmd);
+void printJitterStats();
+void recordHistory();
+uint32_t updateTrendChart();
+void sendHistoryChunk();
+void updateTelemetry(const HeaterState& state);
+int16_t toDeciF(float tempF);
+void updateEstimator();
+float currentEtaSeconds();
+void formatEta(float etaSeconds, char* out, size_t len);
+void printEstimatorStatus();
+void onTouchIrq();
+void initTouch();
+bool touchAdjustSetpoint(float step, uint32_t startUs);
+void recordTouchLatency(float shownSetpoint);
+void waitForNextSample(TickType_t& lastWake);
+uint32_t wallClockNow();
+void formatClock(uint32_t seconds, char* out, size_t len);
+float preheatEtaSeconds();
+void updatePreheat();
+void armPreheat(uint16_t readyMinutes);
+void loadPreheat();
+void savePreheat();
+void loadHeatupModel();
+void saveHeatupModel();
+void updatePreheatStatus(const HeaterState& state);
+void handleScheduleTap(unsigned long currentMillis);
 
 // ========================================
 // BLE Setpoint Write Callback
@@ -142,35 +371,23 @@ class SetpointCallbacks: public BLECharacteristicCallbacks {
             // Parse the incoming value as float
             float newSetpoint = atof(value.c_str());
             Serial.printf("Parsed as float: %.1f°F\n", newSetpoint);
-            Serial.printf("Current setpointTemp BEFORE: %.1f°F\n", setpointTemp);
 
             // Validate range
             if (newSetpoint >= MIN_SETPOINT_F && newSetpoint <= MAX_SETPOINT_F) {
                 Serial.println("✓ Value is within valid range");
-                
-                setpointTemp = newSetpoint;
-                Serial.printf("✓ setpointTemp UPDATED to: %.1f°F\n", setpointTemp);
-
-                // Try to reset safety shutdown if conditions allow
-                tryResetSafetyShutdown();
-
-                // Send notification back to confirm
-                char setpointStr[16];
-                snprintf(setpointStr, sizeof(setpointStr), "%.1f", setpointTemp);
-                pCharacteristic->setValue(setpointStr);
-                pCharacteristic->notify();
-                Serial.printf("✓ BLE notification sent: %s\n", setpointStr);
-
-                // Flag for display update in main loop (don't call updateDisplay here!)
-                forceDisplayUpdate = true;
-                Serial.println("✓ Display update flagged");
+
+                // The control task applies it; the BLE task notifies the
+                // confirmed value once it has been published
+                if (postCommand(CMD_SET_SETPOINT, newSetpoint)) {
+                    Serial.println("✓ Setpoint queued for control task");
+                } else {
+                    Serial.println("✗ REJECTED - Command queue full");
+                }
             } else {
                 Serial.println("✗ REJECTED - Value out of range!");
                 Serial.printf("  Range: %.1f°F to %.1f°F\n", MIN_SETPOINT_F, MAX_SETPOINT_F);
                 Serial.printf("  Received: %.1f°F\n", newSetpoint);
             }
-            
-            Serial.printf("Current setpointTemp AFTER: %.1f°F\n", setpointTemp);
         } else {
             Serial.println("✗ ERROR: Empty value received");
         }
@@ -186,15 +403,69 @@ class SetpointCallbacks: public BLECharacteristicCallbacks {
 // Global callback instance
 static SetpointCallbacks setpointCallbacks;
 
+// ========================================
+// BLE History Request Callback
+// ========================================
+// Only records the request; the BLE task streams the chunks.
+class HistoryCallbacks: public BLECharacteristicCallbacks {
+    void onWrite(BLECharacteristic* pCharacteristic) {
+        std::string value = pCharacteristic->getValue();
+
+        uint32_t from = 0;
+        if (value.length() >= sizeof(uint32_t)) {
+            memcpy(&from, value.data(), sizeof(uint32_t));
+        }
+        historyExportFrom = from;
+        historyExportPending = true;
+        Serial.printf("BLE history export requested from index %lu\n", (unsigned long)from);
+
+        if (bleTaskHandle != nullptr) {
+            xTaskNotifyGive(bleTaskHandle);
+        }
+    }
+};
+
+static HistoryCallbacks historyCallbacks;
+
+// ========================================
+// BLE Preheat Write Callback
+// ========================================
+// Sets the wall clock directly; schedule changes go to the control task.
+class PreheatCallbacks: public BLECharacteristicCallbacks {
+    void onWrite(BLECharacteristic* pCharacteristic) {
+        std::string value = pCharacteristic->getValue();
+        if (value.length() < sizeof(PreheatCommandFrame)) {
+            Serial.printf("BLE preheat: short write (%d bytes)\n", value.length());
+            return;
+        }
+
+        PreheatCommandFrame frame;
+        memcpy(&frame, value.data(), sizeof(frame));
+
+        if (frame.localTime >= CLOCK_VALID_EPOCH) {
+            struct timeval tv = { (time_t)frame.localTime, 0 };
+            settimeofday(&tv, nullptr);
+            char clock[8];
+            formatClock(frame.localTime, clock, sizeof(clock));
+            Serial.printf("BLE preheat: clock set to %s\n", clock);
+        }
+
+        if (frame.op == PREHEAT_OP_ARM && frame.hour < 24 && frame.minute < 60) {
+            postCommand(CMD_PREHEAT_ARM, frame.hour * 60 + frame.minute);
+        } else if (frame.op == PREHEAT_OP_CANCEL) {
+            postCommand(CMD_PREHEAT_CANCEL, 0.0f);
+        }
+    }
+};
+
+static PreheatCallbacks preheatCallbacks;
+
 // ========================================
 // Safety Shutdown Reset Helper
 // ========================================
+// Control task only (called when a setpoint command is applied)
 void tryResetSafetyShutdown() {
-    // Cache volatile values for consistent decision
-    float localTemp = currentTemp;
-    bool localSensorError = sensorError;
-    
-    if (safetyShutdown && localTemp < SAFETY_MAX_TEMP_F && !localSensorError) {
+    if (safetyShutdown && currentTemp < SAFETY_MAX_TEMP_F && !sensorError) {
         safetyShutdown = false;
         Serial.println("✓ Safety shutdown reset");
     }
@@ -230,16 +501,45 @@ void setup() {
     tft.setTouch(calData);
     Serial.println("Touch initialized with calibration data");
     Serial.println("Note: Send 'c' via serial to run calibration");
+    Serial.println("      Send 'i' for I2C stats, 'l' to toggle legacy MAX6675 bit-bang");
+    Serial.println("      Send 'p' for PID status, 't' to start/abort autotune");
+    Serial.println("      Send 'r' for display render stats, 'j' for control jitter");
+    Serial.println("      Send 'e' for heat-up estimator status");
 
     // Initialize Bluetooth
     initBluetooth();
 
-    // Turn off heater initially
+    // Load PID gains from NVS
+    loadPidGains();
+    pid.setDerivativeFilter(PID_DERIVATIVE_FILTER_S);
+
+    // Restore the learned heat-up model and any armed preheat schedule
+    loadHeatupModel();
+    loadPreheat();
+
+    // Turn off heater initially (already off as far as setRelay() knows)
     setRelay(false);
+    Serial.println("Relay set to OFF");
+    relayWindow.restart(millis());
+
+    // First snapshot, so the UI never sees an uninitialized state
+    publishState();
 
     // Draw initial UI
     drawUI();
 
+    // Start the tasks (see Task Model above)
+    commandQueue = xQueueCreate(COMMAND_QUEUE_LENGTH, sizeof(HeaterCommand));
+    xTaskCreatePinnedToCore(controlTask, "control", CONTROL_TASK_STACK, nullptr,
+                            CONTROL_TASK_PRIORITY, &controlTaskHandle, CONTROL_TASK_CORE);
+    xTaskCreatePinnedToCore(uiTask, "ui", UI_TASK_STACK, nullptr,
+                            UI_TASK_PRIORITY, &uiTaskHandle, UI_TASK_CORE);
+    xTaskCreatePinnedToCore(bleTask, "ble", BLE_TASK_STACK, nullptr,
+                            BLE_TASK_PRIORITY, &bleTaskHandle, BLE_TASK_CORE);
+
+    // Pen interrupt wakes the UI task, so attach it once the task exists
+    initTouch();
+
     Serial.println("Initialization complete!");
     Serial.printf("Default setpoint: %.1f°F\n", setpointTemp);
 }
@@ -247,103 +547,588 @@ void setup() {
 // ========================================
 // Main Loop
 // ========================================
+// All work runs in the tasks created by setup()
 void loop() {
-    unsigned long currentMillis = millis();
+    vTaskDelete(NULL);
+}
+
+// ========================================
+// Control Task (MAX6675, PID, relay)
+// ========================================
+// Wakes every SAMPLE_INTERVAL_MS on an absolute schedule (vTaskDelayUntil),
+// so the sample and control periods do not drift with the work done in each
+// iteration. How late each wake-up was is recorded in a histogram.
+void controlTask(void* param) {
+    TickType_t lastWake = xTaskGetTickCount();
+    uint32_t scheduledUs = micros();
+
+    for (;;) {
+        uint32_t wakeUs = micros();
+        int32_t lateness = (int32_t)(wakeUs - scheduledUs);
+        jitter.record(lateness > 0 ? (uint32_t)lateness : 0);
+
+        // Apply pending commands before sampling, so a setpoint change and
+        // the safety reset it may trigger see the same state
+        HeaterCommand cmd;
+        bool applied = false;
+        while (xQueueReceive(commandQueue, &cmd, 0) == pdTRUE) {
+            applyCommand(cmd);
+            applied = true;
+        }
+
+        // Sample the thermocouple at its native rate (safety checked per sample)
+        sampleTemperature();
+
+        // Run the thermostat on the filtered stream at its own period
+        unsigned long currentMillis = millis();
+        if (currentMillis - lastControlTime >= CONTROL_INTERVAL_MS) {
+            lastControlTime = currentMillis;
+            runControl();
+        }
+
+        // Drive the relay from the time-proportioning window
+        if (!safetyShutdown) {
+            updateRelayOutput();
+        }
 
-    // Check for serial commands
-    if (Serial.available() > 0) {
-        char cmd = Serial.read();
-        if (cmd == 'c' || cmd == 'C') {
-            calibrateTouch();
-            drawUI();  // Redraw UI after calibration
+        updateEstimator();
+        recordHistory();
+        publishState();
+        jitter.recordRunTime(micros() - wakeUs);
+        controlJitter.write(jitter);
+
+        if (applied) {
+            forceDisplayUpdate = true;
+            xTaskNotifyGive(bleTaskHandle);
         }
+
+        scheduledUs += SAMPLE_INTERVAL_MS * 1000UL;
+        waitForNextSample(lastWake);
     }
+}
 
-    // Read temperature periodically
-    if (currentMillis - lastTempRead >= TEMP_READ_INTERVAL) {
-        lastTempRead = currentMillis;
-        
-        // Read and smooth temperature
-        float tempReading = readMAX6675();
-        currentTemp = tempReading;
-
-        // Cache all volatile values for consistent logic in this block
-        float localTemp = currentTemp;
-        float localSetpoint = setpointTemp;
-        bool localHeaterOn = heaterOn;
-        bool localSafetyShutdown = safetyShutdown;
-        bool localSensorError = sensorError;
-
-        // Check for sensor error
-        if (localTemp >= SENSOR_ERROR_TEMP) {
-            sensorError = true;
-            safetyShutdown = true;
-            setRelay(false);
-            Serial.println("ERROR: Sensor error detected!");
-            localSensorError = true;
-            localSafetyShutdown = true;
-        } else {
-            sensorError = false;
-            localSensorError = false;
-        }
-
-        // Check for over-temperature (use >= for safety-critical threshold)
-        if (localTemp >= SAFETY_MAX_TEMP_F && !localSensorError) {
-            safetyShutdown = true;
-            setRelay(false);
-            Serial.printf("ERROR: Over-temperature detected! Temp: %.1f°F\n", localTemp);
-            localSafetyShutdown = true;
-        }
-
-        // Debug: Print system state
-        Serial.println("--- System State ---");
-        Serial.printf("Current Temp: %.1f°F\n", localTemp);
-        Serial.printf("Setpoint: %.1f°F (Hysteresis ±%.1f°F)\n", localSetpoint, TEMP_HYSTERESIS_F);
-        Serial.printf("Heater: %s\n", localHeaterOn ? "ON" : "OFF");
-        Serial.printf("Safety Shutdown: %s\n", localSafetyShutdown ? "YES" : "NO");
-        Serial.printf("Sensor Error: %s\n", localSensorError ? "YES" : "NO");
-        Serial.printf("BLE Connected: %s\n", deviceConnected ? "YES" : "NO");
-        unsigned long timeSinceRelayChange = (currentMillis - lastRelayChange) / 1000;
-        Serial.printf("Time since last relay change: %lu sec (min: %d sec)\n",
-                     timeSinceRelayChange, RELAY_MIN_CYCLE_TIME / 1000);
-
-        if (!localHeaterOn) {
-            float turnOnThreshold = localSetpoint - TEMP_HYSTERESIS_F;
-            Serial.printf("Heater will turn ON when temp < %.1f°F\n", turnOnThreshold);
-            if (localTemp >= turnOnThreshold) {
-                Serial.printf("  -> Still %.1f°F above turn-on threshold\n",
-                             localTemp - turnOnThreshold);
+// ========================================
+// Wait For Next Sample (control task)
+// ========================================
+// Same schedule as vTaskDelayUntil, but blocks on the command queue instead,
+// so a touch or BLE setpoint change is applied and published within
+// milliseconds rather than at the next sample.
+void waitForNextSample(TickType_t& lastWake) {
+    const TickType_t nextWake = lastWake + pdMS_TO_TICKS(SAMPLE_INTERVAL_MS);
+
+    for (;;) {
+        int32_t remaining = (int32_t)(nextWake - xTaskGetTickCount());
+        if (remaining <= 0) {
+            break;
+        }
+
+        HeaterCommand cmd;
+        if (xQueueReceive(commandQueue, &cmd, (TickType_t)remaining) != pdTRUE) {
+            break;
+        }
+        applyCommand(cmd);
+        publishState();
+        forceDisplayUpdate = true;
+        xTaskNotifyGive(bleTaskHandle);
+        xTaskNotifyGive(uiTaskHandle);
+    }
+
+    lastWake = nextWake;
+}
+
+// ========================================
+// UI Task (touch, display, serial)
+// ========================================
+void uiTask(void* param) {
+    for (;;) {
+        unsigned long currentMillis = millis();
+
+        // Check for serial commands
+        if (Serial.available() > 0) {
+            handleSerialCommand(Serial.read());
+        }
+
+        // Periodic serial state dump
+        if (currentMillis - lastStatusLog >= STATUS_LOG_INTERVAL_MS) {
+            lastStatusLog = currentMillis;
+            logSystemState();
+        }
+
+        // Handle non-blocking button feedback
+        handleButtonFeedback();
+
+        // Update display periodically (or when forced)
+        if (currentMillis - lastDisplayUpdate >= DISPLAY_UPDATE_INTERVAL ||
+            forceDisplayUpdate.exchange(false)) {
+            lastDisplayUpdate = currentMillis;
+            updateDisplay();
+        }
+
+        // Handle touch input
+        handleTouch();
+
+        // Abandon an unconfirmed schedule edit
+        if (scheduleEditing && currentMillis - lastScheduleTouch >= PREHEAT_EDIT_TIMEOUT_MS) {
+            scheduleEditing = false;
+            forceDisplayUpdate = true;
+        }
+
+        // Woken early by the touch IRQ or an applied command
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(UI_TASK_PERIOD_MS));
+    }
+}
+
+// ========================================
+// BLE Task (notifications)
+// ========================================
+// Runs every DISPLAY_UPDATE_INTERVAL, or immediately when the control task
+// has applied a command (so a BLE setpoint write is confirmed right away).
+// While a history export is running it wakes every HISTORY_EXPORT_PACING_MS
+// to send the next chunk.
+void bleTask(void* param) {
+    unsigned long lastUpdate = 0;
+
+    for (;;) {
+        TickType_t wait = historyExportActive ? pdMS_TO_TICKS(HISTORY_EXPORT_PACING_MS)
+                                              : pdMS_TO_TICKS(DISPLAY_UPDATE_INTERVAL);
+        bool notified = ulTaskNotifyTake(pdTRUE, wait) > 0;
+
+        if (historyExportPending.exchange(false)) {
+            historyExportCursor = historyExportFrom;
+            historyExportChunks = 0;
+            historyExportActive = true;
+        }
+        if (historyExportActive) {
+            sendHistoryChunk();
+        }
+
+        unsigned long currentMillis = millis();
+        if (notified || currentMillis - lastUpdate >= DISPLAY_UPDATE_INTERVAL) {
+            lastUpdate = currentMillis;
+            updateBluetooth();
+        }
+    }
+}
+
+// ========================================
+// Heat-Up Estimator Update (control task)
+// ========================================
+// Every ESTIMATOR_INTERVAL_MS the temperature change over the interval and
+// the fraction of it the relay was on become one RLS observation.
+void updateEstimator() {
+    if (heaterOn) {
+        estimatorRelayOnMs += SAMPLE_INTERVAL_MS;
+    }
+
+    unsigned long currentMillis = millis();
+    unsigned long elapsed = currentMillis - lastEstimatorTime;
+    if (elapsed < ESTIMATOR_INTERVAL_MS) {
+        return;
+    }
+    lastEstimatorTime = currentMillis;
+
+    if (sensorError) {
+        // No trustworthy endpoint; start a fresh interval once the probe is back
+        estimatorStartValid = false;
+    } else {
+        if (estimatorStartValid) {
+            float duty = (float)estimatorRelayOnMs / elapsed;
+            if (duty > 1.0f) duty = 1.0f;
+            estimator.update(estimatorStartTemp, currentTemp, duty, elapsed / 1000.0f);
+            if (currentMillis - lastModelSave >= ESTIMATOR_SAVE_INTERVAL_MS) {
+                saveHeatupModel();
             }
-        } else {
-            float turnOffThreshold = localSetpoint + TEMP_HYSTERESIS_F;
-            Serial.printf("Heater will turn OFF when temp > %.1f°F\n", turnOffThreshold);
         }
-        Serial.println("-------------------");
+        estimatorStartTemp = currentTemp;
+        estimatorStartValid = true;
+    }
+    estimatorRelayOnMs = 0;
+}
 
-        // Update thermostat logic if not in safety shutdown
-        if (!safetyShutdown) {
-            updateThermostat();
+// ========================================
+// Current Heat-Up ETA (control task)
+// ========================================
+float currentEtaSeconds() {
+    if (sensorError || safetyShutdown) {
+        return HeatupEstimator::ETA_UNKNOWN;
+    }
+    if (currentTemp >= setpointTemp - ETA_AT_TEMP_BAND_F) {
+        return 0.0f;
+    }
+    return estimator.etaSeconds(currentTemp, setpointTemp);
+}
+
+// ========================================
+// Format ETA for Display
+// ========================================
+void formatEta(float etaSeconds, char* out, size_t len) {
+    if (etaSeconds == HeatupEstimator::ETA_UNREACHABLE) {
+        snprintf(out, len, "CAN'T REACH");
+    } else if (etaSeconds < 0.0f) {
+        snprintf(out, len, "ETA --");
+    } else if (etaSeconds == 0.0f) {
+        snprintf(out, len, "AT TEMP");
+    } else {
+        unsigned long minutes = (unsigned long)(etaSeconds / 60.0f + 0.5f);
+        if (minutes < 60) {
+            snprintf(out, len, "ETA %lum", minutes < 1 ? 1UL : minutes);
         } else {
-            Serial.println("THERMOSTAT DISABLED: Safety shutdown active!");
-            Serial.println("To reset: Adjust setpoint when temp < safety max and sensor OK");
+            snprintf(out, len, "ETA %luh%02lum", minutes / 60, minutes % 60);
         }
     }
+}
 
-    // Handle non-blocking button feedback
-    handleButtonFeedback();
+// ========================================
+// Print Estimator Status (serial 'e')
+// ========================================
+void printEstimatorStatus() {
+    Serial.println("--- Heat-Up Estimator ---");
+    Serial.printf("Updates: %lu (every %ds, valid: %s)\n",
+                  (unsigned long)estimator.getUpdates(), ESTIMATOR_INTERVAL_MS / 1000,
+                  estimator.isValid() ? "YES" : "NO");
+    Serial.printf("Heating rate (full power): %.2f°F/min\n", estimator.heatingRate());
+    Serial.printf("Time constant: %.0f min, ambient: %.0f°F\n",
+                  estimator.timeConstantMinutes(), estimator.ambientF());
+    Serial.printf("Full-power steady state: %.0f°F\n", estimator.steadyStateF(1.0f));
+
+    char eta[16];
+    formatEta(currentEtaSeconds(), eta, sizeof(eta));
+    Serial.printf("To %.1f°F: %s\n", setpointTemp, eta);
+    Serial.println("-------------------------");
+}
 
-    // Update display and Bluetooth periodically (or when forced)
-    if (currentMillis - lastDisplayUpdate >= DISPLAY_UPDATE_INTERVAL || forceDisplayUpdate) {
-        lastDisplayUpdate = currentMillis;
-        forceDisplayUpdate = false;
-        updateDisplay();
-        updateBluetooth();
+// ========================================
+// Wall Clock (local time set by the app, no RTC)
+// ========================================
+// Returns 0 until the clock has been set since boot.
+uint32_t wallClockNow() {
+    time_t now = time(nullptr);
+    return (now >= (time_t)CLOCK_VALID_EPOCH) ? (uint32_t)now : 0;
+}
+
+void formatClock(uint32_t seconds, char* out, size_t len) {
+    snprintf(out, len, "%02lu:%02lu",
+             (unsigned long)((seconds / 3600) % 24), (unsigned long)((seconds / 60) % 60));
+}
+
+// ========================================
+// Preheat Lead Time (control task)
+// ========================================
+// Full-power heat-up time from the current temperature. Until the model has
+// learned enough, assume a conservative fixed heating rate.
+float preheatEtaSeconds() {
+    if (sensorError) {
+        return 0.0f;
+    }
+    float eta = estimator.etaSeconds(currentTemp, setpointTemp);
+    if (eta == HeatupEstimator::ETA_UNREACHABLE) {
+        return INFINITY;    // Start now: the setpoint is the best effort
+    }
+    if (eta < 0.0f) {
+        float gap = setpointTemp - currentTemp;
+        return (gap > 0.0f) ? gap / PREHEAT_FALLBACK_RATE_F_PER_MIN * 60.0f : 0.0f;
+    }
+    return eta;
+}
+
+// ========================================
+// Preheat Schedule Update (control task, every CONTROL_INTERVAL_MS)
+// ========================================
+void updatePreheat() {
+    char clock[8];
+    switch (preheat.update(wallClockNow(), preheatEtaSeconds())) {
+        case PreheatScheduler::STARTED:
+            formatClock(preheat.readyTime(), clock, sizeof(clock));
+            Serial.printf(">>> Preheat started (ready at %s, %.0f min predicted) <<<\n",
+                          clock, preheatEtaSeconds() / 60.0f);
+            break;
+        case PreheatScheduler::COMPLETED:
+            Serial.printf(">>> Preheat complete: %.1f°F (setpoint %.1f°F) <<<\n",
+                          currentTemp, setpointTemp);
+            savePreheat();
+            break;
+        case PreheatScheduler::MISSED:
+            Serial.println("Preheat schedule missed (clock set after the ready time), cleared");
+            savePreheat();
+            break;
+        default:
+            break;
+    }
+}
+
+// ========================================
+// Arm Preheat Schedule (control task)
+// ========================================
+void armPreheat(uint16_t readyMinutes) {
+    uint32_t now = wallClockNow();
+    if (now == 0) {
+        Serial.println("Preheat: clock not set - connect the app to sync it");
+        return;
+    }
+
+    // Next occurrence of HH:MM
+    uint32_t ready = now - (now % 86400UL) + (uint32_t)(readyMinutes % 1440) * 60UL;
+    if (ready <= now) {
+        ready += 86400UL;
+    }
+
+    preheat.arm(ready);
+    preheat.update(now, preheatEtaSeconds());
+    savePreheat();
+    saveHeatupModel();
+
+    char readyStr[8], startStr[8];
+    formatClock(ready, readyStr, sizeof(readyStr));
+    formatClock(preheat.startTime(), startStr, sizeof(startStr));
+    Serial.printf("Preheat armed: ready at %s, latest start %s%s\n", readyStr, startStr,
+                  estimator.isValid() ? "" : " (no heat-up model yet, using fallback rate)");
+}
+
+// ========================================
+// Preheat / Heat-Up Model Persistence (NVS)
+// ========================================
+void loadPreheat() {
+    preferences.begin(NVS_NAMESPACE, true);
+    uint32_t ready = preferences.getUInt(NVS_PREHEAT_READY_KEY, 0);
+    preferences.end();
+
+    if (ready != 0) {
+        // Held off until the app sets the clock; cleared then if already past
+        preheat.arm(ready);
+        char readyStr[8];
+        formatClock(ready, readyStr, sizeof(readyStr));
+        Serial.printf("Preheat schedule restored: ready at %s (waiting for clock)\n", readyStr);
     }
+}
 
-    // Handle touch input
-    handleTouch();
+void savePreheat() {
+    preferences.begin(NVS_NAMESPACE, false);
+    preferences.putUInt(NVS_PREHEAT_READY_KEY, preheat.isArmed() ? preheat.readyTime() : 0);
+    preferences.end();
+}
+
+void loadHeatupModel() {
+    HeatupEstimator::Model model;
+    preferences.begin(NVS_NAMESPACE, true);
+    size_t len = preferences.getBytes(NVS_HEATUP_MODEL_KEY, &model, sizeof(model));
+    preferences.end();
+
+    if (len == sizeof(model) && estimator.importModel(model)) {
+        Serial.printf("Heat-up model loaded (%lu updates, %s)\n",
+                      (unsigned long)estimator.getUpdates(),
+                      estimator.isValid() ? "valid" : "still learning");
+    } else {
+        Serial.println("No heat-up model stored, learning from scratch");
+    }
+}
+
+void saveHeatupModel() {
+    HeatupEstimator::Model model;
+    estimator.exportModel(model);
+    preferences.begin(NVS_NAMESPACE, false);
+    preferences.putBytes(NVS_HEATUP_MODEL_KEY, &model, sizeof(model));
+    preferences.end();
+    lastModelSave = millis();
+}
+
+// ========================================
+// Record History Sample (control task)
+// ========================================
+void recordHistory() {
+    historyRelaySeen |= heaterOn;
+
+    unsigned long currentMillis = millis();
+    if (currentMillis - lastHistoryTime < HISTORY_INTERVAL_MS) {
+        return;
+    }
+    lastHistoryTime = currentMillis;
+
+    portENTER_CRITICAL(&historyLock);
+    history.push(currentTemp, historyRelaySeen);
+    portEXIT_CRITICAL(&historyLock);
+
+    historyRelaySeen = heaterOn;
+}
+
+// ========================================
+// Send One History Chunk (BLE task)
+// ========================================
+void sendHistoryChunk() {
+    if (!deviceConnected) {
+        historyExportActive = false;
+        return;
+    }
+
+    // Fill the negotiated ATT MTU (3 bytes of it are the notify header)
+    uint16_t mtu = pServer->getPeerMTU(pServer->getConnId());
+    uint16_t payload = (mtu > 23) ? mtu - 3 : 20;
+    if (payload > HISTORY_EXPORT_MAX_PAYLOAD) payload = HISTORY_EXPORT_MAX_PAYLOAD;
+    uint16_t maxSamples = (payload - sizeof(HistoryChunkHeader)) / sizeof(int16_t);
+
+    static uint8_t chunk[HISTORY_EXPORT_MAX_PAYLOAD];
+    int16_t samples[(HISTORY_EXPORT_MAX_PAYLOAD - sizeof(HistoryChunkHeader)) / sizeof(int16_t)];
+
+    portENTER_CRITICAL(&historyLock);
+    uint32_t from = historyExportCursor;
+    uint16_t count = history.copy(from, samples, maxSamples);
+    uint32_t end = history.endIndex();
+    portEXIT_CRITICAL(&historyLock);
+
+    HistoryChunkHeader header;
+    header.firstIndex = count ? from : end;
+    header.count = count;
+    header.intervalS = HISTORY_INTERVAL_MS / 1000;
+    memcpy(chunk, &header, sizeof(header));
+    memcpy(chunk + sizeof(header), samples, count * sizeof(int16_t));
+
+    pHistoryCharacteristic->setValue(chunk, sizeof(header) + count * sizeof(int16_t));
+    pHistoryCharacteristic->notify();
+    historyExportChunks++;
+
+    if (count == 0) {
+        historyExportActive = false;
+        Serial.printf("BLE history export done: %lu chunks, next index %lu\n",
+                      (unsigned long)historyExportChunks, (unsigned long)end);
+    } else {
+        historyExportCursor = from + count;
+    }
+}
+
+// ========================================
+// Publish State Snapshot (control task)
+// ========================================
+void publishState() {
+    HeaterState state;
+    state.currentTemp = currentTemp;
+    state.rawTemp = lastRawTempF;
+    state.setpointTemp = setpointTemp;
+    state.duty = relayWindow.getDuty();
+    state.etaSeconds = currentEtaSeconds();
+    state.lastRelayChange = lastRelayChange;
+    state.preheatReady = preheat.readyTime();
+    state.preheatStart = preheat.startTime();
+    state.preheatState = (uint8_t)preheat.getState();
+    state.rawWord = lastRawWord;
+    state.heaterOn = heaterOn;
+    state.sensorError = sensorError;
+    state.safetyShutdown = safetyShutdown;
+    state.autotuning = (autotuner.getState() == RelayAutotuner::RUNNING);
+    heaterState.write(state);
+}
+
+// ========================================
+// Post Command (any task)
+// ========================================
+bool postCommand(HeaterCommandType type, float value) {
+    HeaterCommand cmd = {type, value};
+    return xQueueSend(commandQueue, &cmd, 0) == pdTRUE;
+}
+
+// ========================================
+// Apply Command (control task)
+// ========================================
+void applyCommand(const HeaterCommand& cmd) {
+    switch (cmd.type) {
+        case CMD_SET_SETPOINT:
+        case CMD_ADJUST_SETPOINT: {
+            float next = (cmd.type == CMD_SET_SETPOINT) ? cmd.value : setpointTemp + cmd.value;
+            if (next < MIN_SETPOINT_F) next = MIN_SETPOINT_F;
+            if (next > MAX_SETPOINT_F) next = MAX_SETPOINT_F;
+            setpointTemp = next;
+            Serial.printf("Setpoint set to %.1f°F\n", setpointTemp);
+
+            // Try to reset safety shutdown if conditions allow
+            tryResetSafetyShutdown();
+            break;
+        }
+        case CMD_TOGGLE_AUTOTUNE:
+            toggleAutotune();
+            break;
+        case CMD_TOGGLE_LEGACY_BITBANG:
+            useLegacyBitBang = !useLegacyBitBang;
+            max6675Cost = {};
+            Serial.printf("MAX6675 read path: %s (stats reset)\n",
+                          useLegacyBitBang ? "LEGACY per-pin" : "PORT batched");
+            break;
+        case CMD_PRINT_I2C_STATS:
+            printI2CStats();
+            break;
+        case CMD_PRINT_PID:
+            printPidStatus();
+            break;
+        case CMD_RESET_JITTER:
+            jitter.reset();
+            break;
+        case CMD_PRINT_ESTIMATOR:
+            printEstimatorStatus();
+            break;
+        case CMD_PREHEAT_ARM:
+            armPreheat((uint16_t)cmd.value);
+            break;
+        case CMD_PREHEAT_CANCEL:
+            if (preheat.isArmed()) {
+                preheat.cancel();
+                savePreheat();
+                Serial.println("Preheat schedule cancelled");
+            }
+            break;
+    }
+}
+
+// ========================================
+// Serial Commands (UI task)
+// ========================================
+// Anything that touches control-owned state is forwarded to the control task.
+void handleSerialCommand(char cmd) {
+    if (cmd == 'c' || cmd == 'C') {
+        calibrateTouch();
+        drawUI();  // Redraw UI after calibration
+    } else if (cmd == 'i' || cmd == 'I') {
+        postCommand(CMD_PRINT_I2C_STATS, 0.0f);
+    } else if (cmd == 'l' || cmd == 'L') {
+        postCommand(CMD_TOGGLE_LEGACY_BITBANG, 0.0f);
+    } else if (cmd == 'p' || cmd == 'P') {
+        postCommand(CMD_PRINT_PID, 0.0f);
+    } else if (cmd == 't' || cmd == 'T') {
+        postCommand(CMD_TOGGLE_AUTOTUNE, 0.0f);
+    } else if (cmd == 'r' || cmd == 'R') {
+        printRenderStats();
+    } else if (cmd == 'j' || cmd == 'J') {
+        printJitterStats();
+    } else if (cmd == 'e' || cmd == 'E') {
+        postCommand(CMD_PRINT_ESTIMATOR, 0.0f);
+    }
+}
+
+// ========================================
+// Print Control Jitter (serial 'j')
+// ========================================
+void printJitterStats() {
+    JitterHistogram h = controlJitter.read();
+
+    Serial.println("--- Control Task Jitter ---");
+    Serial.printf("Iterations: %lu (period %dms)\n",
+                  (unsigned long)h.getSamples(), SAMPLE_INTERVAL_MS);
+    Serial.printf("Wake lateness: mean %lu us, max %lu us\n",
+                  (unsigned long)h.getMeanUs(), (unsigned long)h.getMaxUs());
+    Serial.printf("Iteration run time: max %lu us\n", (unsigned long)h.getMaxRunUs());
+
+    uint32_t lower = 0;
+    for (uint8_t i = 0; i < JitterHistogram::BUCKETS; i++) {
+        uint32_t upper = JitterHistogram::bucketLimitUs(i);
+        if (i < JitterHistogram::BUCKETS - 1) {
+            Serial.printf("  %6lu - %6lu us: %lu\n", (unsigned long)lower,
+                          (unsigned long)upper, (unsigned long)h.count(i));
+        } else {
+            Serial.printf("  >= %6lu us     : %lu\n", (unsigned long)lower,
+                          (unsigned long)h.count(i));
+        }
+        lower = upper;
+    }
+    Serial.println("---------------------------");
 
-    delay(10);
+    // Reset through the control task, which owns the histogram
+    postCommand(CMD_RESET_JITTER, 0.0f);
 }
 
 // ========================================
@@ -373,12 +1158,47 @@ void initMCP23017() {
     mcp.pinMode(MCP_MAX6675_CS, OUTPUT);     // MAX6675 CS
     mcp.pinMode(MCP_MAX6675_SO, INPUT);      // MAX6675 SO (data)
 
-    // Set initial states
-    mcp.digitalWrite(MCP_RELAY_PIN, LOW);    // Relay off (active HIGH)
-    mcp.digitalWrite(MCP_MAX6675_CS, HIGH);  // CS high (inactive)
-    mcp.digitalWrite(MCP_MAX6675_SCK, LOW);  // SCK low
+    // Hand port A to the port engine with initial states:
+    // relay off (active HIGH), CS high (inactive), SCK low
+    if (!mcpPort.begin(MCP23017_ADDR, (uint8_t)(1 << MCP_MAX6675_CS))) {
+        Serial.println("ERROR: MCP23017 port A setup failed!");
+        while (1) delay(10);
+    }
 
     Serial.println("MCP23017 initialized");
+
+    tryFastI2C();
+}
+
+// ========================================
+// I2C Fast Mode (400kHz) Probe
+// ========================================
+void tryFastI2C() {
+#if I2C_TRY_FAST_MODE
+    // Expected IODIRA: SO is the only input among the pins we configured,
+    // unused pins stay at their power-on default (input)
+    const uint8_t expectedDir = (uint8_t)~((1 << MCP_RELAY_PIN) |
+                                           (1 << MCP_MAX6675_SCK) |
+                                           (1 << MCP_MAX6675_CS));
+
+    Wire.setClock(I2C_FAST_FREQUENCY);
+
+    for (int i = 0; i < I2C_FAST_VERIFY_READS; i++) {
+        uint8_t dir = 0, latch = 0;
+        if (!mcpPort.readRegister(MCP_REG_IODIRA, dir) || dir != expectedDir ||
+            !mcpPort.readRegister(MCP_REG_OLATA, latch) || latch != mcpPort.latch()) {
+            Wire.setClock(I2C_FREQUENCY);
+            i2cClockHz = I2C_FREQUENCY;
+            Serial.printf("I2C: 400kHz readback failed (read %d), staying at %lukHz\n",
+                          i, (unsigned long)(I2C_FREQUENCY / 1000));
+            return;
+        }
+    }
+
+    i2cClockHz = I2C_FAST_FREQUENCY;
+    Serial.printf("I2C: bus verified, running at %lukHz\n",
+                  (unsigned long)(I2C_FAST_FREQUENCY / 1000));
+#endif
 }
 
 // ========================================
@@ -389,7 +1209,16 @@ void initDisplay() {
     tft.init();
     tft.setRotation(1);  // Landscape mode
     tft.fillScreen(COLOR_BG);
-    Serial.println("Display initialized");
+
+    // Allocate field sprites (falls back to direct drawing if heap is short)
+    bool spritesOk = tempField.begin();
+    spritesOk &= setpointField.begin();
+    spritesOk &= statusField.begin();
+    spritesOk &= bleField.begin();
+    spritesOk &= etaField.begin();
+    spritesOk &= trendChart.begin();
+    Serial.printf("Display initialized (%s)\n",
+                  spritesOk ? "sprite renderer" : "WARNING: direct drawing fallback");
 }
 
 // ========================================
@@ -437,8 +1266,9 @@ void initBluetooth() {
     pServer = BLEDevice::createServer();
     pServer->setCallbacks(&serverCallbacks);  // Use static instance
 
-    // Create BLE Service
-    BLEService *pService = pServer->createService(SERVICE_UUID);
+    // Create BLE Service. The default 15 handles is too few: each
+    // characteristic takes 2 plus 1 for its CCCD (6 x 3 + 1 = 19 today).
+    BLEService *pService = pServer->createService(BLEUUID(SERVICE_UUID), 32);
 
     // Create Temperature Characteristic
     pTempCharacteristic = pService->createCharacteristic(
@@ -467,6 +1297,33 @@ void initBluetooth() {
     );
     pStatusCharacteristic->addDescriptor(new BLE2902());
 
+    // Create History Characteristic (write a request, chunks come back as notifications)
+    pHistoryCharacteristic = pService->createCharacteristic(
+        HISTORY_CHAR_UUID,
+        BLECharacteristic::PROPERTY_WRITE |
+        BLECharacteristic::PROPERTY_NOTIFY
+    );
+    pHistoryCharacteristic->addDescriptor(new BLE2902());
+    pHistoryCharacteristic->setCallbacks(&historyCallbacks);
+
+    // Create Telemetry Characteristic (packed binary, one notify per change)
+    pTelemetryCharacteristic = pService->createCharacteristic(
+        TELEMETRY_CHAR_UUID,
+        BLECharacteristic::PROPERTY_READ |
+        BLECharacteristic::PROPERTY_NOTIFY
+    );
+    pTelemetryCharacteristic->addDescriptor(new BLE2902());
+
+    // Create Preheat Characteristic (schedule + clock sync, packed binary)
+    pPreheatCharacteristic = pService->createCharacteristic(
+        PREHEAT_CHAR_UUID,
+        BLECharacteristic::PROPERTY_READ |
+        BLECharacteristic::PROPERTY_WRITE |
+        BLECharacteristic::PROPERTY_NOTIFY
+    );
+    pPreheatCharacteristic->addDescriptor(new BLE2902());
+    pPreheatCharacteristic->setCallbacks(&preheatCallbacks);
+
     // Start the service
     pService->start();
 
@@ -490,12 +1347,19 @@ void updateBluetooth() {
         return;  // No client connected, skip update
     }
 
-    // Cache volatile values for consistent comparison
-    float localTemp = currentTemp;
-    float localSetpoint = setpointTemp;
-    bool localHeaterOn = heaterOn;
-    bool localSafetyShutdown = safetyShutdown;
-    bool localSensorError = sensorError;
+    // One consistent snapshot from the control task
+    HeaterState state = heaterState.read();
+    float localTemp = state.currentTemp;
+    float localSetpoint = state.setpointTemp;
+    bool localHeaterOn = state.heaterOn;
+    bool localSafetyShutdown = state.safetyShutdown;
+    bool localSensorError = state.sensorError;
+    long localEtaMinutes = (state.etaSeconds > 0.0f) ? (long)(state.etaSeconds / 60.0f + 0.5f)
+                                                     : (long)state.etaSeconds;
+
+    // Packed frames for current apps
+    updateTelemetry(state);
+    updatePreheatStatus(state);
 
     // Update Temperature Characteristic (only if changed, with 0.1°F threshold)
     if (fabsf(localTemp - lastNotifiedTemp) >= 0.1f) {
@@ -519,14 +1383,17 @@ void updateBluetooth() {
     // Using boolean values for cleaner mobile app parsing
     if (localHeaterOn != lastNotifiedHeaterOn ||
         localSafetyShutdown != lastNotifiedSafetyShutdown ||
-        localSensorError != lastNotifiedSensorError) {
-        
+        localSensorError != lastNotifiedSensorError ||
+        localEtaMinutes != lastNotifiedEtaMinutes) {
+
+        // eta: seconds to setpoint, 0 = at temperature, -1 = unknown, -2 = unreachable
         char statusStr[128];
         snprintf(statusStr, sizeof(statusStr),
-                 "{\"heater\":%s,\"safetyShutdown\":%s,\"sensorError\":%s}",
+                 "{\"heater\":%s,\"safetyShutdown\":%s,\"sensorError\":%s,\"eta\":%ld}",
                  localHeaterOn ? "true" : "false",
                  localSafetyShutdown ? "true" : "false",
-                 localSensorError ? "true" : "false");
+                 localSensorError ? "true" : "false",
+                 (long)state.etaSeconds);
 
         pStatusCharacteristic->setValue(statusStr);
         pStatusCharacteristic->notify();
@@ -534,20 +1401,182 @@ void updateBluetooth() {
         lastNotifiedHeaterOn = localHeaterOn;
         lastNotifiedSafetyShutdown = localSafetyShutdown;
         lastNotifiedSensorError = localSensorError;
+        lastNotifiedEtaMinutes = localEtaMinutes;
+    }
+}
+
+// ========================================
+// °F to Tenths of °F (int16, rounded and clamped)
+// ========================================
+int16_t toDeciF(float tempF) {
+    float deci = tempF * 10.0f;
+    if (deci > 32767.0f) return 32767;
+    if (deci < -32768.0f) return -32768;
+    return (int16_t)lroundf(deci);
+}
+
+// ========================================
+// Update Telemetry Characteristic
+// ========================================
+// The value is refreshed on every call (so a READ sees the current uptime);
+// a notification goes out only when the temperature, setpoint or a flag
+// changed since the last notified frame.
+void updateTelemetry(const HeaterState& state) {
+    TelemetryFrame frame;
+    frame.tempDeciF = toDeciF(state.currentTemp);
+    frame.setpointDeciF = toDeciF(state.setpointTemp);
+    frame.flags = (state.heaterOn ? TELEMETRY_FLAG_HEATER_ON : 0) |
+                  (state.safetyShutdown ? TELEMETRY_FLAG_SAFETY_SHUTDOWN : 0) |
+                  (state.sensorError ? TELEMETRY_FLAG_SENSOR_ERROR : 0) |
+                  (state.autotuning ? TELEMETRY_FLAG_AUTOTUNING : 0) |
+                  ((state.preheatState == PreheatScheduler::WAITING_FOR_CLOCK ||
+                    state.preheatState == PreheatScheduler::STANDBY) ? TELEMETRY_FLAG_PREHEAT_HOLD : 0);
+    frame.uptimeS = millis() / 1000;
+
+    bool changed = !telemetrySent ||
+                   frame.tempDeciF != lastTelemetry.tempDeciF ||
+                   frame.setpointDeciF != lastTelemetry.setpointDeciF ||
+                   frame.flags != lastTelemetry.flags;
+
+    frame.sequence = changed ? (uint16_t)(lastTelemetry.sequence + 1) : lastTelemetry.sequence;
+    pTelemetryCharacteristic->setValue((uint8_t*)&frame, sizeof(frame));
+
+    if (changed) {
+        pTelemetryCharacteristic->notify();
+        lastTelemetry = frame;
+        telemetrySent = true;
+    }
+}
+
+// ========================================
+// Update Preheat Status Characteristic
+// ========================================
+void updatePreheatStatus(const HeaterState& state) {
+    PreheatStatusFrame frame;
+    frame.state = state.preheatState;
+    frame.readyTime = state.preheatReady;
+    frame.startTime = state.preheatStart;
+    frame.localTime = wallClockNow();
+    pPreheatCharacteristic->setValue((uint8_t*)&frame, sizeof(frame));
+
+    if (frame.state != lastPreheatStatus.state ||
+        frame.readyTime != lastPreheatStatus.readyTime ||
+        frame.startTime / 60 != lastPreheatStatus.startTime / 60) {
+        pPreheatCharacteristic->notify();
+        lastPreheatStatus = frame;
     }
 }
 
 // ========================================
-// Compute Smoothed Temperature (Moving Average)
+// Sample Temperature (every SAMPLE_INTERVAL_MS)
+// ========================================
+// Safety is evaluated on every raw sample: a disconnected thermocouple or an
+// over-temperature reading shuts the heater off within one sample period,
+// without waiting for the filter or the control period.
+void sampleTemperature() {
+    float rawTemp = readMAX6675();
+    lastRawTempF = rawTemp;
+
+    // Check for sensor error
+    if (rawTemp >= SENSOR_ERROR_TEMP) {
+        if (!sensorError) {
+            Serial.println("ERROR: Sensor error detected!");
+            // Readings from before the fault must not be averaged into the
+            // first ones after it
+            resetTempFilter();
+        }
+        sensorError = true;
+        safetyShutdown = true;
+        setRelay(false);
+        currentTemp = SENSOR_ERROR_TEMP;
+        return;
+    }
+    sensorError = false;
+
+    // Check for over-temperature (use >= for safety-critical threshold)
+    if (rawTemp >= SAFETY_MAX_TEMP_F) {
+        if (!safetyShutdown) {
+            Serial.printf("ERROR: Over-temperature detected! Raw temp: %.1f°F\n", rawTemp);
+        }
+        safetyShutdown = true;
+        setRelay(false);
+    }
+
+    // Filtered stream for the thermostat, display and BLE
+    currentTemp = computeSmoothedTemp(rawTemp);
+}
+
+// ========================================
+// Run Control (every CONTROL_INTERVAL_MS)
+// ========================================
+void runControl() {
+    updatePreheat();
+
+    // Update thermostat logic if not in safety shutdown
+    if (safetyShutdown) {
+        pid.reset();
+        autotuner.abort();
+    } else if (preheat.holding()) {
+        // Scheduled preheat: heater stays off until the latest start time
+        pid.reset();
+        autotuner.abort();
+        relayWindow.setDuty(0.0f);
+    } else {
+        updateThermostat();
+    }
+}
+
+// ========================================
+// Log System State (every STATUS_LOG_INTERVAL_MS)
+// ========================================
+void logSystemState() {
+    // One consistent snapshot from the control task
+    HeaterState state = heaterState.read();
+    bool localSafetyShutdown = state.safetyShutdown;
+
+    Serial.println("--- System State ---");
+    Serial.printf("Current Temp: %.1f°F (last raw: %.2f°F [0x%04X])\n",
+                  state.currentTemp, state.rawTemp, state.rawWord);
+    Serial.printf("Setpoint: %.1f°F\n", state.setpointTemp);
+    Serial.printf("Heater: %s (duty %.0f%%)\n", state.heaterOn ? "ON" : "OFF",
+                  state.duty * 100.0f);
+    Serial.printf("Safety Shutdown: %s\n", localSafetyShutdown ? "YES" : "NO");
+    Serial.printf("Sensor Error: %s\n", state.sensorError ? "YES" : "NO");
+    if (state.preheatState != PreheatScheduler::IDLE) {
+        const char* preheatNames[] = {"IDLE", "WAITING FOR CLOCK", "STANDBY", "HEATING"};
+        char readyStr[8], startStr[8];
+        formatClock(state.preheatReady, readyStr, sizeof(readyStr));
+        formatClock(state.preheatStart, startStr, sizeof(startStr));
+        Serial.printf("Preheat: %s (ready %s, start %s)\n",
+                      preheatNames[state.preheatState], readyStr, startStr);
+    }
+    Serial.printf("BLE Connected: %s\n", deviceConnected ? "YES" : "NO");
+    unsigned long timeSinceRelayChange = (millis() - state.lastRelayChange) / 1000;
+    Serial.printf("Time since last relay change: %lu sec (min: %d sec)\n",
+                 timeSinceRelayChange, RELAY_MIN_CYCLE_TIME / 1000);
+
+    if (localSafetyShutdown) {
+        Serial.println("THERMOSTAT DISABLED: Safety shutdown active!");
+        Serial.println("To reset: Adjust setpoint when temp < safety max and sensor OK");
+    }
+    Serial.println("-------------------");
+}
+
+// ========================================
+// Compute Smoothed Temperature (Median + Moving Average)
 // ========================================
 float computeSmoothedTemp(float newReading) {
     // Don't smooth error values
     if (newReading >= SENSOR_ERROR_TEMP) {
         return newReading;
     }
+
+    // Reject single-sample spikes before averaging
+    rawSamples.push(newReading);
+    float median = rawSamples.median();
     
     // Add to history
-    tempHistory[tempHistoryIndex] = newReading;
+    tempHistory[tempHistoryIndex] = median;
     tempHistoryIndex = (tempHistoryIndex + 1) % TEMP_HISTORY_SIZE;
     if (tempHistoryCount < TEMP_HISTORY_SIZE) {
         tempHistoryCount++;
@@ -562,15 +1591,22 @@ float computeSmoothedTemp(float newReading) {
     return sum / tempHistoryCount;
 }
 
+// Drop the median ring and the moving average (sensor fault)
+void resetTempFilter() {
+    rawSamples.clear();
+    tempHistoryIndex = 0;
+    tempHistoryCount = 0;
+}
+
 // ========================================
 // Read MAX6675 Temperature
 // ========================================
 float readMAX6675() {
     uint16_t raw = readMAX6675Raw();
+    lastRawWord = raw;
 
     // Check for error (D2 bit set)
     if (raw & 0x04) {
-        Serial.println("MAX6675 Error: Thermocouple not connected");
         return SENSOR_ERROR_TEMP;
     }
 
@@ -585,22 +1621,70 @@ float readMAX6675() {
     // Convert to Celsius (0.25°C per count)
     float tempC = tempValue * 0.25f;
 
-    // Convert to Fahrenheit
-    float tempF = (tempC * 9.0f / 5.0f) + 32.0f;
+    // Convert to Fahrenheit (unfiltered - see computeSmoothedTemp)
+    return (tempC * 9.0f / 5.0f) + 32.0f;
+}
+
+// ========================================
+// Read MAX6675 Raw Value (with cost tracking)
+// ========================================
+uint16_t readMAX6675Raw() {
+    uint32_t startTx = mcpPort.transactionCount();
+    unsigned long startUs = micros();
 
-    // Apply moving average smoothing
-    float smoothedTempF = computeSmoothedTemp(tempF);
+    uint16_t raw = useLegacyBitBang ? readMAX6675RawLegacy() : readMAX6675RawPort();
 
-    Serial.printf("Temp: %.2f°F (raw: %.2f°F, %.2f°C) [Raw: 0x%04X]\n", 
-                  smoothedTempF, tempF, tempC, raw);
+    max6675Cost.lastMicros = micros() - startUs;
+    max6675Cost.lastTransactions = mcpPort.transactionCount() - startTx;
+    max6675Cost.samples++;
+    max6675Cost.totalMicros += max6675Cost.lastMicros;
+    max6675Cost.totalTransactions += max6675Cost.lastTransactions;
 
-    return smoothedTempF;
+    return raw;
 }
 
 // ========================================
-// Read MAX6675 Raw Value
+// Read MAX6675 via Port-Level Bit-Bang
 // ========================================
-uint16_t readMAX6675Raw() {
+// D15 is on SO as soon as CS falls; each falling SCK edge shifts out the next
+// bit. Per bit: one GPIOA read, then one transaction that latches SCK high and
+// low back to back. 16 reads + 15 pulses + CS low/high = 33 transactions.
+// A failed bus access returns MAX6675_ERROR_VALUE so the sample counts as a
+// sensor error instead of a temperature built from garbage bits.
+uint16_t readMAX6675RawPort() {
+    const uint8_t idle = mcpPort.latch() & ~(1 << MCP_MAX6675_SCK);
+    const uint8_t selected = idle & ~(1 << MCP_MAX6675_CS);
+    const uint8_t pulse[2] = { (uint8_t)(selected | (1 << MCP_MAX6675_SCK)), selected };
+    uint16_t raw = 0;
+
+    bool ok = true;
+
+    // Pull CS low to stop conversion and present D15
+    ok = mcpPort.write(selected);
+
+    for (int i = 15; ok && i >= 0; i--) {
+        uint8_t pins = 0;
+        ok = mcpPort.readRegister(MCP_REG_GPIOA, pins);
+        if (pins & (1 << MCP_MAX6675_SO)) {
+            raw |= (uint16_t)(1 << i);
+        }
+        if (ok && i > 0) {
+            ok = mcpPort.writeSequence(pulse, 2);
+        }
+    }
+
+    // Pull CS high to start the next conversion (also after a failure)
+    if (!mcpPort.write(selected | (1 << MCP_MAX6675_CS))) {
+        ok = false;
+    }
+
+    return ok ? raw : (uint16_t)MAX6675_ERROR_VALUE;
+}
+
+// ========================================
+// Read MAX6675 via Per-Pin Library Calls (legacy)
+// ========================================
+uint16_t readMAX6675RawLegacy() {
     uint8_t byte1 = 0, byte2 = 0;
 
     // Pull CS low to start conversion
@@ -616,9 +1700,37 @@ uint16_t readMAX6675Raw() {
     // Combine bytes (MSB first)
     uint16_t raw = ((uint16_t)byte1 << 8) | byte2;
 
+    // Library calls bypass the port engine; account for them explicitly
+    mcpPort.addExternalTransactions(LEGACY_SAMPLE_TX);
+
     return raw;
 }
 
+// ========================================
+// Print MAX6675 I2C Cost
+// ========================================
+void printI2CStats() {
+    Serial.println("--- I2C / MAX6675 ---");
+    Serial.printf("I2C clock: %lukHz\n", (unsigned long)(i2cClockHz / 1000));
+    Serial.printf("Read path: %s\n", useLegacyBitBang ? "LEGACY per-pin" : "PORT batched");
+    Serial.printf("Total transactions: %lu (%lu failed)\n",
+                  (unsigned long)mcpPort.transactionCount(),
+                  (unsigned long)mcpPort.errorCount());
+
+    if (max6675Cost.samples == 0) {
+        Serial.println("No samples yet");
+    } else {
+        Serial.printf("Last sample: %lu transactions, %lu us\n",
+                      (unsigned long)max6675Cost.lastTransactions,
+                      (unsigned long)max6675Cost.lastMicros);
+        Serial.printf("Average (%lu samples): %.1f transactions, %.0f us\n",
+                      (unsigned long)max6675Cost.samples,
+                      (double)max6675Cost.totalTransactions / max6675Cost.samples,
+                      (double)max6675Cost.totalMicros / max6675Cost.samples);
+    }
+    Serial.println("---------------------");
+}
+
 // ========================================
 // Bit-Bang SPI Read
 // ========================================
@@ -654,111 +1766,279 @@ void bitBangSPI(uint8_t& byte1, uint8_t& byte2) {
 }
 
 // ========================================
-// Update Thermostat Logic
+// Update Thermostat Logic (PID / Autotune)
 // ========================================
+// Runs every CONTROL_INTERVAL_MS on the filtered temperature. Computes the
+// heater duty cycle; the relay itself is switched by updateRelayOutput() on
+// every loop pass.
 void updateThermostat() {
     unsigned long currentMillis = millis();
+    float dtSeconds = (lastPidUpdate == 0) ? 0.0f : (currentMillis - lastPidUpdate) / 1000.0f;
+    lastPidUpdate = currentMillis;
 
-    // Prevent rapid relay cycling
-    if (currentMillis - lastRelayChange < RELAY_MIN_CYCLE_TIME) {
-        unsigned long timeRemaining = (RELAY_MIN_CYCLE_TIME - (currentMillis - lastRelayChange)) / 1000;
-        Serial.printf("Relay cycling lockout: %lu seconds remaining\n", timeRemaining);
-        return;
-    }
-
-    // Cache volatile values for consistent logic within this function
     float localTemp = currentTemp;
     float localSetpoint = setpointTemp;
-    bool localHeaterOn = heaterOn;
 
-    // Thermostat logic with hysteresis
-    if (!localHeaterOn) {
-        // Turn on if temp falls below (setpoint - hysteresis)
-        float turnOnThreshold = localSetpoint - TEMP_HYSTERESIS_F;
-        if (localTemp < turnOnThreshold) {
-            setRelay(true);
-            lastRelayChange = currentMillis;
-            Serial.printf(">>> Heater ON: Temp %.1f°F < Threshold %.1f°F <<<\n",
-                         localTemp, turnOnThreshold);
-        } else {
-            Serial.printf("Heater OFF: Waiting for temp to drop below %.1f°F (currently %.1f°F)\n",
-                         turnOnThreshold, localTemp);
+    if (autotuner.getState() == RelayAutotuner::RUNNING) {
+        // Relay test: full on or full off, switched through the same window
+        uint8_t cyclesBefore = autotuner.getCyclesDone();
+        bool heat = autotuner.update(localTemp, currentMillis);
+        relayWindow.setDuty(heat ? 1.0f : 0.0f);
+        if (autotuner.getCyclesDone() != cyclesBefore) {
+            Serial.printf("Autotune: %d/%d cycles measured\n",
+                         autotuner.getCyclesDone(), AUTOTUNE_CYCLES);
         }
-    } else {
-        // Turn off if temp rises above (setpoint + hysteresis)
-        float turnOffThreshold = localSetpoint + TEMP_HYSTERESIS_F;
-        if (localTemp > turnOffThreshold) {
-            setRelay(false);
-            lastRelayChange = currentMillis;
-            Serial.printf(">>> Heater OFF: Temp %.1f°F > Threshold %.1f°F <<<\n",
-                         localTemp, turnOffThreshold);
-        } else {
-            Serial.printf("Heater ON: Waiting for temp to rise above %.1f°F (currently %.1f°F)\n",
-                         turnOffThreshold, localTemp);
+
+        if (autotuner.getState() == RelayAutotuner::DONE) {
+            pid.setGains(autotuner.getResult());
+            pid.reset();
+            savePidGains();
+            Serial.println(">>> Autotune complete <<<");
+            printPidStatus();
+        } else if (autotuner.getState() == RelayAutotuner::FAILED) {
+            Serial.println(">>> Autotune FAILED - keeping previous gains <<<");
         }
+        return;
+    }
+
+    relayWindow.setDuty(pid.update(localSetpoint, localTemp, dtSeconds));
+}
+
+// ========================================
+// Update Relay Output (time-proportioned)
+// ========================================
+void updateRelayOutput() {
+    unsigned long currentMillis = millis();
+    bool localHeaterOn = heaterOn;
+    bool want = relayWindow.decide(currentMillis, localHeaterOn, lastRelayChange);
+
+    if (want != localHeaterOn) {
+        setRelay(want);
+        lastRelayChange = currentMillis;
+        Serial.printf(">>> Heater %s (duty %.0f%%) <<<\n",
+                     want ? "ON" : "OFF", relayWindow.getDuty() * 100.0f);
     }
 }
 
+// ========================================
+// PID Gain Persistence (NVS)
+// ========================================
+void loadPidGains() {
+    preferences.begin(NVS_NAMESPACE, true);
+    PidGains gains;
+    gains.kp = preferences.getFloat(NVS_PID_KP_KEY, PID_DEFAULT_KP);
+    gains.ki = preferences.getFloat(NVS_PID_KI_KEY, PID_DEFAULT_KI);
+    gains.kd = preferences.getFloat(NVS_PID_KD_KEY, PID_DEFAULT_KD);
+    preferences.end();
+
+    pid.setGains(gains);
+    Serial.printf("PID gains loaded: Kp=%.4f Ki=%.6f Kd=%.3f\n", gains.kp, gains.ki, gains.kd);
+}
+
+void savePidGains() {
+    const PidGains& gains = pid.getGains();
+    preferences.begin(NVS_NAMESPACE, false);
+    preferences.putFloat(NVS_PID_KP_KEY, gains.kp);
+    preferences.putFloat(NVS_PID_KI_KEY, gains.ki);
+    preferences.putFloat(NVS_PID_KD_KEY, gains.kd);
+    preferences.end();
+    Serial.println("PID gains saved to NVS");
+}
+
+// ========================================
+// Autotune Start/Abort (serial 't')
+// ========================================
+void toggleAutotune() {
+    if (autotuner.getState() == RelayAutotuner::RUNNING) {
+        autotuner.abort();
+        pid.reset();
+        Serial.println("Autotune aborted");
+        return;
+    }
+
+    if (safetyShutdown) {
+        Serial.println("Cannot autotune during safety shutdown");
+        return;
+    }
+
+    autotuner.start(setpointTemp, AUTOTUNE_HYSTERESIS_F, AUTOTUNE_CYCLES,
+                    AUTOTUNE_TIMEOUT_MS, millis());
+    Serial.printf("Autotune started around %.1f°F (±%.1f°F, %d cycles)\n",
+                  setpointTemp, AUTOTUNE_HYSTERESIS_F, AUTOTUNE_CYCLES);
+}
+
+// ========================================
+// Print PID Status (serial 'p')
+// ========================================
+void printPidStatus() {
+    const PidGains& gains = pid.getGains();
+    Serial.println("--- PID ---");
+    Serial.printf("Gains: Kp=%.4f Ki=%.6f Kd=%.3f\n", gains.kp, gains.ki, gains.kd);
+    Serial.printf("Output: %.0f%% (integral %.0f%%)\n",
+                  pid.getOutput() * 100.0f, pid.getIntegral() * 100.0f);
+    Serial.printf("Window: %lus, on-time %lus, min cycle %ds\n",
+                  (unsigned long)(PID_WINDOW_MS / 1000),
+                  (unsigned long)(relayWindow.onTimeMs() / 1000),
+                  RELAY_MIN_CYCLE_TIME / 1000);
+
+    const char* stateNames[] = {"IDLE", "RUNNING", "DONE", "FAILED"};
+    Serial.printf("Autotune: %s (%d cycles)\n",
+                  stateNames[autotuner.getState()], autotuner.getCyclesDone());
+    Serial.println("-----------");
+}
+
 // ========================================
 // Update Display
 // ========================================
+// Each field diffs against what is already on the panel, so a frame where
+// nothing changed pushes zero bytes over SPI.
 void updateDisplay() {
-    // Cache volatile values
-    float localTemp = currentTemp;
-    float localSetpoint = setpointTemp;
-    bool localHeaterOn = heaterOn;
-    bool localSensorError = sensorError;
-    bool localSafetyShutdown = safetyShutdown;
+    unsigned long frameStart = micros();
+    uint32_t bytes = 0;
+
+    // One consistent snapshot from the control task
+    HeaterState state = heaterState.read();
+    float localTemp = state.currentTemp;
+    float localSetpoint = state.setpointTemp;
+    bool localHeaterOn = state.heaterOn;
+    bool localSensorError = state.sensorError;
+    bool localSafetyShutdown = state.safetyShutdown;
     bool localBleConnected = deviceConnected;
 
     // Temperature display
-    tft.fillRect(0, 75, 480, 60, COLOR_BG);
-    tft.setTextColor(localSensorError ? COLOR_TEMP_HIGH : COLOR_TEMP_NORMAL, COLOR_BG);
-    tft.setTextSize(3);
-    tft.setTextDatum(MC_DATUM);
-
     if (localSensorError) {
-        tft.drawString("ERROR", 240, 100);
+        bytes += tempField.draw("ERROR", COLOR_TEMP_HIGH, COLOR_BG);
     } else {
         snprintf(displayBuffer, sizeof(displayBuffer), "%.1f F", localTemp);
-        tft.drawString(displayBuffer, 240, 100);
+        bytes += tempField.draw(displayBuffer, COLOR_TEMP_NORMAL, COLOR_BG);
     }
 
     // Setpoint display
-    tft.fillRect(0, 130, 480, 40, COLOR_BG);
-    tft.setTextColor(COLOR_SETPOINT, COLOR_BG);
-    tft.setTextSize(2);
     snprintf(displayBuffer, sizeof(displayBuffer), "Set: %.1f F", localSetpoint);
-    tft.drawString(displayBuffer, 240, 145);
+    bytes += setpointField.draw(displayBuffer, COLOR_SETPOINT, COLOR_BG);
+    recordTouchLatency(localSetpoint);
 
     // Heater status
-    tft.fillRect(0, 165, 480, 30, COLOR_BG);
-    tft.setTextColor(localHeaterOn ? COLOR_HEATER_ON : COLOR_HEATER_OFF, COLOR_BG);
-    tft.setTextSize(2);
-
     if (localSafetyShutdown) {
-        tft.setTextColor(COLOR_TEMP_HIGH, COLOR_BG);
-        tft.drawString("SAFETY SHUTDOWN!", 240, 180);
+        bytes += statusField.draw("SAFETY SHUTDOWN!", COLOR_TEMP_HIGH, COLOR_BG);
+    } else if (localHeaterOn) {
+        bytes += statusField.draw("HEATER ON", COLOR_HEATER_ON, COLOR_BG);
     } else {
-        tft.drawString(localHeaterOn ? "HEATER ON" : "HEATER OFF", 240, 180);
+        bytes += statusField.draw("HEATER OFF", COLOR_HEATER_OFF, COLOR_BG);
     }
 
-    // BLE connection status (only update if changed to reduce flicker)
-    if (localBleConnected != lastDisplayedBleState) {
-        tft.fillRect(0, 295, 480, 25, COLOR_BG);
-        tft.setTextSize(1);
-        tft.setTextDatum(MC_DATUM);
-        
-        if (localBleConnected) {
-            tft.setTextColor(TFT_GREEN, COLOR_BG);
-            tft.drawString("BLE: CONNECTED", 240, 305);
+    // BLE connection status
+    if (localBleConnected) {
+        bytes += bleField.draw("BLE: CONNECTED", TFT_GREEN, COLOR_BG);
+    } else {
+        bytes += bleField.draw("BLE: DISCONNECTED", TFT_DARKGREY, COLOR_BG);
+    }
+
+    // Heat-up ETA, or the preheat schedule while one is armed or being edited
+    char clock[8];
+    if (scheduleEditing) {
+        formatClock(scheduleEditMinutes * 60UL, clock, sizeof(clock));
+        snprintf(displayBuffer, sizeof(displayBuffer), "READY %s?", clock);
+        bytes += etaField.draw(displayBuffer, COLOR_SETPOINT, COLOR_BG);
+    } else if (millis() < scheduleMessageUntil) {
+        bytes += etaField.draw("NO CLOCK", COLOR_TEMP_HIGH, COLOR_BG);
+    } else if (state.preheatState == PreheatScheduler::WAITING_FOR_CLOCK) {
+        bytes += etaField.draw("NEED CLOCK", COLOR_SETPOINT, COLOR_BG);
+    } else if (state.preheatState == PreheatScheduler::STANDBY) {
+        formatClock(state.preheatStart, clock, sizeof(clock));
+        snprintf(displayBuffer, sizeof(displayBuffer), "START %s", clock);
+        bytes += etaField.draw(displayBuffer, COLOR_HEATER_OFF, COLOR_BG);
+    } else {
+        formatEta(state.etaSeconds, displayBuffer, sizeof(displayBuffer));
+        bytes += etaField.draw(displayBuffer, COLOR_TEXT, COLOR_BG);
+    }
+
+    // Trend chart (pushes only when a new history sample arrived)
+    bytes += updateTrendChart();
+
+    // Frame statistics
+    uint32_t frameMicros = micros() - frameStart;
+    renderStats.frames++;
+    if (bytes == 0) {
+        renderStats.idleFrames++;
+    }
+    renderStats.lastFrameBytes = bytes;
+    renderStats.lastFrameMicros = frameMicros;
+    renderStats.totalBytes += bytes;
+    if (bytes > renderStats.maxFrameBytes) renderStats.maxFrameBytes = bytes;
+    if (frameMicros > renderStats.maxFrameMicros) renderStats.maxFrameMicros = frameMicros;
+}
+
+// ========================================
+// Update Trend Chart (UI task)
+// ========================================
+// Plots history samples the chart has not seen yet. Every
+// CHART_SAMPLES_PER_COLUMN samples start a new column (one-pixel scroll);
+// samples in between widen the current column's min..max bar.
+uint32_t updateTrendChart() {
+    int16_t samples[CHART_SAMPLES_PER_COLUMN * 4];
+
+    portENTER_CRITICAL(&historyLock);
+    uint32_t from = chartNextIndex;
+    uint16_t count = history.copy(from, samples, sizeof(samples) / sizeof(samples[0]));
+    portEXIT_CRITICAL(&historyLock);
+
+    if (count == 0) {
+        return 0;
+    }
+
+    float setpoint = heaterState.read().setpointTemp;
+    for (uint16_t i = 0; i < count; i++) {
+        float tempF = TempHistory<HISTORY_CAPACITY>::decodeTemp(samples[i]);
+        bool heated = TempHistory<HISTORY_CAPACITY>::decodeRelay(samples[i]);
+        bool newColumn = ((from + i) % CHART_SAMPLES_PER_COLUMN) == 0;
+
+        if (newColumn) {
+            chartColumnLow = tempF;
+            chartColumnHigh = tempF;
+            chartColumnHeated = heated;
         } else {
-            tft.setTextColor(TFT_DARKGREY, COLOR_BG);
-            tft.drawString("BLE: DISCONNECTED", 240, 305);
+            if (tempF < chartColumnLow) chartColumnLow = tempF;
+            if (tempF > chartColumnHigh) chartColumnHigh = tempF;
+            chartColumnHeated |= heated;
         }
-        
-        lastDisplayedBleState = localBleConnected;
+        trendChart.plot(chartColumnLow, chartColumnHigh, setpoint, chartColumnHeated, newColumn);
+    }
+    chartNextIndex = from + count;
+
+    return trendChart.push();
+}
+
+// ========================================
+// Print Render Stats (serial 'r')
+// ========================================
+void printRenderStats() {
+    Serial.println("--- Display ---");
+    Serial.printf("Frames: %lu (%lu idle, no SPI traffic)\n",
+                  (unsigned long)renderStats.frames, (unsigned long)renderStats.idleFrames);
+    Serial.printf("Last frame: %lu bytes, %lu us\n",
+                  (unsigned long)renderStats.lastFrameBytes,
+                  (unsigned long)renderStats.lastFrameMicros);
+    Serial.printf("Max frame: %lu bytes, %lu us\n",
+                  (unsigned long)renderStats.maxFrameBytes,
+                  (unsigned long)renderStats.maxFrameMicros);
+    if (renderStats.frames > 0) {
+        Serial.printf("Average: %.0f bytes/frame\n",
+                      (double)renderStats.totalBytes / renderStats.frames);
+    }
+    Serial.printf("Touch: %lu pen IRQs, %lu SPI reads\n",
+                  (unsigned long)touchStats.irqs, (unsigned long)touchStats.spiReads);
+    if (touchStats.latencySamples > 0) {
+        Serial.printf("Touch-to-redraw: last %lu us, min %lu us, avg %lu us, max %lu us (%lu samples)\n",
+                      (unsigned long)touchStats.lastLatencyUs,
+                      (unsigned long)touchStats.minLatencyUs,
+                      (unsigned long)(touchStats.totalLatencyUs / touchStats.latencySamples),
+                      (unsigned long)touchStats.maxLatencyUs,
+                      (unsigned long)touchStats.latencySamples);
     }
+    Serial.println("---------------");
+    renderStats = {};
+    touchStats = {};
 }
 
 // ========================================
@@ -786,8 +2066,22 @@ void drawUI() {
     drawButton(BUTTON_UP_X, BUTTON_UP_Y, BUTTON_WIDTH, BUTTON_HEIGHT, "UP", COLOR_BUTTON);
     drawButton(BUTTON_DOWN_X, BUTTON_DOWN_Y, BUTTON_WIDTH, BUTTON_HEIGHT, "DOWN", COLOR_BUTTON);
 
-    // Force BLE status to redraw
-    lastDisplayedBleState = !deviceConnected;
+    // Screen was cleared - every field must be pushed again
+    tempField.invalidate();
+    setpointField.invalidate();
+    statusField.invalidate();
+    bleField.invalidate();
+    etaField.invalidate();
+
+    // Trend chart scale labels; the chart sprite keeps its contents
+    tft.setTextSize(1);
+    tft.setTextColor(TFT_DARKGREY, COLOR_BG);
+    tft.setTextDatum(TR_DATUM);
+    tft.drawString("300F", CHART_X - 4, CHART_Y);
+    // Below the chart's bottom-left corner: left of it is the UP button
+    tft.setTextDatum(TL_DATUM);
+    tft.drawString("50F", CHART_X, CHART_Y + CHART_HEIGHT + 2);
+    trendChart.push();
 
     // Update display content
     updateDisplay();
@@ -830,92 +2124,240 @@ void handleButtonFeedback() {
     }
 }
 
+// ========================================
+// Touch Initialization
+// ========================================
+void initTouch() {
+    pinMode(TOUCH_IRQ, INPUT);  // GPIO36 is input-only; the pull-up is on the board
+    attachInterrupt(digitalPinToInterrupt(TOUCH_IRQ), onTouchIrq, FALLING);
+    Serial.printf("Touch IRQ attached on GPIO%d\n", TOUCH_IRQ);
+}
+
+// ========================================
+// Touch Pen IRQ (ISR)
+// ========================================
+// Also fires while the XPT2046 is converting; it is only a wake-up hint.
+void IRAM_ATTR onTouchIrq() {
+    if (touchReading.load()) {
+        return;  // Our own conversion, not the pen
+    }
+    if (!touchIrqFlag.load()) {
+        touchIrqUs = micros();
+    }
+    touchIrqFlag.store(true);
+
+    BaseType_t woken = pdFALSE;
+    if (uiTaskHandle != nullptr) {
+        vTaskNotifyGiveFromISR(uiTaskHandle, &woken);
+    }
+    portYIELD_FROM_ISR(woken);
+}
+
 // ========================================
 // Handle Touch Input
 // ========================================
+// Idle until the pen interrupt fires, then sample every TOUCH_SAMPLE_MS
+// until the gesture detector sees a release and the pen line is high again.
 void handleTouch() {
-    uint16_t touchX = 0, touchY = 0;
-
-    // Check if screen is being touched (TFT_eSPI built-in touch)
-    bool touched = tft.getTouch(&touchX, &touchY, 300);  // 300 = pressure threshold
+    bool irq = touchIrqFlag.exchange(false);
+    if (!touchSampling) {
+        // An edge with the line already back high was a conversion
+        // settling, not a press
+        if (!irq || digitalRead(TOUCH_IRQ) != LOW) {
+            return;  // No SPI traffic while the panel is untouched
+        }
+        touchStats.irqs++;
+    }
 
-    // If not touched, reset touch state and return
-    if (!touched) {
-        wasTouched = false;
+    unsigned long currentMillis = millis();
+    if (touchSampling && currentMillis - lastTouchSample < TOUCH_SAMPLE_MS) {
         return;
     }
+    lastTouchSample = currentMillis;
 
-    // Only trigger on new press (ignore hold)
-    if (wasTouched) {
+    uint16_t touchX = 0, touchY = 0;
+    touchReading.store(true);
+    bool touched = tft.getTouch(&touchX, &touchY, TOUCH_PRESSURE_THRESHOLD);
+    touchReading.store(false);
+    touchIrqFlag.store(false);  // Edges from this read's conversions
+    touchStats.spiReads++;
+
+    TouchEvent event = touchGestures.update(touched, touchX, touchY, currentMillis);
+    touchSampling = touchGestures.isActive() || digitalRead(TOUCH_IRQ) == LOW;
+
+    bool onUp = event.x >= BUTTON_UP_X && event.x <= (BUTTON_UP_X + BUTTON_WIDTH) &&
+                event.y >= BUTTON_UP_Y && event.y <= (BUTTON_UP_Y + BUTTON_HEIGHT);
+    bool onDown = event.x >= BUTTON_DOWN_X && event.x <= (BUTTON_DOWN_X + BUTTON_WIDTH) &&
+                  event.y >= BUTTON_DOWN_Y && event.y <= (BUTTON_DOWN_Y + BUTTON_HEIGHT);
+    bool onSchedule = event.x >= SCHEDULE_TOUCH_X && event.x <= (SCHEDULE_TOUCH_X + SCHEDULE_TOUCH_W) &&
+                      event.y >= SCHEDULE_TOUCH_Y && event.y <= (SCHEDULE_TOUCH_Y + SCHEDULE_TOUCH_H);
+
+    // Schedule field: tap to edit the ready time, tap again to arm it
+    if (event.type == TOUCH_PRESS && onSchedule) {
+        handleScheduleTap(currentMillis);
         return;
     }
-    wasTouched = true;
 
-    unsigned long currentMillis = millis();
-
-    // Debounce (still useful for very fast repeated taps)
-    if (currentMillis - lastTouchTime < TOUCH_DEBOUNCE_MS) {
+    // While editing, UP/DOWN move the ready time instead of the setpoint
+    if (scheduleEditing && (event.type == TOUCH_PRESS || event.type == TOUCH_REPEAT) &&
+        (onUp || onDown)) {
+        int16_t step = onUp ? PREHEAT_EDIT_STEP_MIN : -PREHEAT_EDIT_STEP_MIN;
+        scheduleEditMinutes = (scheduleEditMinutes + step + 1440) % 1440;
+        lastScheduleTouch = currentMillis;
+        forceDisplayUpdate = true;
+
+        drawButton(onUp ? BUTTON_UP_X : BUTTON_DOWN_X, BUTTON_Y_POS, BUTTON_WIDTH, BUTTON_HEIGHT,
+                   onUp ? "UP" : "DOWN", TFT_GREEN);
+        buttonFeedbackStart = currentMillis;
+        buttonFeedbackActive = true;
+        activeButton = onUp ? 1 : 2;
         return;
     }
 
-    // Cache volatile values
-    float localSetpoint = setpointTemp;
+    switch (event.type) {
+        case TOUCH_PRESS:
+        case TOUCH_REPEAT: {
+            // A press is timed from the pen interrupt, a repeat from its sample
+            uint32_t startUs = (event.type == TOUCH_PRESS && irq) ? touchIrqUs : micros();
+
+            if (onUp && touchAdjustSetpoint(SETPOINT_INCREMENT, startUs)) {
+                drawButton(BUTTON_UP_X, BUTTON_UP_Y, BUTTON_WIDTH, BUTTON_HEIGHT, "UP", TFT_GREEN);
+                buttonFeedbackStart = currentMillis;
+                buttonFeedbackActive = true;
+                activeButton = 1;
+            } else if (onDown && touchAdjustSetpoint(-SETPOINT_INCREMENT, startUs)) {
+                drawButton(BUTTON_DOWN_X, BUTTON_DOWN_Y, BUTTON_WIDTH, BUTTON_HEIGHT, "DOWN", TFT_GREEN);
+                buttonFeedbackStart = currentMillis;
+                buttonFeedbackActive = true;
+                activeButton = 2;
+            }
+            break;
+        }
 
-    // Check if UP button pressed
-    if (touchX >= BUTTON_UP_X && touchX <= (BUTTON_UP_X + BUTTON_WIDTH) &&
-        touchY >= BUTTON_UP_Y && touchY <= (BUTTON_UP_Y + BUTTON_HEIGHT)) {
+        case TOUCH_SWIPE:
+            // Swipes started on a button were already handled as a press
+            if (!onUp && !onDown) {
+                if (event.direction == SWIPE_UP) {
+                    touchAdjustSetpoint(TOUCH_SWIPE_STEP_F, micros());
+                } else if (event.direction == SWIPE_DOWN) {
+                    touchAdjustSetpoint(-TOUCH_SWIPE_STEP_F, micros());
+                } else {
+                    // Sideways swipe cancels the preheat schedule
+                    scheduleEditing = false;
+                    postCommand(CMD_PREHEAT_CANCEL, 0.0f);
+                    forceDisplayUpdate = true;
+                    Serial.println("Touch: preheat schedule cancel");
+                }
+            }
+            break;
 
-        if (localSetpoint < MAX_SETPOINT_F) {
-            setpointTemp = localSetpoint + SETPOINT_INCREMENT;
-            Serial.printf("UP button pressed! Setpoint increased to %.1f°F\n", setpointTemp);
+        default:
+            break;
+    }
+}
 
-            // Start non-blocking button feedback
-            drawButton(BUTTON_UP_X, BUTTON_UP_Y, BUTTON_WIDTH, BUTTON_HEIGHT, "UP", TFT_GREEN);
-            buttonFeedbackStart = currentMillis;
-            buttonFeedbackActive = true;
-            activeButton = 1;
+// ========================================
+// Schedule Field Tap
+// ========================================
+void handleScheduleTap(unsigned long currentMillis) {
+    lastScheduleTouch = currentMillis;
+    forceDisplayUpdate = true;
 
-            // Force immediate display update
-            forceDisplayUpdate = true;
+    if (scheduleEditing) {
+        scheduleEditing = false;
+        postCommand(CMD_PREHEAT_ARM, scheduleEditMinutes);
+        return;
+    }
 
-            // Try to reset safety shutdown if conditions allow
-            tryResetSafetyShutdown();
-        }
+    uint32_t now = wallClockNow();
+    if (now == 0) {
+        scheduleMessageUntil = currentMillis + 2000;
+        return;
+    }
 
-        lastTouchTime = currentMillis;
+    // Start from the armed time, or an hour from now rounded up to the step
+    HeaterState state = heaterState.read();
+    if (state.preheatState != PreheatScheduler::IDLE) {
+        scheduleEditMinutes = (state.preheatReady / 60) % 1440;
+    } else {
+        uint32_t minutes = (now / 60) % 1440 + 60 + PREHEAT_EDIT_STEP_MIN - 1;
+        scheduleEditMinutes = (minutes / PREHEAT_EDIT_STEP_MIN * PREHEAT_EDIT_STEP_MIN) % 1440;
     }
+    scheduleEditing = true;
+}
 
-    // Check if DOWN button pressed
-    else if (touchX >= BUTTON_DOWN_X && touchX <= (BUTTON_DOWN_X + BUTTON_WIDTH) &&
-             touchY >= BUTTON_DOWN_Y && touchY <= (BUTTON_DOWN_Y + BUTTON_HEIGHT)) {
+// ========================================
+// Touch Setpoint Change
+// ========================================
+// The control task clamps and applies the change; the snapshot is checked
+// only to decide whether the touch does anything.
+bool touchAdjustSetpoint(float step, uint32_t startUs) {
+    float localSetpoint = heaterState.read().setpointTemp;
+    if ((step > 0.0f && localSetpoint >= MAX_SETPOINT_F) ||
+        (step < 0.0f && localSetpoint <= MIN_SETPOINT_F)) {
+        return false;
+    }
+    if (!postCommand(CMD_ADJUST_SETPOINT, step)) {
+        return false;
+    }
 
-        if (localSetpoint > MIN_SETPOINT_F) {
-            setpointTemp = localSetpoint - SETPOINT_INCREMENT;
-            Serial.printf("DOWN button pressed! Setpoint decreased to %.1f°F\n", setpointTemp);
+    Serial.printf("Touch: setpoint %+.0f°F\n", step);
 
-            // Start non-blocking button feedback
-            drawButton(BUTTON_DOWN_X, BUTTON_DOWN_Y, BUTTON_WIDTH, BUTTON_HEIGHT, "DOWN", TFT_GREEN);
-            buttonFeedbackStart = currentMillis;
-            buttonFeedbackActive = true;
-            activeButton = 2;
+    // Time only the first change of a burst; repeats just keep it going
+    if (!latencyPending) {
+        latencyPending = true;
+        latencyStartUs = startUs;
+        latencyFromSetpoint = localSetpoint;
+    }
+    return true;
+}
 
-            // Force immediate display update
-            forceDisplayUpdate = true;
+// ========================================
+// Touch-to-Redraw Latency (after the setpoint field is drawn)
+// ========================================
+void recordTouchLatency(float shownSetpoint) {
+    if (!latencyPending) {
+        return;
+    }
 
-            // Try to reset safety shutdown if conditions allow
-            tryResetSafetyShutdown();
+    uint32_t latency = micros() - latencyStartUs;
+    if (shownSetpoint == latencyFromSetpoint) {
+        // Not applied yet (or rejected); give up eventually
+        if (latency > TOUCH_LATENCY_TIMEOUT_MS * 1000UL) {
+            latencyPending = false;
         }
+        return;
+    }
 
-        lastTouchTime = currentMillis;
+    latencyPending = false;
+    touchStats.lastLatencyUs = latency;
+    if (touchStats.latencySamples == 0 || latency < touchStats.minLatencyUs) {
+        touchStats.minLatencyUs = latency;
     }
+    if (latency > touchStats.maxLatencyUs) {
+        touchStats.maxLatencyUs = latency;
+    }
+    touchStats.totalLatencyUs += latency;
+    touchStats.latencySamples++;
 }
 
 // ========================================
 // Set Relay State
 // ========================================
+// The fault paths call this on every sample to hold the relay off, so the
+// pin is always rewritten but only a change (or the first failed write) is
+// logged. Every failed write is counted in the stats line.
 void setRelay(bool state) {
+    static bool lastWriteFailed = false;
+    bool changed = (state != heaterOn);
     heaterOn = state;
     // Relay is active HIGH (ON=HIGH, OFF=LOW)
-    mcp.digitalWrite(MCP_RELAY_PIN, state ? HIGH : LOW);
-    Serial.printf("Relay set to %s\n", state ? "ON" : "OFF");
+    bool failed = !mcpPort.writePin(MCP_RELAY_PIN, state);
+    if (failed && !lastWriteFailed) {
+        Serial.printf("ERROR: relay %s write not acknowledged\n", state ? "ON" : "OFF");
+    }
+    lastWriteFailed = failed;
+    if (changed) {
+        Serial.printf("Relay set to %s\n", state ? "ON" : "OFF");
+    }
 }
@@ -0,0 +1,189 @@
+// Host tests for HeatupEstimator, replaying simulated heater traces at the
+// firmware's estimator period (pio test -e native)
+
+#include <stdio.h>
+#include <unity.h>
+#include "config.h"
+#include "heatup_estimator.h"
+
+// ========================================
+// Trace source
+// ========================================
+// First-order sump: dT/dt = rate·u - (T - ambient) / tau (°F per minute).
+// Readings are what updateEstimator() sees: MAX6675 counts (0.25°C, i.e.
+// 0.45°F) with a count of noise, averaged over the last four samples.
+struct SumpTrace {
+    float ratePerMin;
+    float tauMin;
+    float ambientF;
+
+    float tempF;
+    uint32_t noise = 12345;
+    float window[4];
+    uint8_t index = 0;
+
+    SumpTrace(float rate, float tau, float ambient)
+        : ratePerMin(rate), tauMin(tau), ambientF(ambient), tempF(ambient) {
+        for (uint8_t i = 0; i < 4; i++) window[i] = ambient;
+    }
+
+    // One SAMPLE_INTERVAL_MS step with the relay in state on; returns the
+    // smoothed reading
+    float step(bool on) {
+        const float dtMin = SAMPLE_INTERVAL_MS / 60000.0f;
+        tempF += ((on ? ratePerMin : 0.0f) - (tempF - ambientF) / tauMin) * dtMin;
+
+        noise = noise * 1103515245u + 12345u;
+        int counts = (int)((tempF - 32.0f) * 5.0f / 9.0f * 4.0f + 0.5f) + (int)((noise >> 16) % 3) - 1;
+        window[index] = counts * 0.25f * 9.0f / 5.0f + 32.0f;
+        index = (index + 1) % 4;
+        return (window[0] + window[1] + window[2] + window[3]) / 4.0f;
+    }
+
+    float fullPowerSteadyF() const { return ambientF + ratePerMin * tauMin; }
+};
+
+// Feeds the estimator exactly as updateEstimator() does: one observation per
+// ESTIMATOR_INTERVAL_MS with the relay-on fraction as duty
+struct EstimatorFeed {
+    HeatupEstimator& estimator;
+    uint32_t elapsedMs = 0;
+    uint32_t onMs = 0;
+    float startF;
+    float lastF;
+
+    EstimatorFeed(HeatupEstimator& e, float initialF) : estimator(e), startF(initialF), lastF(initialF) {}
+
+    void sample(float readingF, bool relayOn) {
+        lastF = readingF;
+        elapsedMs += SAMPLE_INTERVAL_MS;
+        if (relayOn) onMs += SAMPLE_INTERVAL_MS;
+        if (elapsedMs >= ESTIMATOR_INTERVAL_MS) {
+            estimator.update(startF, readingF, (float)onMs / elapsedMs, elapsedMs / 1000.0f);
+            startF = readingF;
+            elapsedMs = 0;
+            onMs = 0;
+        }
+    }
+};
+
+static const uint32_t SAMPLES_PER_MIN = 60000 / SAMPLE_INTERVAL_MS;
+
+void setUp(void) {}
+void tearDown(void) {}
+
+// Full-power heat-up: after ten minutes of learning, the ETA to setpoint
+// must match the time the trace actually takes
+void test_eta_during_cold_heatup(void) {
+    SumpTrace sump(8.0f, 20.0f, 70.0f);
+    HeatupEstimator estimator;
+    EstimatorFeed feed(estimator, sump.tempF);
+
+    for (uint32_t i = 0; i < 10 * SAMPLES_PER_MIN; i++) {
+        feed.sample(sump.step(true), true);
+    }
+    TEST_ASSERT_TRUE(estimator.isValid());
+
+    float predictedS = estimator.etaSeconds(feed.lastF, DEFAULT_SETPOINT_F);
+    TEST_ASSERT_GREATER_THAN_FLOAT(0.0f, predictedS);
+
+    uint32_t actualSamples = 0;
+    while (sump.tempF < DEFAULT_SETPOINT_F && actualSamples < 120 * SAMPLES_PER_MIN) {
+        sump.step(true);
+        actualSamples++;
+    }
+    float actualS = actualSamples * SAMPLE_INTERVAL_MS / 1000.0f;
+
+    char msg[80];
+    snprintf(msg, sizeof(msg), "ETA predicted %.0fs, actual %.0fs", predictedS, actualS);
+    TEST_MESSAGE(msg);
+    TEST_ASSERT_FLOAT_WITHIN(0.2f * actualS, actualS, predictedS);
+}
+
+// Heat-up, an hour holding setpoint with the relay cycling, then cooling
+// with the heater off: all three parameters become identifiable
+void test_learns_model_from_heat_hold_cool(void) {
+    SumpTrace sump(8.0f, 20.0f, 70.0f);
+    HeatupEstimator estimator;
+    EstimatorFeed feed(estimator, sump.tempF);
+    float reading = sump.tempF;
+    bool relay = true;
+
+    for (uint32_t i = 0; i < 150 * SAMPLES_PER_MIN; i++) {
+        if (i < 90 * SAMPLES_PER_MIN) {
+            // Thermostat with 1°F hysteresis, then natural cooling
+            if (reading > DEFAULT_SETPOINT_F + 1.0f) relay = false;
+            if (reading < DEFAULT_SETPOINT_F - 1.0f) relay = true;
+        } else {
+            relay = false;
+        }
+        reading = sump.step(relay);
+        feed.sample(reading, relay);
+    }
+
+    char msg[96];
+    snprintf(msg, sizeof(msg), "rate %.2fF/min tau %.1fmin ambient %.1fF",
+             estimator.heatingRate(), estimator.timeConstantMinutes(), estimator.ambientF());
+    TEST_MESSAGE(msg);
+    TEST_ASSERT_TRUE(estimator.isValid());
+    TEST_ASSERT_FLOAT_WITHIN(8.0f * 0.2f, 8.0f, estimator.heatingRate());
+    TEST_ASSERT_FLOAT_WITHIN(20.0f * 0.25f, 20.0f, estimator.timeConstantMinutes());
+    TEST_ASSERT_FLOAT_WITHIN(10.0f, 70.0f, estimator.ambientF());
+    TEST_ASSERT_FLOAT_WITHIN(15.0f, sump.fullPowerSteadyF(), estimator.steadyStateF(1.0f));
+}
+
+// A heater that levels off below the setpoint reports unreachable, not a time
+void test_weak_heater_is_unreachable(void) {
+    SumpTrace sump(4.0f, 20.0f, 70.0f);      // Full power settles at 150°F
+    HeatupEstimator estimator;
+    EstimatorFeed feed(estimator, sump.tempF);
+
+    for (uint32_t i = 0; i < 30 * SAMPLES_PER_MIN; i++) {
+        feed.sample(sump.step(true), true);
+    }
+    TEST_ASSERT_TRUE(estimator.isValid());
+    TEST_ASSERT_EQUAL(HeatupEstimator::ETA_UNREACHABLE,
+                      (int)estimator.etaSeconds(feed.lastF, DEFAULT_SETPOINT_F));
+}
+
+void test_unknown_until_warmed_up(void) {
+    HeatupEstimator estimator;
+    TEST_ASSERT_EQUAL(HeatupEstimator::ETA_UNKNOWN, (int)estimator.etaSeconds(100.0f, DEFAULT_SETPOINT_F));
+    TEST_ASSERT_EQUAL(0, (int)estimator.etaSeconds(DEFAULT_SETPOINT_F, DEFAULT_SETPOINT_F));
+}
+
+void test_model_round_trip_and_rejects_corrupt(void) {
+    SumpTrace sump(8.0f, 20.0f, 70.0f);
+    HeatupEstimator estimator;
+    EstimatorFeed feed(estimator, sump.tempF);
+    for (uint32_t i = 0; i < 10 * SAMPLES_PER_MIN; i++) {
+        feed.sample(sump.step(true), true);
+    }
+
+    HeatupEstimator::Model model;
+    estimator.exportModel(model);
+    HeatupEstimator restored;
+    TEST_ASSERT_TRUE(restored.importModel(model));
+    TEST_ASSERT_EQUAL(estimator.getUpdates(), restored.getUpdates());
+    TEST_ASSERT_EQUAL_FLOAT(estimator.etaSeconds(100.0f, DEFAULT_SETPOINT_F),
+                            restored.etaSeconds(100.0f, DEFAULT_SETPOINT_F));
+
+    HeatupEstimator::Model corrupt = model;
+    corrupt.theta[1] = NAN;
+    HeatupEstimator untouched;
+    TEST_ASSERT_FALSE(untouched.importModel(corrupt));
+    corrupt = model;
+    corrupt.version = HeatupEstimator::MODEL_VERSION + 1;
+    TEST_ASSERT_FALSE(untouched.importModel(corrupt));
+    TEST_ASSERT_EQUAL(0, untouched.getUpdates());
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_eta_during_cold_heatup);
+    RUN_TEST(test_learns_model_from_heat_hold_cool);
+    RUN_TEST(test_weak_heater_is_unreachable);
+    RUN_TEST(test_unknown_until_warmed_up);
+    RUN_TEST(test_model_round_trip_and_rejects_corrupt);
+    return UNITY_END();
+}
@@ -0,0 +1,162 @@
+// Host tests for PidController / TimeProportionalOutput / RelayAutotuner
+// against a first-order-plus-dead-time model of the oil sump
+// (pio test -e native)
+
+#include <stdio.h>
+#include <unity.h>
+#include "config.h"
+#include "pid_controller.h"
+
+// ========================================
+// FOPDT plant
+// ========================================
+// dT/dt = (GAIN * u(t - DEAD_TIME) - (T - AMBIENT)) / TAU, u = relay 0/1.
+// Roughly a 1 kW element on a few litres of oil: 70 -> 180°F in ~20 min.
+struct SumpModel {
+    static constexpr float AMBIENT_F = 70.0f;
+    static constexpr float GAIN_F = 250.0f;         // Full-on rise above ambient
+    static constexpr float TAU_S = 1200.0f;
+    static constexpr uint32_t DEAD_TIME_S = 45;
+    static constexpr uint32_t DELAY_SLOTS = DEAD_TIME_S + 1;
+
+    float tempF = AMBIENT_F;
+    bool history[DELAY_SLOTS] = {};
+    uint32_t head = 0;
+
+    // Advance one second with the relay in state on
+    float step(bool on) {
+        history[head] = on;
+        head = (head + 1) % DELAY_SLOTS;
+        float u = history[head] ? 1.0f : 0.0f;     // Input from DEAD_TIME_S ago
+        tempF += (GAIN_F * u - (tempF - AMBIENT_F)) / TAU_S;
+        return tempF;
+    }
+};
+
+struct StepResponse {
+    float overshootF;
+    uint32_t settleS;       // Last time outside the band
+    uint32_t relaySwitches;
+};
+
+static const float SETPOINT_F = DEFAULT_SETPOINT_F;
+static const float SETTLE_BAND_F = 3.0f;
+static const uint32_t RUN_S = 3 * 3600;
+
+// Closed loop as in updateThermostat() / updateRelayOutput(): PID once per
+// CONTROL_INTERVAL_MS (1 s), relay through the time-proportioning window
+static StepResponse runStep(const PidGains& gains) {
+    SumpModel plant;
+    PidController pid;
+    TimeProportionalOutput window(PID_WINDOW_MS, RELAY_MIN_CYCLE_TIME);
+    pid.setGains(gains);
+    pid.setDerivativeFilter(PID_DERIVATIVE_FILTER_S);
+    window.restart(0);
+
+    StepResponse r = {0.0f, 0, 0};
+    bool relay = false;
+    uint32_t lastChangeMs = 0;
+    float temp = plant.tempF;
+
+    for (uint32_t s = 0; s < RUN_S; s++) {
+        uint32_t nowMs = s * CONTROL_INTERVAL_MS;
+        window.setDuty(pid.update(SETPOINT_F, temp, CONTROL_INTERVAL_MS / 1000.0f));
+        bool want = window.decide(nowMs, relay, lastChangeMs);
+        if (want != relay) {
+            relay = want;
+            lastChangeMs = nowMs;
+            r.relaySwitches++;
+        }
+        temp = plant.step(relay);
+
+        if (temp - SETPOINT_F > r.overshootF) {
+            r.overshootF = temp - SETPOINT_F;
+        }
+        if (fabsf(temp - SETPOINT_F) > SETTLE_BAND_F) {
+            r.settleS = s + 1;
+        }
+    }
+    return r;
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_default_gains_step_response(void) {
+    PidGains gains = {PID_DEFAULT_KP, PID_DEFAULT_KI, PID_DEFAULT_KD};
+    StepResponse r = runStep(gains);
+    char msg[96];
+    snprintf(msg, sizeof(msg), "overshoot %.1fF, settled after %lus, %lu switches",
+             r.overshootF, (unsigned long)r.settleS, (unsigned long)r.relaySwitches);
+    TEST_MESSAGE(msg);
+
+    TEST_ASSERT_LESS_THAN_FLOAT(5.0f, r.overshootF);
+    TEST_ASSERT_LESS_THAN_UINT32(60UL * 60UL, r.settleS);
+    // Relay life: at most one on/off pair per window on average
+    TEST_ASSERT_LESS_THAN_UINT32(2 * RUN_S * 1000UL / PID_WINDOW_MS, r.relaySwitches);
+}
+
+void test_autotune_gains_step_response(void) {
+    SumpModel plant;
+    RelayAutotuner tuner;
+    tuner.start(SETPOINT_F, AUTOTUNE_HYSTERESIS_F, AUTOTUNE_CYCLES, AUTOTUNE_TIMEOUT_MS, 0);
+
+    float temp = plant.tempF;
+    uint32_t s = 0;
+    while (tuner.getState() == RelayAutotuner::RUNNING && s < RUN_S) {
+        bool heat = tuner.update(temp, s * 1000UL);
+        temp = plant.step(heat);
+        s++;
+    }
+    TEST_ASSERT_EQUAL(RelayAutotuner::DONE, tuner.getState());
+
+    const PidGains& gains = tuner.getResult();
+    TEST_ASSERT_GREATER_THAN_FLOAT(0.0f, gains.kp);
+    TEST_ASSERT_GREATER_THAN_FLOAT(0.0f, gains.ki);
+
+    StepResponse r = runStep(gains);
+    char msg[128];
+    snprintf(msg, sizeof(msg), "kp=%.4f ki=%.6f kd=%.3f: overshoot %.1fF, settled after %lus",
+             gains.kp, gains.ki, gains.kd, r.overshootF, (unsigned long)r.settleS);
+    TEST_MESSAGE(msg);
+
+    TEST_ASSERT_LESS_THAN_FLOAT(8.0f, r.overshootF);
+    TEST_ASSERT_LESS_THAN_UINT32(90UL * 60UL, r.settleS);
+}
+
+void test_integral_does_not_wind_up_during_heatup(void) {
+    PidController pid;
+    PidGains gains = {PID_DEFAULT_KP, PID_DEFAULT_KI, PID_DEFAULT_KD};
+    pid.setGains(gains);
+    // 30 minutes far below setpoint: output saturated the whole time
+    for (int i = 0; i < 1800; i++) {
+        TEST_ASSERT_FLOAT_WITHIN(1e-6f, 1.0f, pid.update(SETPOINT_F, 70.0f, 1.0f));
+    }
+    TEST_ASSERT_LESS_OR_EQUAL_FLOAT(1.0f, pid.getIntegral());
+    // At setpoint the duty must come off full immediately
+    TEST_ASSERT_LESS_THAN_FLOAT(1.0f, pid.update(SETPOINT_F, SETPOINT_F + 1.0f, 1.0f));
+}
+
+void test_time_proportional_min_cycle(void) {
+    TimeProportionalOutput window(PID_WINDOW_MS, RELAY_MIN_CYCLE_TIME);
+    window.setDuty(0.1f);      // 6 s on: below the 10 s minimum
+    TEST_ASSERT_EQUAL(0, window.onTimeMs());
+    window.setDuty(0.9f);      // 6 s off: rounded to fully on
+    TEST_ASSERT_EQUAL(PID_WINDOW_MS, window.onTimeMs());
+    window.setDuty(0.5f);
+    TEST_ASSERT_EQUAL(PID_WINDOW_MS / 2, window.onTimeMs());
+
+    // No change requested within the minimum cycle time of the last one
+    window.restart(0);
+    TEST_ASSERT_FALSE(window.decide(1000, false, 0));
+    TEST_ASSERT_TRUE(window.decide(RELAY_MIN_CYCLE_TIME, false, 0));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_default_gains_step_response);
+    RUN_TEST(test_autotune_gains_step_response);
+    RUN_TEST(test_integral_does_not_wind_up_during_heatup);
+    RUN_TEST(test_time_proportional_min_cycle);
+    return UNITY_END();
+}
@@ -0,0 +1,181 @@
+#ifndef CALIBRATION_TABLE_H
+#define CALIBRATION_TABLE_H
+
+#include <stdint.h>
+#include <string.h>
+
+// ============================================================================
+// THERMOCOUPLE CALIBRATION TABLE
+// ============================================================================
+//
+// Up to CAL_MAX_POINTS (raw, reference) pairs in deci-degrees, kept sorted by
+// raw reading. compile() turns them into a dense lookup table indexed by the
+// MAX6675 conversion code (12 bits, 0.25 °C per count), so calibrating a
+// sample is one array read.
+//
+//   0 points   identity (uncalibrated)
+//   1 point    constant offset
+//   2+ points  piecewise linear; the end segments are extended beyond the
+//              outermost points
+//
+// Reference values must increase with raw values. A table that would make
+// the corrected reading fall while the probe heats up is rejected, because
+// the thermostat would then drive the heater the wrong way.
+
+static constexpr uint8_t  CAL_MAX_POINTS     = 8;
+static constexpr uint16_t CAL_LUT_SIZE       = 4096;   // MAX6675 codes
+static constexpr int32_t  CAL_CODE_CENTI_C   = 25;     // 0.25 °C per code
+static constexpr int16_t  CAL_MIN_SPACING_X10 = 50;    // Closer raw points replace each other
+static constexpr uint8_t  CAL_BLOB_VERSION   = 1;
+
+struct CalPoint {
+    int16_t raw_c_x10;    // Sensor reading
+    int16_t ref_c_x10;    // Reference thermometer at the same moment
+};
+
+// NVS image of the point list
+struct CalBlob {
+    uint8_t  version;
+    uint8_t  count;
+    CalPoint points[CAL_MAX_POINTS];
+};
+
+class CalibrationTable {
+private:
+    CalPoint points[CAL_MAX_POINTS];
+    uint8_t count = 0;
+    int16_t lut[CAL_LUT_SIZE];
+
+    static int16_t clampX10(int32_t value) {
+        if (value < INT16_MIN) return INT16_MIN;
+        if (value > INT16_MAX) return INT16_MAX;
+        return (int16_t)value;
+    }
+
+    // Strictly increasing references along increasing raw readings
+    static bool monotonic(const CalPoint* pts, uint8_t n) {
+        for (uint8_t i = 1; i < n; i++) {
+            if (pts[i].ref_c_x10 <= pts[i - 1].ref_c_x10) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Linear through a and b, evaluated at a raw reading in centi-degrees
+    static int32_t interpolate(const CalPoint& a, const CalPoint& b, int32_t rawCenti) {
+        int64_t num = (int64_t)(rawCenti - a.raw_c_x10 * 10) * (b.ref_c_x10 - a.ref_c_x10);
+        int64_t den = (int64_t)(b.raw_c_x10 - a.raw_c_x10) * 10;
+        int64_t step = (num >= 0) ? (num + den / 2) / den : -((-num + den / 2) / den);
+        return a.ref_c_x10 + (int32_t)step;
+    }
+
+public:
+    CalibrationTable() { compile(); }
+
+    uint8_t size() const { return count; }
+    const CalPoint& point(uint8_t i) const { return points[i]; }
+
+    void clear() {
+        count = 0;
+        compile();
+    }
+
+    // Insert a point, replacing any existing point within CAL_MIN_SPACING_X10
+    // of the same raw reading. Returns false (table unchanged) if the table
+    // is full or the result would not be monotonic.
+    bool addPoint(int16_t rawX10, int16_t refX10) {
+        CalPoint next[CAL_MAX_POINTS + 1];
+        uint8_t n = 0;
+        bool inserted = false;
+
+        for (uint8_t i = 0; i < count; i++) {
+            int32_t gap = (int32_t)points[i].raw_c_x10 - rawX10;
+            if (gap > -CAL_MIN_SPACING_X10 && gap < CAL_MIN_SPACING_X10) {
+                continue;   // Replaced by the new point
+            }
+            if (!inserted && points[i].raw_c_x10 > rawX10) {
+                next[n++] = CalPoint{rawX10, refX10};
+                inserted = true;
+            }
+            next[n++] = points[i];
+        }
+        if (!inserted) {
+            next[n++] = CalPoint{rawX10, refX10};
+        }
+
+        if (n > CAL_MAX_POINTS || !monotonic(next, n)) {
+            return false;
+        }
+        memcpy(points, next, sizeof(CalPoint) * n);
+        count = n;
+        compile();
+        return true;
+    }
+
+    bool removePoint(uint8_t index) {
+        if (index >= count) {
+            return false;
+        }
+        memmove(&points[index], &points[index + 1], sizeof(CalPoint) * (count - index - 1));
+        count--;
+        compile();
+        return true;
+    }
+
+    // Rebuild the lookup table from the point list
+    void compile() {
+        uint8_t seg = 0;
+        for (uint16_t code = 0; code < CAL_LUT_SIZE; code++) {
+            int32_t rawCenti = (int32_t)code * CAL_CODE_CENTI_C;
+            int32_t value;
+
+            if (count == 0) {
+                value = (rawCenti + 5) / 10;
+            } else if (count == 1) {
+                value = (rawCenti + 5) / 10 + (points[0].ref_c_x10 - points[0].raw_c_x10);
+            } else {
+                // Codes ascend, so the active segment only ever moves forward
+                while (seg + 2 < count && rawCenti > points[seg + 1].raw_c_x10 * 10) {
+                    seg++;
+                }
+                value = interpolate(points[seg], points[seg + 1], rawCenti);
+            }
+            lut[code] = clampX10(value);
+        }
+    }
+
+    // Calibrated temperature (°C × 10) for a MAX6675 code
+    int16_t apply(uint16_t code) const {
+        return lut[code < CAL_LUT_SIZE ? code : CAL_LUT_SIZE - 1];
+    }
+
+    void toBlob(CalBlob& blob) const {
+        memset(&blob, 0, sizeof(blob));
+        blob.version = CAL_BLOB_VERSION;
+        blob.count = count;
+        memcpy(blob.points, points, sizeof(CalPoint) * count);
+    }
+
+    // Load a stored table; rejects blobs from another version or that fail
+    // the same checks as addPoint()
+    bool fromBlob(const CalBlob& blob) {
+        if (blob.version != CAL_BLOB_VERSION || blob.count > CAL_MAX_POINTS) {
+            return false;
+        }
+        for (uint8_t i = 1; i < blob.count; i++) {
+            if (blob.points[i].raw_c_x10 - blob.points[i - 1].raw_c_x10 < CAL_MIN_SPACING_X10) {
+                return false;
+            }
+        }
+        if (!monotonic(blob.points, blob.count)) {
+            return false;
+        }
+        memcpy(points, blob.points, sizeof(CalPoint) * blob.count);
+        count = blob.count;
+        compile();
+        return true;
+    }
+};
+
+#endif // CALIBRATION_TABLE_H
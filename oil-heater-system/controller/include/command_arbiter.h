@@ -0,0 +1,150 @@
+#ifndef COMMAND_ARBITER_H
+#define COMMAND_ARBITER_H
+
+#include <stdint.h>
+
+// ============================================================================
+// COMMAND ARBITRATION
+// ============================================================================
+//
+// Setpoint / enable commands from every transport (display UART, BLE,
+// ESP-NOW pit display) go through one queue to the control task, which runs
+// each through arbitrate() before applying it:
+//
+//   APPLY      newest command overall - last writer wins, whichever source
+//   DUPLICATE  sequence number already seen from this source (a keepalive
+//              or a retransmit); refreshes the watchdog, changes nothing
+//   STALE      stamped before the command currently in force (two sources
+//              raced and this one lost); refreshes the watchdog only
+//
+// Receive stamps are the full 64-bit esp_timer_get_time(), so ordering holds
+// however long the heater sits idle between commands.
+//
+// Senders increment seq only when the user changes something and repeat the
+// last seq in keepalives, so a periodic display packet cannot undo a newer
+// phone command. A source that was silent longer than the restart timeout,
+// or whose seq jumps back by more than SEQ_RESTART_WINDOW, is treated as
+// restarted and its next command is accepted.
+//
+// Each command addresses one heater zone. Sequence numbers are per source
+// (not per zone), but "newest command in force" is tracked per zone, so a
+// command for one zone is never judged stale against another zone's.
+
+enum CommandSource : uint8_t {
+    CMD_SRC_DISPLAY = 0,
+    CMD_SRC_BLE     = 1,
+    CMD_SRC_PIT     = 2,        // Wireless pit display (ESP-NOW)
+    CMD_SRC_COUNT
+};
+
+static constexpr uint8_t  CMD_MAX_ZONES          = 4;
+static constexpr uint16_t CMD_SETPOINT_UNCHANGED = 0xFFFF;
+static constexpr uint8_t  CMD_ENABLE_UNCHANGED   = 0xFF;
+
+struct HeaterCommand {
+    uint8_t  source;            // CommandSource
+    uint8_t  zone;              // Heater zone, < CMD_MAX_ZONES
+    uint8_t  enable;            // 0 / 1 / CMD_ENABLE_UNCHANGED
+    uint16_t setpoint_c_x10;    // °C × 10 or CMD_SETPOINT_UNCHANGED
+    uint32_t seq;               // Sender's sequence number
+    uint32_t receivedMs;        // millis() when the transport received it
+    int64_t  receivedUs;        // esp_timer_get_time(), for ordering and latency
+};
+
+class CommandArbiter {
+public:
+    enum Verdict : uint8_t {
+        APPLY,
+        DUPLICATE,
+        STALE
+    };
+
+    static constexpr uint32_t SEQ_RESTART_WINDOW = 1024;
+
+    struct Counters {
+        uint32_t applied;
+        uint32_t duplicates;
+        uint32_t stale;
+    };
+
+private:
+    struct SourceState {
+        bool seen;
+        uint32_t lastSeq;
+        uint32_t lastMs;
+    };
+
+    struct ZoneState {
+        bool haveApplied;
+        int64_t appliedUs;
+        uint32_t appliedSeq;
+        uint8_t owner;
+    };
+
+    SourceState sources[CMD_SRC_COUNT];
+    ZoneState zones[CMD_MAX_ZONES];
+    uint32_t restartTimeoutMs;
+    Counters counters = {0, 0, 0};
+
+public:
+    explicit CommandArbiter(uint32_t restartMs) : restartTimeoutMs(restartMs) {
+        for (uint8_t i = 0; i < CMD_SRC_COUNT; i++) {
+            sources[i] = SourceState{false, 0, 0};
+        }
+        for (uint8_t i = 0; i < CMD_MAX_ZONES; i++) {
+            zones[i] = ZoneState{false, 0, 0, CMD_SRC_DISPLAY};
+        }
+    }
+
+    Verdict arbitrate(const HeaterCommand& cmd) {
+        if (cmd.source >= CMD_SRC_COUNT || cmd.zone >= CMD_MAX_ZONES) {
+            counters.stale++;
+            return STALE;
+        }
+        SourceState& src = sources[cmd.source];
+
+        int32_t age = (int32_t)(cmd.seq - src.lastSeq);
+        bool restarted = !src.seen ||
+                         (cmd.receivedMs - src.lastMs) > restartTimeoutMs ||
+                         age < -(int32_t)SEQ_RESTART_WINDOW;
+        src.lastMs = cmd.receivedMs;
+
+        if (!restarted && age <= 0) {
+            counters.duplicates++;
+            return DUPLICATE;
+        }
+        src.seen = true;
+        src.lastSeq = cmd.seq;
+
+        ZoneState& zone = zones[cmd.zone];
+        if (zone.haveApplied && cmd.receivedUs < zone.appliedUs) {
+            counters.stale++;
+            return STALE;
+        }
+        zone.haveApplied = true;
+        zone.appliedUs = cmd.receivedUs;
+        zone.appliedSeq = cmd.seq;
+        zone.owner = cmd.source;
+        counters.applied++;
+        return APPLY;
+    }
+
+    // Last sequence number accepted from a source (for acknowledgements)
+    uint32_t lastSeq(uint8_t source) const {
+        return source < CMD_SRC_COUNT ? sources[source].lastSeq : 0;
+    }
+
+    // Source of the command currently in force in a zone
+    uint8_t getOwner(uint8_t zone = 0) const {
+        return zone < CMD_MAX_ZONES ? zones[zone].owner : (uint8_t)CMD_SRC_DISPLAY;
+    }
+
+    // Sequence number of the command currently in force in a zone
+    uint32_t getAppliedSeq(uint8_t zone = 0) const {
+        return zone < CMD_MAX_ZONES ? zones[zone].appliedSeq : 0;
+    }
+
+    const Counters& getCounters() const { return counters; }
+};
+
+#endif // COMMAND_ARBITER_H
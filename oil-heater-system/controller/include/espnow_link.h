@@ -0,0 +1,309 @@
+#ifndef ESPNOW_LINK_H
+#define ESPNOW_LINK_H
+
+#include <stdint.h>
+#include <string.h>
+
+// ============================================================================
+// ESP-NOW LINK
+// ============================================================================
+//
+// Each ESP-NOW frame carries one packet: a LinkFrameType byte (shared with
+// the UART link) followed by the packed struct. ESP-NOW has its own CRC and
+// MAC-level acknowledgement, so there is no COBS / CRC-16 layer here.
+//
+// Pairing: a display broadcasts a pair request. The controller accepts it
+// only while its pairing window is open, then talks to that one MAC and
+// ignores every other sender (RadioPeerGate).
+//
+// Frames to and from the paired peer are encrypted with a shared LMK. The
+// pair request and reply are broadcast in the clear (ESP-NOW cannot encrypt
+// broadcast); they carry no secrets, and the display learns the controller's
+// MAC from the reply before adding it as an encrypted peer.
+//
+// Reliability: ESP-NOW gives up after a few MAC retries. The command sender
+// therefore keeps its newest command until a status packet echoes the seq,
+// and resends it every retry interval (CommandSender); the controller sends
+// status straight after each command it processes. Round-trip time is
+// sampled only from commands acknowledged without a resend (Karn's rule), so
+// a late echo of the first copy cannot be mistaken for a fast one.
+//
+// Both ends of the link run on a host against LoopbackRadio.
+
+static constexpr size_t RADIO_MAC_LEN   = 6;
+static constexpr size_t RADIO_MAX_FRAME = 250;     // ESP_NOW_MAX_DATA_LEN
+
+static const uint8_t RADIO_BROADCAST[RADIO_MAC_LEN] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+
+class RadioPort {
+public:
+    virtual ~RadioPort() {}
+    virtual bool send(const uint8_t* mac, const uint8_t* data, size_t len) = 0;
+};
+
+// ----------------------------------------------------------------------------
+// Latency statistics (min / avg / max over a report window)
+// ----------------------------------------------------------------------------
+
+struct LatencySnapshot {
+    uint32_t samples;
+    uint32_t minUs;
+    uint32_t avgUs;
+    uint32_t maxUs;
+};
+
+class LatencyTracker {
+private:
+    uint32_t samples = 0;
+    uint32_t minUs = UINT32_MAX;
+    uint32_t maxUs = 0;
+    uint64_t sumUs = 0;
+
+public:
+    void record(uint32_t us) {
+        samples++;
+        sumUs += us;
+        if (us < minUs) minUs = us;
+        if (us > maxUs) maxUs = us;
+    }
+
+    LatencySnapshot snapshot() const {
+        LatencySnapshot snap = {samples, samples ? minUs : 0,
+                            samples ? (uint32_t)(sumUs / samples) : 0, maxUs};
+        return snap;
+    }
+
+    void reset() {
+        samples = 0;
+        minUs = UINT32_MAX;
+        maxUs = 0;
+        sumUs = 0;
+    }
+};
+
+// ----------------------------------------------------------------------------
+// Pairing
+// ----------------------------------------------------------------------------
+
+class RadioPeerGate {
+private:
+    bool paired = false;
+    uint8_t peerMac[RADIO_MAC_LEN] = {0, 0, 0, 0, 0, 0};
+    bool windowOpen = false;
+    uint32_t windowStartMs = 0;
+    uint32_t windowMs = 0;
+
+public:
+    // Accept pair requests for the next durationMs
+    void openWindow(uint32_t nowMs, uint32_t durationMs) {
+        windowOpen = true;
+        windowStartMs = nowMs;
+        windowMs = durationMs;
+    }
+
+    bool isWindowOpen(uint32_t nowMs) {
+        if (windowOpen && (nowMs - windowStartMs) >= windowMs) {
+            windowOpen = false;
+        }
+        return windowOpen;
+    }
+
+    // Peer loaded from storage at boot
+    void restore(const uint8_t* mac) {
+        memcpy(peerMac, mac, RADIO_MAC_LEN);
+        paired = true;
+    }
+
+    void forget() { paired = false; }
+
+    bool isPaired() const { return paired; }
+    const uint8_t* peer() const { return peerMac; }
+
+    // Data frames are accepted from the paired peer only
+    bool accepts(const uint8_t* mac) const {
+        return paired && memcmp(mac, peerMac, RADIO_MAC_LEN) == 0;
+    }
+
+    // A pair request; true if mac is now the peer (caller persists and
+    // replies). A repeat request from the current peer is always accepted,
+    // so a display that missed the reply can retry after the window closes.
+    bool pairRequest(const uint8_t* mac, uint32_t nowMs) {
+        if (accepts(mac)) {
+            return true;
+        }
+        if (!isWindowOpen(nowMs)) {
+            return false;
+        }
+        restore(mac);
+        windowOpen = false;
+        return true;
+    }
+};
+
+// ----------------------------------------------------------------------------
+// Command sender (display side)
+// ----------------------------------------------------------------------------
+
+class CommandSender {
+public:
+    struct Counters {
+        uint32_t sent;
+        uint32_t retransmits;
+        uint32_t acked;
+        uint32_t failed;        // Gave up after maxRetries resends
+    };
+
+private:
+    RadioPort& port;
+    uint8_t peerMac[RADIO_MAC_LEN];
+    uint32_t retryUs;
+    uint8_t maxRetries;
+
+    uint8_t frame[RADIO_MAX_FRAME];
+    size_t frameLen = 0;
+    uint32_t seq = 0;
+    bool pending = false;
+    uint8_t retries = 0;
+    uint32_t firstSentUs = 0;
+    uint32_t lastSentUs = 0;
+
+    LatencyTracker rtt;
+    Counters counters = {0, 0, 0, 0};
+
+public:
+    CommandSender(RadioPort& radio, const uint8_t* peer, uint32_t retryIntervalUs, uint8_t retryLimit)
+        : port(radio), retryUs(retryIntervalUs), maxRetries(retryLimit) {
+        memcpy(peerMac, peer, RADIO_MAC_LEN);
+    }
+
+    // Send a command frame carrying seq; replaces any command still pending
+    bool send(const uint8_t* data, size_t len, uint32_t commandSeq, uint32_t nowUs) {
+        if (len > sizeof(frame)) {
+            return false;
+        }
+        memcpy(frame, data, len);
+        frameLen = len;
+        seq = commandSeq;
+        pending = true;
+        retries = 0;
+        firstSentUs = nowUs;
+        lastSentUs = nowUs;
+        counters.sent++;
+        return port.send(peerMac, frame, frameLen);
+    }
+
+    // seq_echo from a status packet
+    void onEcho(uint32_t seqEcho, uint32_t nowUs) {
+        if (!pending || (int32_t)(seqEcho - seq) < 0) {
+            return;
+        }
+        pending = false;
+        counters.acked++;
+        if (retries == 0) {
+            rtt.record(nowUs - firstSentUs);
+        }
+    }
+
+    // Call periodically; resends the pending command when its echo is late
+    void poll(uint32_t nowUs) {
+        if (!pending || (nowUs - lastSentUs) < retryUs) {
+            return;
+        }
+        if (retries >= maxRetries) {
+            pending = false;
+            counters.failed++;
+            return;
+        }
+        retries++;
+        lastSentUs = nowUs;
+        counters.retransmits++;
+        port.send(peerMac, frame, frameLen);
+    }
+
+    bool isPending() const { return pending; }
+    const Counters& getCounters() const { return counters; }
+    LatencySnapshot getRtt() const { return rtt.snapshot(); }
+};
+
+// ----------------------------------------------------------------------------
+// Host stand-in
+// ----------------------------------------------------------------------------
+
+// Two ports wired back to back. Frames wait in the receiving port's inbox
+// until pump() hands them to its handler, so a handler can reply without
+// recursing. dropMask drops frames whose send count has that bit pattern
+// (e.g. 0x3 drops every fourth frame), dropNext() the next few frames, to
+// exercise retransmits.
+class LoopbackRadio : public RadioPort {
+public:
+    typedef void (*Handler)(void* context, const uint8_t* mac, const uint8_t* data, size_t len);
+
+    static constexpr uint8_t INBOX = 8;
+
+private:
+    struct Frame {
+        uint8_t len;
+        uint8_t data[RADIO_MAX_FRAME];
+    };
+
+    uint8_t ownMac[RADIO_MAC_LEN];
+    LoopbackRadio* remote = nullptr;
+    Frame inbox[INBOX];
+    uint8_t head = 0;
+    uint8_t count = 0;
+    uint32_t sends = 0;
+    uint32_t dropMask = 0;
+    uint32_t dropCount = 0;
+
+public:
+    explicit LoopbackRadio(const uint8_t* mac) {
+        memcpy(ownMac, mac, RADIO_MAC_LEN);
+    }
+
+    static void connect(LoopbackRadio& a, LoopbackRadio& b) {
+        a.remote = &b;
+        b.remote = &a;
+    }
+
+    void setDropMask(uint32_t mask) { dropMask = mask; }
+    void dropNext(uint32_t frames) { dropCount = frames; }
+    uint32_t sendCount() const { return sends; }
+
+    bool send(const uint8_t* mac, const uint8_t* data, size_t len) override {
+        uint32_t n = sends++;
+        if (!remote || len > RADIO_MAX_FRAME || remote->count >= INBOX) {
+            return false;
+        }
+        if (memcmp(mac, RADIO_BROADCAST, RADIO_MAC_LEN) != 0 &&
+            memcmp(mac, remote->ownMac, RADIO_MAC_LEN) != 0) {
+            return false;
+        }
+        if (dropCount > 0) {
+            dropCount--;
+            return true;    // Lost in the air; the sender cannot tell
+        }
+        if (dropMask != 0 && (n & dropMask) == dropMask) {
+            return true;
+        }
+        Frame& f = remote->inbox[(remote->head + remote->count) % INBOX];
+        f.len = (uint8_t)len;
+        memcpy(f.data, data, len);
+        remote->count++;
+        return true;
+    }
+
+    // Deliver queued frames to handler; returns the number delivered
+    uint8_t pump(Handler handler, void* context) {
+        uint8_t delivered = 0;
+        while (count > 0) {
+            Frame f = inbox[head];
+            head = (head + 1) % INBOX;
+            count--;
+            handler(context, remote->ownMac, f.data, f.len);
+            delivered++;
+        }
+        return delivered;
+    }
+};
+
+#endif // ESPNOW_LINK_H
@@ -0,0 +1,276 @@
+#ifndef FLIGHT_RECORDER_H
+#define FLIGHT_RECORDER_H
+
+#include <Arduino.h>
+#include <LittleFS.h>
+#include "recorder_codec.h"
+
+// ============================================================================
+// FLIGHT RECORDER
+// ============================================================================
+//
+// Black box for fault analysis. One RecorderSample per zone reading is
+// delta-encoded into a RAM page (recorder_codec.h); only full pages touch
+// flash, appended to the current segment file:
+//
+//   /rec/s_<n>.bin   rolling log, SEGMENT_PAGES pages each; the oldest
+//                    segment is deleted once SEGMENT_COUNT exist
+//   /rec/f_<n>.bin   pinned copy of the pages before a fault; never rotated
+//                    out by the log, only by newer fault files
+//
+// LittleFS does the wear levelling. The last PIN_RING_PAGES pages also stay
+// in RAM, so pinning a fault is one file write, not a copy out of flash.
+//
+// All flash access happens in the caller's (low-priority) task. Samples
+// arrive through a queue, so the control tick never waits on a write.
+
+#define REC_DIR "/rec"
+
+class FlightRecorder {
+public:
+    static constexpr uint16_t SEGMENT_PAGES  = 64;      // 16 KB per segment
+    static constexpr uint8_t  SEGMENT_COUNT  = 12;      // 192 KB rolling log
+    static constexpr uint8_t  MAX_FAULT_FILES = 8;
+    static constexpr uint8_t  PIN_RING_PAGES = 24;      // 6 KB RAM
+
+    struct Stats {
+        uint32_t samples;
+        uint32_t pagesWritten;
+        uint32_t writeErrors;
+        uint32_t faultsPinned;
+        uint32_t lastFlushUs;
+        uint32_t maxFlushUs;
+    };
+
+private:
+    RecorderPageEncoder encoder;
+    uint32_t pinWindowMs;
+    uint32_t pinHoldoffMs;
+    bool ready = false;
+
+    File segment;
+    uint32_t segmentIndex = 0;
+    uint16_t segmentPages = 0;
+    uint32_t faultIndex = 0;
+
+    uint8_t ring[PIN_RING_PAGES][REC_PAGE_SIZE];
+    uint32_t ringStartMs[PIN_RING_PAGES];
+    uint8_t ringHead = 0;
+    uint8_t ringCount = 0;
+
+    uint8_t lastFault[REC_MAX_ZONES] = {0, 0, 0, 0};
+    bool pinnedOnce = false;
+    uint32_t lastPinMs = 0;
+
+    Stats stats = {0, 0, 0, 0, 0, 0};
+
+    // Dump cursor (see serviceDump)
+    bool dumping = false;
+    File dumpDir;
+    File dumpFile;
+
+    static void pathFor(char* out, size_t len, char kind, uint32_t index) {
+        snprintf(out, len, REC_DIR "/%c_%lu.bin", kind, (unsigned long)index);
+    }
+
+    // Parse "s_12.bin" / "f_3.bin"; returns the kind or 0
+    static char parseName(const char* name, uint32_t& index) {
+        const char* base = strrchr(name, '/');
+        base = base ? base + 1 : name;
+        if ((base[0] != 's' && base[0] != 'f') || base[1] != '_') {
+            return 0;
+        }
+        index = strtoul(base + 2, nullptr, 10);
+        return base[0];
+    }
+
+    void openSegment() {
+        char path[32];
+        pathFor(path, sizeof(path), 's', segmentIndex);
+        segment = LittleFS.open(path, FILE_APPEND);
+        segmentPages = 0;
+
+        if (segmentIndex >= SEGMENT_COUNT) {
+            pathFor(path, sizeof(path), 's', segmentIndex - SEGMENT_COUNT);
+            LittleFS.remove(path);
+        }
+    }
+
+    void flushPage() {
+        const uint8_t* page = encoder.finish();
+
+        memcpy(ring[ringHead], page, REC_PAGE_SIZE);
+        ringStartMs[ringHead] = encoder.startMs();
+        ringHead = (ringHead + 1) % PIN_RING_PAGES;
+        if (ringCount < PIN_RING_PAGES) {
+            ringCount++;
+        }
+
+        uint32_t startUs = micros();
+        if (!segment || segment.write(page, REC_PAGE_SIZE) != REC_PAGE_SIZE) {
+            stats.writeErrors++;
+        } else {
+            segment.flush();
+            stats.pagesWritten++;
+        }
+        stats.lastFlushUs = micros() - startUs;
+        if (stats.lastFlushUs > stats.maxFlushUs) {
+            stats.maxFlushUs = stats.lastFlushUs;
+        }
+
+        encoder.startPage();
+        if (++segmentPages >= SEGMENT_PAGES) {
+            segment.close();
+            segmentIndex++;
+            openSegment();
+        }
+    }
+
+    void pinFault(uint32_t nowMs) {
+        // Close out the partial page so the fault itself is on record
+        if (!encoder.empty()) {
+            flushPage();
+        }
+
+        char path[32];
+        pathFor(path, sizeof(path), 'f', faultIndex);
+        File file = LittleFS.open(path, FILE_WRITE);
+        if (!file) {
+            stats.writeErrors++;
+            return;
+        }
+
+        // Oldest first, skipping pages that end before the pin window
+        uint8_t slot = (ringHead + PIN_RING_PAGES - ringCount) % PIN_RING_PAGES;
+        for (uint8_t i = 0; i < ringCount; i++) {
+            uint8_t next = (slot + 1) % PIN_RING_PAGES;
+            bool tooOld = (i + 1 < ringCount) && (nowMs - ringStartMs[next]) > pinWindowMs;
+            if (!tooOld) {
+                file.write(ring[slot], REC_PAGE_SIZE);
+            }
+            slot = next;
+        }
+        file.close();
+
+        if (faultIndex >= MAX_FAULT_FILES) {
+            pathFor(path, sizeof(path), 'f', faultIndex - MAX_FAULT_FILES);
+            LittleFS.remove(path);
+        }
+        faultIndex++;
+        stats.faultsPinned++;
+    }
+
+public:
+    FlightRecorder(uint32_t tickPeriodMs, uint8_t zoneCount, uint32_t pinWindow, uint32_t pinHoldoff)
+        : encoder(tickPeriodMs, zoneCount), pinWindowMs(pinWindow), pinHoldoffMs(pinHoldoff) {}
+
+    // Mount LittleFS (formatting it if needed) and start a new segment
+    bool begin() {
+        if (!LittleFS.begin(true)) {
+            return false;
+        }
+        LittleFS.mkdir(REC_DIR);
+
+        // Continue numbering after the newest files from earlier boots
+        File dir = LittleFS.open(REC_DIR);
+        File entry = dir.openNextFile();
+        bool haveSegment = false;
+        bool haveFault = false;
+        while (entry) {
+            uint32_t index;
+            char kind = parseName(entry.name(), index);
+            if (kind == 's' && (!haveSegment || index >= segmentIndex)) {
+                segmentIndex = index + 1;
+                haveSegment = true;
+            } else if (kind == 'f' && (!haveFault || index >= faultIndex)) {
+                faultIndex = index + 1;
+                haveFault = true;
+            }
+            entry = dir.openNextFile();
+        }
+
+        openSegment();
+        ready = (bool)segment;
+        return ready;
+    }
+
+    bool isReady() const { return ready; }
+    const Stats& getStats() const { return stats; }
+
+    void record(const RecorderSample& sample) {
+        if (!ready || sample.zone >= REC_MAX_ZONES) {
+            return;
+        }
+        stats.samples++;
+
+        if (!encoder.append(sample)) {
+            flushPage();
+            encoder.append(sample);
+        }
+
+        // Pin when any zone enters a fault, at most once per holdoff period
+        bool onset = (lastFault[sample.zone] == 0 && sample.fault != 0);
+        lastFault[sample.zone] = sample.fault;
+        if (onset && (!pinnedOnce || sample.uptimeMs - lastPinMs >= pinHoldoffMs)) {
+            pinnedOnce = true;
+            lastPinMs = sample.uptimeMs;
+            pinFault(sample.uptimeMs);
+        }
+    }
+
+    // Print every recorder file with its size
+    void list(Print& out) {
+        File dir = LittleFS.open(REC_DIR);
+        File entry = dir.openNextFile();
+        out.println("[REC] Files:");
+        while (entry) {
+            out.printf("      %-12s %6lu bytes\n", entry.name(), (unsigned long)entry.size());
+            entry = dir.openNextFile();
+        }
+    }
+
+    // Start a hex dump of all files (consumed by tools/decode_recorder.py)
+    void startDump(Print& out) {
+        if (!encoder.empty()) {
+            flushPage();    // Include the newest samples
+        }
+        dumpDir = LittleFS.open(REC_DIR);
+        dumpFile = File();
+        dumping = true;
+        out.println("REC-DUMP BEGIN");
+    }
+
+    bool isDumping() const { return dumping; }
+
+    // Emit a few lines per call so the display link and BLE keep running
+    //   REC <name> <hex>
+    void serviceDump(Print& out, uint8_t maxLines) {
+        uint8_t buf[32];
+        while (dumping && maxLines > 0) {
+            if (!dumpFile) {
+                dumpFile = dumpDir.openNextFile();
+                if (!dumpFile) {
+                    dumping = false;
+                    out.println("REC-DUMP END");
+                    return;
+                }
+            }
+
+            size_t n = dumpFile.read(buf, sizeof(buf));
+            if (n == 0) {
+                dumpFile.close();
+                dumpFile = File();
+                continue;
+            }
+
+            out.printf("REC %s ", dumpFile.name());
+            for (size_t i = 0; i < n; i++) {
+                out.printf("%02x", buf[i]);
+            }
+            out.println();
+            maxLines--;
+        }
+    }
+};
+
+#endif // FLIGHT_RECORDER_H
@@ -0,0 +1,227 @@
+#ifndef HEATER_MODEL_H
+#define HEATER_MODEL_H
+
+#include <stdint.h>
+
+// ============================================================================
+// HEATER RATE-OF-RISE MODEL
+// ============================================================================
+//
+// Compares the observed dT/dt of a zone with what its relay state implies.
+// Every reading updates two exponential averages of the temperature. On a
+// steady ramp the slow one lags the fast one by a fixed number of samples,
+// so their difference is the current slope. The longer checks use the rise
+// since an anchor reading. State is a few words per zone:
+//
+//   PROBE_DETACHED  temperature falling faster than any oil can cool, for
+//                   detachConfirm samples (probe pulled off the tank)
+//   OPEN_ELEMENT    relay on, but over one window after the thermal lag the
+//                   element adds less than expected to the rise
+//   STUCK_RELAY     relay off, but after the thermal lag the temperature
+//                   rises well above the expected cooling (relay welded)
+//
+// The plant is taken as dT/dt = gain * relay - cooling. Both terms are
+// learned from healthy windows: cooling from relay-off windows, gain as the
+// relay-on rate plus that cooling. Losses grow with temperature, so a weak
+// element that barely gains near the setpoint is still judged by what it
+// adds, not by the net rise. The gain starts at nominalHeat. No check runs
+// during the lag after a relay change, while the element's stored heat
+// overshoots and the probe catches up.
+//
+// Faults latch until clear(): once the relay is forced off, the evidence
+// for an open element is gone and the fault would otherwise flicker. A
+// stuck relay replaces an open element, since it is the one the relay
+// cannot make safe. A detached probe stops the rate checks: its flat
+// reading near ambient would otherwise pass for a zone that no longer
+// cools, and be reported as a welded relay.
+//
+// Rates are in °C × 10 per minute, temperatures in °C × 10.
+
+struct HeaterModelConfig {
+    uint32_t samplePeriodMs;     // Interval between update() calls
+    uint32_t lagMs;              // No rate checks this long after a relay change
+    uint32_t windowMs;           // Rise measured over this long
+    int32_t  minHeat;            // Relay on: slowest acceptable rise
+    int32_t  nominalHeat;        // Starting point for the learned heating rate
+    int32_t  detachFall;         // Fall faster than this = probe detached
+    uint8_t  detachConfirm;      // Consecutive samples before flagging it
+};
+
+class HeaterModel {
+public:
+    enum Verdict : uint8_t {
+        OK = 0,
+        STUCK_RELAY,
+        OPEN_ELEMENT,
+        PROBE_DETACHED,
+    };
+
+private:
+    // EMA shifts: alpha 1/4 and 1/16. On a ramp they lag (1 - a) / a =
+    // 3 and 15 samples, so fast - slow = 12 samples of slope.
+    static constexpr uint8_t  FAST_SHIFT = 2;
+    static constexpr uint8_t  SLOW_SHIFT = 4;
+    static constexpr int32_t  LAG_SAMPLES = 15 - 3;
+    static constexpr uint8_t  FRAC_BITS = 8;        // EMA state is °C × 10 × 256
+    static constexpr uint32_t MS_PER_MIN = 60000;
+
+    HeaterModelConfig cfg;
+
+    bool primed = false;
+    int32_t fastEma = 0;
+    int32_t slowEma = 0;
+    uint16_t warmup = 0;         // Samples until the slow EMA has settled
+    uint8_t detachCount = 0;
+
+    bool relayOn = false;
+    uint32_t phaseStartMs = 0;   // Last relay change
+    bool anchored = false;
+    int32_t anchorTemp = 0;      // slowEma at anchorMs
+    uint32_t anchorMs = 0;
+
+    int32_t learnedGain;
+    int32_t learnedCool = 0;     // Fall rate with the relay off (>= 0)
+    Verdict latched = OK;
+
+    void latch(Verdict v) {
+        if (latched == OK || v == STUCK_RELAY) {
+            latched = v;
+        }
+    }
+
+    // Rise over elapsedMs, as a rate
+    static int32_t ratePerMin(int32_t rise, uint32_t elapsedMs) {
+        return (int32_t)((int64_t)rise * MS_PER_MIN / (int32_t)elapsedMs);
+    }
+
+    // Window checks run on the slow EMA: on a ramp its lag cancels out of
+    // the rise, and it averages out the MAX6675's 0.25 °C steps.
+    void checkWindow(uint32_t nowMs) {
+        if (!anchored) {
+            anchored = true;
+            anchorTemp = slowEma;
+            anchorMs = nowMs;
+            return;
+        }
+
+        uint32_t elapsed = nowMs - anchorMs;
+        int32_t rise = (slowEma - anchorTemp) / (1 << FRAC_BITS);
+
+        if (!relayOn) {
+            // Judge early: the excess over the expected cooling can only
+            // grow. Allow half the gain (at least twice minHeat) for noise
+            // and slow overshoot.
+            int32_t limit = learnedGain / 2 > 2 * cfg.minHeat ? learnedGain / 2 : 2 * cfg.minHeat;
+            int64_t excess = ((int64_t)rise + (int64_t)learnedCool * elapsed / MS_PER_MIN) * MS_PER_MIN;
+            if (excess > (int64_t)limit * cfg.windowMs) {
+                latch(STUCK_RELAY);
+            }
+        }
+        if (elapsed < cfg.windowMs) {
+            return;
+        }
+
+        int32_t rate = ratePerMin(rise, elapsed);
+        if (relayOn) {
+            int32_t gain = rate + learnedCool;
+            int32_t floor = learnedGain / 4 > cfg.minHeat ? learnedGain / 4 : cfg.minHeat;
+            if (gain < floor) {
+                latch(OPEN_ELEMENT);
+            } else {
+                learnedGain += (gain - learnedGain) / 4;
+            }
+        } else if (latched == OK) {
+            int32_t cool = rate < 0 ? -rate : 0;
+            learnedCool += (cool - learnedCool) / 4;
+        }
+        anchorTemp = slowEma;
+        anchorMs = nowMs;
+    }
+
+public:
+    explicit HeaterModel(const HeaterModelConfig& config)
+        : cfg(config), learnedGain(config.nominalHeat) {}
+
+    // Forget the readings (sensor fault, calibration change). The latched
+    // verdict and learned rates are kept.
+    void reset() {
+        primed = false;
+        detachCount = 0;
+        anchored = false;
+    }
+
+    // Operator acknowledged the fault (zone re-enabled)
+    void clear() {
+        latched = OK;
+        reset();
+    }
+
+    /**
+     * Feed one filtered reading
+     * @param tempX10 temperature in °C × 10
+     * @param relay   relay state since the previous reading
+     * @param nowMs   reading time
+     * @return the latched verdict
+     */
+    Verdict update(int32_t tempX10, bool relay, uint32_t nowMs) {
+        if (!primed || relay != relayOn) {
+            relayOn = relay;
+            phaseStartMs = nowMs;
+            anchored = false;
+        }
+
+        int32_t x = tempX10 * (1 << FRAC_BITS);
+        if (!primed) {
+            primed = true;
+            fastEma = x;
+            slowEma = x;
+            warmup = 4 << SLOW_SHIFT;
+            detachCount = 0;
+            return latched;
+        }
+        fastEma += (x - fastEma) >> FAST_SHIFT;
+        slowEma += (x - slowEma) >> SLOW_SHIFT;
+
+        if (warmup > 0) {
+            warmup--;
+        } else {
+            // Slope: (fast - slow) / LAG_SAMPLES per sample. Compare without
+            // dividing: fall rate > detachFall <=> -(fast - slow) * 60000 >
+            // detachFall * LAG_SAMPLES * period * 256.
+            int64_t diff = (int64_t)(fastEma - slowEma) * MS_PER_MIN;
+            int64_t limit = (int64_t)cfg.detachFall * LAG_SAMPLES * cfg.samplePeriodMs * (1 << FRAC_BITS);
+            if (-diff > limit) {
+                if (detachCount < cfg.detachConfirm) {
+                    detachCount++;
+                }
+                if (detachCount >= cfg.detachConfirm) {
+                    latch(PROBE_DETACHED);
+                }
+            } else {
+                detachCount = 0;
+            }
+        }
+
+        if (latched != PROBE_DETACHED && nowMs - phaseStartMs >= cfg.lagMs) {
+            checkWindow(nowMs);
+        }
+        return latched;
+    }
+
+    Verdict verdict() const { return latched; }
+
+    // Current slope estimate, °C × 10 per minute (0 until settled)
+    int32_t slope() const {
+        if (!primed || warmup > 0) {
+            return 0;
+        }
+        int64_t num = (int64_t)(fastEma - slowEma) * MS_PER_MIN;
+        return (int32_t)(num / ((int64_t)LAG_SAMPLES * cfg.samplePeriodMs * (1 << FRAC_BITS)));
+    }
+
+    // Learned element gain and relay-off fall rate, °C × 10 per minute
+    int32_t gain() const { return learnedGain; }
+    int32_t cooling() const { return learnedCool; }
+};
+
+#endif // HEATER_MODEL_H
@@ -0,0 +1,156 @@
+#ifndef NOTIFY_SCHEDULER_H
+#define NOTIFY_SCHEDULER_H
+
+#include <stdint.h>
+
+// ============================================================================
+// BLE NOTIFICATION SCHEDULER
+// ============================================================================
+//
+// Decides when a characteristic is worth a notification. The caller reduces
+// what the characteristic shows to a handful of integers (NotifyFields) and
+// polls its channel often; the payload is only formatted when poll() returns
+// true. A channel notifies when:
+//
+//   change     a field moved by at least its deadband from the value last
+//              sent (deadband 0: any change). The notify waits coalesceMs
+//              from the first change, so a burst (relay, fault and setpoint
+//              changing together) goes out as one.
+//   heartbeat  nothing was sent for heartbeatMs, so the phone can tell a
+//              steady reading from a dead link.
+//   force()    e.g. a new client subscribed.
+//
+// Counters (all since boot):
+//   sent        change-driven notifies
+//   heartbeats  heartbeat notifies
+//   coalesced   further changes folded into a pending notify
+//   suppressed  changes smaller than their deadband (counted when a field
+//               moves, not on every poll it stays off the sent value)
+
+template <uint8_t N>
+class NotifyFields {
+private:
+    int32_t values[N];
+    int32_t bands[N];
+    uint8_t count = 0;
+
+public:
+    // Add a field; extra fields past N are ignored
+    void add(int32_t value, int32_t deadband = 0) {
+        if (count < N) {
+            values[count] = value;
+            bands[count] = deadband;
+            count++;
+        }
+    }
+
+    uint8_t size() const { return count; }
+    int32_t value(uint8_t i) const { return values[i]; }
+    int32_t deadband(uint8_t i) const { return bands[i]; }
+};
+
+struct NotifyCounters {
+    uint32_t sent;
+    uint32_t heartbeats;
+    uint32_t coalesced;
+    uint32_t suppressed;
+};
+
+template <uint8_t N>
+class NotifyChannel {
+private:
+    uint32_t coalesceMs;
+    uint32_t heartbeatMs;
+
+    int32_t sentValues[N];
+    int32_t seenValues[N];      // As of the previous poll
+    uint8_t sentCount = 0;
+    bool haveSent = false;      // Nothing sent yet, or forced
+    uint32_t lastSentMs = 0;
+
+    bool pending = false;       // Change waiting out the coalescing window
+    uint32_t pendingSinceMs = 0;
+
+    NotifyCounters counters = {0, 0, 0, 0};
+
+    void commit(const NotifyFields<N>& fields, uint32_t nowMs) {
+        for (uint8_t i = 0; i < fields.size(); i++) {
+            sentValues[i] = fields.value(i);
+            seenValues[i] = fields.value(i);
+        }
+        sentCount = fields.size();
+        haveSent = true;
+        lastSentMs = nowMs;
+        pending = false;
+    }
+
+public:
+    NotifyChannel(uint32_t coalesceWindowMs, uint32_t maxSilenceMs)
+        : coalesceMs(coalesceWindowMs), heartbeatMs(maxSilenceMs) {}
+
+    /**
+     * Offer the current field values
+     * @return true if the caller should notify now; the values are then
+     *         taken as sent
+     */
+    bool poll(const NotifyFields<N>& fields, uint32_t nowMs) {
+        if (!haveSent) {
+            counters.sent++;
+            commit(fields, nowMs);
+            return true;
+        }
+
+        bool significant = (fields.size() != sentCount);
+        bool newSignificant = significant;
+        bool newSmall = false;
+        for (uint8_t i = 0; i < fields.size() && i < sentCount; i++) {
+            int64_t delta = (int64_t)fields.value(i) - sentValues[i];
+            if (delta < 0) {
+                delta = -delta;
+            }
+            bool moved = (fields.value(i) != seenValues[i]);
+            seenValues[i] = fields.value(i);
+            if (delta == 0) {
+                continue;
+            }
+            if (delta >= fields.deadband(i)) {
+                significant = true;
+                newSignificant |= moved;
+            } else {
+                newSmall |= moved;
+            }
+        }
+
+        if (significant) {
+            if (!pending) {
+                pending = true;
+                pendingSinceMs = nowMs;
+            } else if (newSignificant) {
+                counters.coalesced++;
+            }
+        } else if (newSmall) {
+            counters.suppressed++;
+        }
+
+        // A change can be undone inside the window (relay chatter); the
+        // pending notify still goes out and resyncs the phone.
+        if (pending && (nowMs - pendingSinceMs) >= coalesceMs) {
+            counters.sent++;
+            commit(fields, nowMs);
+            return true;
+        }
+        if ((nowMs - lastSentMs) >= heartbeatMs) {
+            counters.heartbeats++;
+            commit(fields, nowMs);
+            return true;
+        }
+        return false;
+    }
+
+    // Notify on the next poll regardless of changes
+    void force() { haveSent = false; }
+
+    const NotifyCounters& getCounters() const { return counters; }
+};
+
+#endif // NOTIFY_SCHEDULER_H
@@ -0,0 +1,192 @@
+#ifndef RECORDER_CODEC_H
+#define RECORDER_CODEC_H
+
+#include <stdint.h>
+#include <string.h>
+
+// ============================================================================
+// FLIGHT RECORDER PAGE FORMAT
+// ============================================================================
+//
+// The log is a sequence of REC_PAGE_SIZE pages. The first sample of each
+// heater zone on a page is a keyframe, so each page decodes on its own;
+// unused space at the end of a page is filled with REC_TAG_PAD. The
+// matching decoder is tools/decode_recorder.py.
+//
+// Samples of different zones are interleaved in the order the control task
+// produced them (round robin). A delta frame is relative to the previous
+// sample of the same zone and, unless it says otherwise, belongs to the zone
+// after the previous frame's zone. With one zone the zone fields stay zero.
+//
+// Keyframe (14 bytes)
+//   0x80 | flags       relay (bit 0) and owner (bit 5) as in a delta frame,
+//                      zone in bits 1-2, zone count - 1 in bits 3-4
+//   uint32 uptime_ms   little-endian
+//   int16  temp_c_x10  INT16_MIN = sensor fault
+//   uint16 setpoint_c_x10
+//   uint8  fault
+//   uint32 seq         sequence number of the command in force
+//
+// Delta frame (typically 2 bytes), one zone period after the previous
+// sample of its zone
+//   header             bit 0 relay, bit 1 setpoint follows, bit 2 fault
+//                      follows, bit 3 seq delta follows, bit 4 gap follows,
+//                      bit 5 command owner is wireless (not the UART
+//                      display), bit 6 zone follows,
+//                      bit 7 zero
+//   uint8  zone        if bit 6 (the round robin skipped a zone)
+//   varint             zig-zag temperature delta (always present)
+//   uint16 setpoint    if bit 1
+//   uint8  fault       if bit 2
+//   varint             zig-zag seq delta, if bit 3
+//   varint             zone periods skipped before this frame, if bit 4
+//
+// Varints are LEB128: 7 bits per byte, low group first, high bit = more.
+
+static constexpr uint16_t REC_PAGE_SIZE  = 256;    // One flash program page
+static constexpr uint8_t  REC_TAG_KEY    = 0x80;
+static constexpr uint8_t  REC_TAG_PAD    = 0xFF;
+static constexpr uint8_t  REC_MAX_FRAME  = 20;
+static constexpr uint8_t  REC_MAX_ZONES  = 4;
+
+static constexpr uint8_t  REC_BIT_RELAY    = 0x01;
+static constexpr uint8_t  REC_BIT_SETPOINT = 0x02;
+static constexpr uint8_t  REC_BIT_FAULT    = 0x04;
+static constexpr uint8_t  REC_BIT_SEQ      = 0x08;
+static constexpr uint8_t  REC_BIT_GAP      = 0x10;
+static constexpr uint8_t  REC_BIT_OWNER    = 0x20;
+static constexpr uint8_t  REC_BIT_ZONE     = 0x40;
+static constexpr uint8_t  REC_KEY_ZONE_SHIFT  = 1;
+static constexpr uint8_t  REC_KEY_COUNT_SHIFT = 3;
+
+struct RecorderSample {
+    uint32_t uptimeMs;
+    int16_t  temp_c_x10;        // INT16_MIN on sensor fault
+    uint16_t setpoint_c_x10;
+    uint8_t  relay;
+    uint8_t  fault;
+    uint8_t  owner;             // CommandSource of the command in force
+    uint8_t  zone;              // Heater zone, < REC_MAX_ZONES
+    uint32_t seq;
+};
+
+class RecorderPageEncoder {
+private:
+    uint8_t page[REC_PAGE_SIZE];
+    uint16_t fill = 0;
+    uint32_t periodMs;
+    uint8_t zoneCount;
+    uint32_t pageStartMs = 0;
+    RecorderSample prev[REC_MAX_ZONES];     // Last sample of each zone on this page
+    uint8_t zonesOnPage = 0;                // Bit per zone that has a keyframe
+    uint8_t lastZone = 0;
+
+    static uint8_t putVarint(uint8_t* out, uint32_t value) {
+        uint8_t n = 0;
+        while (value >= 0x80) {
+            out[n++] = (uint8_t)(value | 0x80);
+            value >>= 7;
+        }
+        out[n++] = (uint8_t)value;
+        return n;
+    }
+
+    static uint32_t zigzag(int32_t value) {
+        return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+    }
+
+    static uint8_t flagsOf(const RecorderSample& s) {
+        return (s.relay ? REC_BIT_RELAY : 0) | (s.owner ? REC_BIT_OWNER : 0);
+    }
+
+    uint8_t encodeKey(const RecorderSample& s, uint8_t* out) const {
+        out[0] = REC_TAG_KEY | flagsOf(s) |
+                 (uint8_t)(s.zone << REC_KEY_ZONE_SHIFT) |
+                 (uint8_t)((zoneCount - 1) << REC_KEY_COUNT_SHIFT);
+        memcpy(out + 1, &s.uptimeMs, 4);
+        memcpy(out + 5, &s.temp_c_x10, 2);
+        memcpy(out + 7, &s.setpoint_c_x10, 2);
+        out[9] = s.fault;
+        memcpy(out + 10, &s.seq, 4);
+        return 14;
+    }
+
+    uint8_t encodeDelta(const RecorderSample& s, uint8_t* out) const {
+        const RecorderSample& prev = this->prev[s.zone];
+        uint8_t header = flagsOf(s);
+        uint8_t n = 1;
+
+        if (s.zone != (lastZone + 1) % zoneCount) {
+            header |= REC_BIT_ZONE;
+            out[n++] = s.zone;
+        }
+        n += putVarint(out + n, zigzag((int32_t)s.temp_c_x10 - prev.temp_c_x10));
+        if (s.setpoint_c_x10 != prev.setpoint_c_x10) {
+            header |= REC_BIT_SETPOINT;
+            memcpy(out + n, &s.setpoint_c_x10, 2);
+            n += 2;
+        }
+        if (s.fault != prev.fault) {
+            header |= REC_BIT_FAULT;
+            out[n++] = s.fault;
+        }
+        if (s.seq != prev.seq) {
+            header |= REC_BIT_SEQ;
+            n += putVarint(out + n, zigzag((int32_t)(s.seq - prev.seq)));
+        }
+        uint32_t ticks = (s.uptimeMs - prev.uptimeMs + periodMs / 2) / periodMs;
+        if (ticks > 1) {
+            header |= REC_BIT_GAP;
+            n += putVarint(out + n, ticks - 1);
+        }
+        out[0] = header;
+        return n;
+    }
+
+public:
+    // tickPeriodMs is the sample period of each zone
+    RecorderPageEncoder(uint32_t tickPeriodMs, uint8_t zones)
+        : periodMs(tickPeriodMs),
+          zoneCount(zones == 0 ? 1 : (zones > REC_MAX_ZONES ? REC_MAX_ZONES : zones)) {
+        memset(prev, 0, sizeof(prev));
+    }
+
+    // Add a sample; false if the page has no room (flush, startPage(), retry).
+    // Samples for zones >= the configured count are ignored.
+    bool append(const RecorderSample& s) {
+        if (s.zone >= zoneCount) {
+            return true;
+        }
+        uint8_t bit = (uint8_t)(1 << s.zone);
+        uint8_t frame[REC_MAX_FRAME];
+        uint8_t len = (zonesOnPage & bit) ? encodeDelta(s, frame) : encodeKey(s, frame);
+        if (fill + len > REC_PAGE_SIZE) {
+            return false;
+        }
+        if (fill == 0) {
+            pageStartMs = s.uptimeMs;
+        }
+        memcpy(page + fill, frame, len);
+        fill += len;
+        prev[s.zone] = s;
+        zonesOnPage |= bit;
+        lastZone = s.zone;
+        return true;
+    }
+
+    bool empty() const { return fill == 0; }
+    uint32_t startMs() const { return pageStartMs; }
+
+    // Pad the unused tail; the page is then ready to write
+    const uint8_t* finish() {
+        memset(page + fill, REC_TAG_PAD, REC_PAGE_SIZE - fill);
+        return page;
+    }
+
+    void startPage() {
+        fill = 0;
+        zonesOnPage = 0;
+    }
+};
+
+#endif // RECORDER_CODEC_H
@@ -0,0 +1,176 @@
+#ifndef TEMP_FILTER_H
+#define TEMP_FILTER_H
+
+#include <stdint.h>
+
+// ============================================================================
+// FIXED-POINT FILTER PIPELINE
+// ============================================================================
+//
+// Every stage works in deci-degrees (°C × 10) held in int32_t and exposes:
+//
+//   int32_t update(int32_t x);   // Push one sample, return the filtered value
+//   void    reset();             // Forget history (e.g. after a sensor fault)
+//
+// Stages are chained at compile time with FilterChain<...>, so there is no
+// virtual dispatch and no float math in the sample path. Integer sums are
+// exact: unlike a running float sum, nothing drifts over a long session.
+
+// Divide and round half away from zero (den > 0)
+inline int32_t divRound(int32_t num, int32_t den) {
+    return (num >= 0) ? (num + den / 2) / den : -((-num + den / 2) / den);
+}
+
+// ----------------------------------------------------------------------------
+// Median of 3 - rejects a single-sample spike with one sample of delay
+// ----------------------------------------------------------------------------
+class Median3 {
+private:
+    int32_t window[3] = {0, 0, 0};
+    uint8_t count = 0;
+    uint8_t index = 0;
+
+public:
+    int32_t update(int32_t x) {
+        window[index] = x;
+        index = (index + 1) % 3;
+        if (count < 3) {
+            count++;
+            return x;   // Not enough history yet: pass through
+        }
+
+        int32_t a = window[0], b = window[1], c = window[2];
+        if (a > b) { int32_t t = a; a = b; b = t; }
+        if (b > c) { b = c; }
+        return (a > b) ? a : b;
+    }
+
+    void reset() {
+        count = 0;
+        index = 0;
+    }
+};
+
+// ----------------------------------------------------------------------------
+// Moving average over N samples - exact integer sum
+// ----------------------------------------------------------------------------
+template <uint8_t N>
+class MovingAverage {
+private:
+    int32_t samples[N];
+    int32_t sum = 0;
+    uint8_t index = 0;
+    uint8_t count = 0;
+
+public:
+    int32_t update(int32_t x) {
+        if (count == N) {
+            sum -= samples[index];
+        } else {
+            count++;
+        }
+        samples[index] = x;
+        sum += x;
+        index = (index + 1) % N;
+        return divRound(sum, count);
+    }
+
+    void reset() {
+        sum = 0;
+        index = 0;
+        count = 0;
+    }
+};
+
+// ----------------------------------------------------------------------------
+// Exponential moving average, alpha = 1 / 2^SHIFT
+// ----------------------------------------------------------------------------
+// State keeps FRAC_BITS extra fractional bits so small steps are not lost to
+// truncation (a plain integer EMA stalls up to 2^SHIFT - 1 counts short of
+// the input).
+template <uint8_t SHIFT>
+class Ema {
+private:
+    static constexpr uint8_t FRAC_BITS = 8;
+    int32_t state = 0;      // deci-degrees << FRAC_BITS
+    bool primed = false;
+
+public:
+    int32_t update(int32_t x) {
+        int32_t scaled = x * (1 << FRAC_BITS);
+        if (!primed) {
+            state = scaled;
+            primed = true;
+        } else {
+            state += (scaled - state) >> SHIFT;
+        }
+        return (state + (1 << (FRAC_BITS - 1))) >> FRAC_BITS;
+    }
+
+    void reset() { primed = false; }
+};
+
+// ----------------------------------------------------------------------------
+// Scalar Kalman filter, constant-temperature process model
+// ----------------------------------------------------------------------------
+// Q is the process noise and R the measurement noise per sample, both in
+// deci-degrees squared (R = 25 means a 0.5 °C standard deviation). The gain
+// settles to a fixed value, but reacts faster than a fixed EMA right after a
+// reset. Variance is carried with 8 fractional bits and the gain as Q16.
+template <uint32_t Q, uint32_t R>
+class Kalman1D {
+private:
+    static constexpr uint8_t FRAC_BITS = 8;
+    int32_t estimate = 0;       // deci-degrees << FRAC_BITS
+    uint32_t variance = 0;      // deci-degrees² << FRAC_BITS
+    bool primed = false;
+
+public:
+    int32_t update(int32_t x) {
+        int32_t scaled = x * (1 << FRAC_BITS);
+        if (!primed) {
+            estimate = scaled;
+            variance = R << FRAC_BITS;
+            primed = true;
+        } else {
+            variance += Q << FRAC_BITS;
+            uint32_t gain = (uint32_t)(((uint64_t)variance << 16) /
+                                       (variance + (R << FRAC_BITS)));
+            estimate += (int32_t)(((int64_t)(scaled - estimate) * gain) >> 16);
+            variance = (uint32_t)(((uint64_t)variance * (65536 - gain)) >> 16);
+        }
+        return (estimate + (1 << (FRAC_BITS - 1))) >> FRAC_BITS;
+    }
+
+    void reset() { primed = false; }
+};
+
+// ----------------------------------------------------------------------------
+// Compile-time chain: FilterChain<Median3, MovingAverage<4>, ...>
+// ----------------------------------------------------------------------------
+template <typename... Stages>
+class FilterChain;
+
+template <>
+class FilterChain<> {
+public:
+    int32_t update(int32_t x) { return x; }
+    void reset() {}
+};
+
+template <typename First, typename... Rest>
+class FilterChain<First, Rest...> {
+private:
+    First first;
+    FilterChain<Rest...> rest;
+
+public:
+    int32_t update(int32_t x) { return rest.update(first.update(x)); }
+
+    void reset() {
+        first.reset();
+        rest.reset();
+    }
+};
+
+#endif // TEMP_FILTER_H
@@ -0,0 +1,82 @@
+#ifndef TICK_STATS_H
+#define TICK_STATS_H
+
+#include <stdint.h>
+#include <string.h>
+
+// ============================================================================
+// CONTROL TICK LATENCY STATISTICS
+// ============================================================================
+//
+// Latency is how late the control task started relative to its ideal tick
+// time. Samples go into a linear histogram (BUCKET_US wide, the last bucket
+// catches everything longer), which gives a p99 without storing samples. The
+// p99 is reported as the upper edge of its bucket, so it errs high.
+//
+// Statistics are collected over a window of ticks; the owner publishes a
+// snapshot at the end of each window and starts a new one, so a single stall
+// at boot does not pin the max forever.
+
+struct TickStatsSnapshot {
+    uint32_t ticks;     // Ticks run in the window
+    uint32_t missed;    // Ticks skipped because the previous one overran
+    uint32_t minUs;
+    uint32_t maxUs;
+    uint32_t p99Us;
+};
+
+class TickLatencyStats {
+public:
+    static constexpr uint32_t BUCKET_US = 16;
+    static constexpr uint16_t BUCKETS = 128;    // 0 - 2 ms in 16 µs steps
+
+private:
+    uint32_t histogram[BUCKETS];
+    uint32_t ticks = 0;
+    uint32_t missed = 0;
+    uint32_t minUs = UINT32_MAX;
+    uint32_t maxUs = 0;
+
+public:
+    TickLatencyStats() { reset(); }
+
+    void reset() {
+        memset(histogram, 0, sizeof(histogram));
+        ticks = 0;
+        missed = 0;
+        minUs = UINT32_MAX;
+        maxUs = 0;
+    }
+
+    void record(uint32_t latencyUs, uint32_t missedTicks) {
+        uint32_t bucket = latencyUs / BUCKET_US;
+        histogram[bucket < BUCKETS ? bucket : BUCKETS - 1]++;
+        ticks++;
+        missed += missedTicks;
+        if (latencyUs < minUs) minUs = latencyUs;
+        if (latencyUs > maxUs) maxUs = latencyUs;
+    }
+
+    uint32_t count() const { return ticks; }
+
+    TickStatsSnapshot snapshot() const {
+        TickStatsSnapshot snap = {ticks, missed, ticks ? minUs : 0, maxUs, 0};
+
+        // Smallest latency that at least 99% of ticks did not exceed
+        uint32_t target = ticks - ticks / 100;
+        uint32_t seen = 0;
+        for (uint16_t i = 0; i < BUCKETS && ticks > 0; i++) {
+            seen += histogram[i];
+            if (seen >= target) {
+                snap.p99Us = (i == BUCKETS - 1) ? maxUs : (i + 1) * BUCKET_US;
+                break;
+            }
+        }
+        if (snap.p99Us > maxUs) {
+            snap.p99Us = maxUs;
+        }
+        return snap;
+    }
+};
+
+#endif // TICK_STATS_H
@@ -2,14 +2,17 @@
  * Smart Oil Heater Controller - Control Board
  *
  * Hardware: ESP32 DevKit v1
- * - MAX6675 K-type thermocouple (SPI)
- * - Relay module (active HIGH assumed, change RELAY_ACTIVE_HIGH if needed)
+ * - One MAX6675 K-type thermocouple (SPI) and one relay per heater zone
+ * - Relay modules (active HIGH assumed, change RELAY_ACTIVE_HIGH if needed)
  * - UART serial communication with UI board (Serial2 on GPIO 16/17)
+ * - Optional ESP-NOW link to a wireless pit display
  *
  * Safety Features:
  * - Watchdog: Heater OFF if no UI command in 5 seconds
  * - Overtemp cutoff: Hard shutdown at MAX_SAFE_TEMP_C
- * - Sensor fault detection: Heater OFF if thermocouple disconnected
+ * - Sensor fault detection: Zone heater OFF if its thermocouple is disconnected
+ * - Heater fault model: stuck relay, open element and detached probe from
+ *   the rate of rise (include/heater_model.h)
  */
 
 #include <Arduino.h>
@@ -19,26 +22,73 @@
 #include <BLEServer.h>
 #include <BLEUtils.h>
 #include <BLE2902.h>
+#include <Preferences.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/queue.h>
+#include <freertos/semphr.h>
+#include <esp_timer.h>
+#include <esp_now.h>
+#include <esp_wifi.h>
+#include "cobs_link.h"
+#include "temp_filter.h"
+#include "calibration_table.h"
+#include "tick_stats.h"
+#include "command_arbiter.h"
+#include "flight_recorder.h"
+#include "espnow_link.h"
+#include "heater_model.h"
+#include "notify_scheduler.h"
 
 // ============================================================================
 // HARDWARE CONFIGURATION - ADJUST TO YOUR WIRING
 // ============================================================================
 
-// MAX6675 SPI pins (bit-bang, so any GPIO works)
+// MAX6675 SPI pins (bit-bang, so any GPIO works). All thermocouples share
+// clock and data; each zone has its own chip select.
 static constexpr int PIN_THERMO_SCK = 18;  // Clock
-static constexpr int PIN_THERMO_CS  = 5;   // Chip Select
 static constexpr int PIN_THERMO_SO  = 19;  // Data Out (MISO)
 
-// Relay control
-static constexpr int PIN_RELAY = 23;
 static constexpr bool RELAY_ACTIVE_HIGH = true;  // Set false if relay is active-LOW
 
+// Heater zones - one thermocouple, relay, setpoint and calibration table
+// each, up to MAX_ZONES. Zone 0 is the one legacy display firmware and the
+// single-value BLE characteristics report. A second zone is one more line,
+// e.g. an oil sump on CS GPIO 4 and relay GPIO 22:
+//     { "sump", 4, 22 },
+struct ZoneConfig {
+    const char* name;
+    int csPin;                  // MAX6675 chip select
+    int relayPin;
+};
+
+static constexpr ZoneConfig ZONES[] = {
+    { "tank", 5, 23 },
+};
+static constexpr uint8_t ZONE_COUNT = sizeof(ZONES) / sizeof(ZONES[0]);
+
 // UART for display communication
 #define UI_SERIAL Serial2
 static constexpr int UI_RX_PIN = 16;
 static constexpr int UI_TX_PIN = 17;
 static constexpr int UI_BAUD = 115200;
 
+// Framed link: COBS + CRC-16 (see include/cobs_link.h). Set false only to talk
+// to display firmware that still sends bare packets.
+static constexpr bool UI_LINK_FRAMED = true;
+
+// ESP-NOW link to a wireless pit display (see include/espnow_link.h). Runs
+// alongside the UART link; commands from both go through the same arbiter
+// and watchdog. Serial 'p' reopens the pairing window.
+static constexpr bool     ESPNOW_ENABLED    = true;
+static constexpr uint8_t  ESPNOW_CHANNEL    = 1;        // Must match the pit display
+static constexpr uint32_t PAIRING_WINDOW_MS = 60000;    // At boot when unpaired, and after 'p'
+
+// Link encryption keys, 16 bytes each. Must match the pit display; change
+// both from these defaults for your own boards.
+static const uint8_t ESPNOW_PMK[16] = {'o','i','l','-','h','e','a','t','e','r','-','p','m','k','0','1'};
+static const uint8_t ESPNOW_LMK[16] = {'o','i','l','-','h','e','a','t','e','r','-','l','m','k','0','1'};
+
 // ============================================================================
 // CONTROL PARAMETERS
 // ============================================================================
@@ -49,10 +99,60 @@ static constexpr float MAX_SAFE_TEMP_C    = 160.0f;   // Hard cutoff (~320°F)
 static constexpr float MIN_SETPOINT_C     = 50.0f;    // Minimum allowed setpoint
 static constexpr float MAX_SETPOINT_C     = 150.0f;   // Maximum allowed setpoint
 
+// Heater fault model (see include/heater_model.h). Rates in °C × 10 per
+// minute. A latched fault clears when the zone is disabled and re-enabled.
+static constexpr uint32_t HEATER_LAG_MS        = 20000;  // No rate checks after a relay change
+static constexpr uint32_t HEATER_WINDOW_MS     = 30000;  // Rise measured over this long
+static constexpr int32_t  HEATER_MIN_RISE      = 6;      // Slowest healthy element gain (0.6 °C/min)
+static constexpr int32_t  HEATER_NOMINAL_RISE  = 30;     // Initial guess, then learned (3 °C/min)
+static constexpr int32_t  PROBE_DETACH_FALL    = 300;    // Faster fall = probe off the tank (0.5 °C/s)
+static constexpr uint8_t  PROBE_DETACH_CONFIRM = 8;      // Samples (2 s)
+
 static constexpr uint32_t CMD_TIMEOUT_MS  = 5000;     // Safety watchdog timeout
-static constexpr uint32_t TEMP_READ_MS    = 250;      // MAX6675 read interval
+static constexpr uint32_t TEMP_READ_MS    = 250;      // Per-zone sample period (MAX6675 needs >= 220 ms)
 static constexpr uint32_t STATUS_SEND_MS  = 250;      // Status broadcast interval
-static constexpr uint32_t BLE_UPDATE_MS   = 500;      // BLE notification interval
+static constexpr uint32_t HEALTH_REPORT_MS = 10000;   // Link / tick statistics report interval
+
+// BLE notifications are change-driven (see include/notify_scheduler.h):
+// temperature and status are checked every BLE_POLL_MS, but only notified
+// when a field moves past its deadband, or after BLE_HEARTBEAT_MS of silence.
+static constexpr uint32_t BLE_POLL_MS       = 100;     // Change check interval
+static constexpr uint32_t BLE_COALESCE_MS   = 250;     // Changes within this go out as one notify
+static constexpr uint32_t BLE_HEARTBEAT_MS  = 5000;    // Max silence per characteristic
+static constexpr uint32_t BLE_RESYNC_MS     = 1000;    // After connect, once the phone has subscribed
+static constexpr int32_t  BLE_TEMP_DEADBAND = 5;       // °F × 10
+
+// ============================================================================
+// CONTROL TASK
+// ============================================================================
+// An esp_timer fires every CONTROL_TICK_US and wakes a dedicated task that
+// serves one zone per tick, round robin: read its thermocouple, evaluate
+// faults and drive its relay. Each MAX6675 is therefore read every
+// TEMP_READ_MS, and its next conversion (started when CS goes high) runs
+// while the other chips are read. loop() (priority 1) keeps the display
+// link, BLE updates and serial output, so none of that can delay a control
+// decision. The BLE host runs on core 0; control stays on core 1.
+
+static constexpr uint32_t    CONTROL_TICK_US       = TEMP_READ_MS * 1000 / ZONE_COUNT;
+static constexpr UBaseType_t CONTROL_TASK_PRIORITY = 5;
+static constexpr BaseType_t  CONTROL_TASK_CORE     = 1;
+static constexpr uint32_t    CONTROL_TASK_STACK    = 4096;
+static constexpr uint32_t    TICK_STATS_WINDOW     = 240 * ZONE_COUNT;  // Ticks per published window (1 min)
+static constexpr uint32_t    COMMAND_QUEUE_LENGTH  = 8;
+
+// ============================================================================
+// FLIGHT RECORDER
+// ============================================================================
+// Every zone reading is logged to LittleFS (see include/flight_recorder.h).
+// The control task only queues a sample; loop() encodes it and writes full
+// pages. When a fault starts, the preceding RECORDER_PIN_WINDOW_MS is copied
+// to its own file. Serial 'l' lists the files, 'd' dumps them as hex for
+// tools/decode_recorder.py.
+
+static constexpr uint32_t RECORDER_PIN_WINDOW_MS  = 5UL * 60 * 1000;  // History kept per fault
+static constexpr uint32_t RECORDER_PIN_HOLDOFF_MS = 60UL * 1000;      // Min time between pins
+static constexpr uint32_t RECORDER_QUEUE_LENGTH   = 16 * ZONE_COUNT;  // 4 s of samples
+static constexpr uint8_t  RECORDER_DUMP_LINES     = 4;                // Hex lines per loop()
 
 // ============================================================================
 // BLE CONFIGURATION
@@ -81,15 +181,23 @@ static constexpr uint32_t BLE_UPDATE_MS   = 500;      // BLE notification interv
 
 // Characteristics
 // packages/ble: OIL_HEATER_CHARS.*
+// 26ab-26ad are used by SmartHeaterController under the same service UUID
+// (its include/ble_protocol.h), so CALIBRATION sits at 26ae.
 #define BLE_CHAR_TEMP_UUID      "beb5483e-36e1-4688-b7f5-ea07361b26a8"  // TEMPERATURE - ASCII string
 #define BLE_CHAR_SETPOINT_UUID  "beb5483e-36e1-4688-b7f5-ea07361b26a9"  // SETPOINT - ASCII string (R/W)
 #define BLE_CHAR_STATUS_UUID    "beb5483e-36e1-4688-b7f5-ea07361b26aa"  // STATUS - JSON
+#define BLE_CHAR_CAL_UUID       "beb5483e-36e1-4688-b7f5-ea07361b26ae"  // CALIBRATION - ASCII command (W) / JSON (R)
 
 // ============================================================================
 // THERMOCOUPLE CALIBRATION CONFIGURATION
 // ============================================================================
 
 /**
+ * Calibration is a runtime table of up to 8 (raw, reference) points stored in
+ * NVS and edited over BLE or the display link (see include/calibration_table.h
+ * and the README). The modes below are only the factory default, used to seed
+ * the table the first time the controller boots with an empty NVS.
+ *
  * CALIBRATION MODES:
  *
  * CAL_NONE      - No calibration, use raw MAX6675 readings
@@ -144,6 +252,11 @@ static constexpr float CAL_RAW_BOIL_C = 100.0f;  // Your boiling water reading
 static constexpr float CAL_REF_ICE_C  = 0.0f;    // Ice point (always 0°C)
 static constexpr float CAL_REF_BOIL_C = 100.0f;  // Boiling point (~99°C at altitude)
 
+// NVS storage for the calibration table
+static constexpr const char* NVS_NAMESPACE = "heater";
+static constexpr const char* NVS_CAL_KEY   = "cal_table";   // Zone 0; zone n appends n
+static constexpr const char* NVS_PEER_KEY  = "espnow_peer"; // Paired pit display MAC
+
 // ============================================================================
 // UART PROTOCOL (same packets as ESP-NOW version)
 // ============================================================================
@@ -151,6 +264,8 @@ static constexpr float CAL_REF_BOIL_C = 100.0f;  // Boiling point (~99°C at alt
 // Magic numbers for packet validation
 static constexpr uint32_t MAGIC_UI2CTRL = 0x55494331;  // "UIC1"
 static constexpr uint32_t MAGIC_CTRL2UI = 0x43554931;  // "CUI1"
+static constexpr uint32_t MAGIC_CAL     = 0x43414C31;  // "CAL1"
+static constexpr uint32_t MAGIC_PAIR    = 0x50414952;  // "PAIR"
 
 // Fault codes
 enum FaultCode : uint8_t {
@@ -158,68 +273,250 @@ enum FaultCode : uint8_t {
     FAULT_SENSOR_OPEN  = 1,
     FAULT_OVERTEMP     = 2,
     FAULT_COMM_TIMEOUT = 3,
+    FAULT_STUCK_RELAY  = 4,   // Heating with the relay off (latched)
+    FAULT_OPEN_ELEMENT = 5,   // Relay on, no heating (latched)
+    FAULT_PROBE_DETACHED = 6, // Implausibly fast fall (latched)
 };
 
+// Zone slots in the status packet (upper limit for ZONE_COUNT)
+static constexpr uint8_t MAX_ZONES = 4;
+
+// ZoneStatus.flags
+static constexpr uint8_t ZONE_FLAG_RELAY   = 0x01;
+static constexpr uint8_t ZONE_FLAG_ENABLED = 0x02;
+
 #pragma pack(push, 1)
 // Command from UI to Controller
 struct UiToCtrlPacket {
     uint32_t magic;           // Must be MAGIC_UI2CTRL
     uint16_t setpoint_c_x10;  // Setpoint in °C × 10
     uint8_t  enable;          // 0 = disabled, 1 = enabled
-    uint8_t  reserved;
+    uint8_t  zone;            // Heater zone (was reserved, so v1 senders address zone 0)
     uint32_t seq;             // Sequence number
 };
 
+// One heater zone in the status packet
+struct ZoneStatus {
+    int16_t  temp_c_x10;      // INT16_MIN on fault
+    uint16_t setpoint_c_x10;
+    uint8_t  flags;           // ZONE_FLAG_*
+    uint8_t  fault_code;      // FaultCode enum
+};
+
 // Status from Controller to UI
 struct CtrlToUiPacket {
     uint32_t magic;           // MAGIC_CTRL2UI
-    int16_t  temp_c_x10;      // Current temp in °C × 10 (INT16_MIN on fault)
-    uint16_t setpoint_c_x10;  // Current setpoint × 10
-    uint8_t  relay_on;        // 0 or 1
-    uint8_t  fault_code;      // FaultCode enum
+    int16_t  temp_c_x10;      // Zone 0 temp in °C × 10 (INT16_MIN on fault)
+    uint16_t setpoint_c_x10;  // Zone 0 setpoint × 10
+    uint8_t  relay_on;        // Zone 0 relay, 0 or 1
+    uint8_t  fault_code;      // Zone 0 FaultCode enum
     uint32_t uptime_s;        // Uptime in seconds
     uint32_t seq_echo;        // Last received command seq
+
+    // v2 tail - control tick latency over the last TICK_STATS_WINDOW ticks.
+    // Sent on the framed link only; v1 receivers read the first 18 bytes.
+    uint16_t tick_min_us;
+    uint16_t tick_max_us;
+    uint16_t tick_p99_us;
+    uint16_t tick_missed;     // Ticks skipped because the previous one overran
+
+    // v3 tail - every zone, including zone 0 again
+    uint8_t  zone_count;
+    ZoneStatus zones[MAX_ZONES];  // Entries >= zone_count are zero
+};
+
+static constexpr size_t CTRL_TO_UI_V1_SIZE = 18;
+static constexpr size_t CTRL_TO_UI_V2_SIZE = 26;
+
+// Calibration operations (shared by the display link and BLE)
+enum CalOp : uint8_t {
+    CAL_OP_QUERY   = 0,       // Just report the table
+    CAL_OP_CAPTURE = 1,       // Add a point: current raw reading = ref_c_x10
+    CAL_OP_SET     = 2,       // Add a point: raw_c_x10 = ref_c_x10
+    CAL_OP_REMOVE  = 3,       // Remove point at index
+    CAL_OP_CLEAR   = 4,       // Remove all points (uncalibrated)
+    CAL_OP_FACTORY = 5,       // Reload the compiled-in default
+};
+
+// Calibration command from UI to Controller
+struct CalCommandPacket {
+    uint32_t magic;           // MAGIC_CAL
+    uint8_t  op;              // CalOp
+    uint8_t  index;           // CAL_OP_REMOVE
+    int16_t  raw_c_x10;       // CAL_OP_SET
+    int16_t  ref_c_x10;       // CAL_OP_CAPTURE, CAL_OP_SET
+    uint8_t  zone;            // v2; v1 packets (without it) address zone 0
+};
+
+static constexpr size_t CAL_COMMAND_V1_SIZE = 10;
+
+// Calibration table from Controller to UI (reply to every CalCommandPacket)
+struct CalTablePacket {
+    uint32_t magic;           // MAGIC_CAL
+    uint8_t  result;          // 1 = command applied, 0 = rejected
+    uint8_t  count;           // Valid entries in points[]
+    int16_t  live_raw_c_x10;  // Averaged raw reading (INT16_MIN on fault)
+    CalPoint points[CAL_MAX_POINTS];
+    uint8_t  zone;            // v2: zone this table belongs to
+};
+
+// ESP-NOW pairing request (display, broadcast) and reply (controller, unicast)
+struct PairPacket {
+    uint32_t magic;           // MAGIC_PAIR
+    uint8_t  zone_count;      // Reply: zones on this controller; request: 0
 };
 #pragma pack(pop)
 
+// Frame types on the framed link (first byte inside each COBS frame)
+enum LinkFrameType : uint8_t {
+    FRAME_UI_COMMAND  = 0x01,  // UiToCtrlPacket
+    FRAME_CTRL_STATUS = 0x02,  // CtrlToUiPacket
+    FRAME_CAL_COMMAND = 0x03,  // CalCommandPacket
+    FRAME_CAL_TABLE   = 0x04,  // CalTablePacket
+    FRAME_PAIR_REQUEST = 0x05, // PairPacket (ESP-NOW only)
+    FRAME_PAIR_ACCEPT  = 0x06, // PairPacket (ESP-NOW only)
+};
+
+// Largest payload carried in one frame
+static constexpr size_t UI_LINK_MAX_PAYLOAD = 64;
+static_assert(sizeof(CalTablePacket) <= UI_LINK_MAX_PAYLOAD, "CalTablePacket exceeds link frame");
+static_assert(sizeof(CtrlToUiPacket) <= UI_LINK_MAX_PAYLOAD, "CtrlToUiPacket exceeds link frame");
+static_assert(offsetof(CtrlToUiPacket, tick_min_us) == CTRL_TO_UI_V1_SIZE, "CtrlToUiPacket v1 prefix changed");
+static_assert(offsetof(CtrlToUiPacket, zone_count) == CTRL_TO_UI_V2_SIZE, "CtrlToUiPacket v2 prefix changed");
+static_assert(offsetof(CalCommandPacket, zone) == CAL_COMMAND_V1_SIZE, "CalCommandPacket v1 prefix changed");
+static_assert(ZONE_COUNT >= 1 && ZONE_COUNT <= MAX_ZONES, "ZONES must list 1 to MAX_ZONES zones");
+static_assert(MAX_ZONES <= CMD_MAX_ZONES && MAX_ZONES <= REC_MAX_ZONES, "MAX_ZONES exceeds arbiter / recorder");
+
 // ============================================================================
 // GLOBALS
 // ============================================================================
 
-MAX6675 thermocouple(PIN_THERMO_SCK, PIN_THERMO_CS, PIN_THERMO_SO);
+// Temperature smoothing - fixed-point pipeline in deci-degrees (see
+// include/temp_filter.h). Median-of-3 drops single-sample spikes, the short
+// average takes out MAX6675 quantization noise. Alternatives:
+//   FilterChain<Median3, Ema<2>>                      // alpha 1/4, ~1 s lag
+//   FilterChain<Median3, MovingAverage<4>, Kalman1D<4, 9>>
+typedef FilterChain<Median3, MovingAverage<4>> TempFilter;
+
+static constexpr HeaterModelConfig HEATER_MODEL_CONFIG = {
+    TEMP_READ_MS, HEATER_LAG_MS, HEATER_WINDOW_MS, HEATER_MIN_RISE,
+    HEATER_NOMINAL_RISE, PROBE_DETACH_FALL, PROBE_DETACH_CONFIRM,
+};
+
+// Per-zone state. Setpoint, enable, reading, relay and fault are written by
+// the control task only and are single aligned words, which the ESP32 reads
+// and writes atomically.
+//
+// Calibration: point list + compiled lookup table (8 KB), persisted in NVS.
+// Edits arrive from the BLE task and the display link through g_calQueue and
+// are applied from loop() while holding g_calMutex; the control task holds it
+// for each lookup, so it never sees a half-rebuilt table.
+//
+// Heater model: rate-of-rise state, control task only.
+struct Zone {
+    MAX6675* thermocouple = nullptr;
+    float    setpointC = DEFAULT_SETPOINT_C;
+    bool     enabled = false;           // As commanded; faults gate the relay separately
+    bool     relayOn = false;
+    float    tempC = NAN;
+    uint8_t  fault = FAULT_NONE;
+
+    TempFilter filter;
+    FilterChain<Median3, MovingAverage<8>> rawFilter;   // ~2 s, for CAL_OP_CAPTURE
+    int16_t  rawTempX10 = INT16_MIN;
+
+    CalibrationTable cal;
+    volatile bool calChanged = false;   // Control task resets its filter
+
+    HeaterModel model{HEATER_MODEL_CONFIG};
+};
+
+static Zone g_zones[ZONE_COUNT];
 
-static float g_setpointC     = DEFAULT_SETPOINT_C;
-static bool  g_heaterEnabled = false;
-static bool  g_relayState    = false;
 static uint32_t g_lastCmdMs  = 0;
-static uint32_t g_lastCmdSeq = 0;
+static uint32_t g_lastCmdSeq = 0;       // Ack to the display (CtrlToUiPacket.seq_echo)
+
+// Setpoint / enable commands from every transport. Only the control task
+// drains the queue and writes the command state in g_zones.
+static QueueHandle_t g_cmdQueue = nullptr;
+static CommandArbiter g_arbiter(CMD_TIMEOUT_MS);
+static uint32_t g_cmdDropped = 0;       // Queue full
+static uint32_t g_bleCmdSeq = 0;        // Assigned to BLE writes that carry no seq
+static uint32_t g_bleAckSeq = 0;        // Ack to the phone (STATUS "ackSeq")
+static uint32_t g_cmdLatencyLastUs = 0; // Command received -> relay decision
+static uint32_t g_cmdLatencyMaxUs = 0;  // Max over the last tick statistics window
+
+// Flight recorder. Samples queued by the control task, written by loop().
+static FlightRecorder g_recorder(TEMP_READ_MS, ZONE_COUNT, RECORDER_PIN_WINDOW_MS, RECORDER_PIN_HOLDOFF_MS);
+static QueueHandle_t g_recQueue = nullptr;
+static uint32_t g_recDropped = 0;       // Queue full (loop() stalled)
 
 // UI connection tracking
 static bool g_uiConnected = false;
 
+// ESP-NOW pit display. The receive / send callbacks run in the WiFi task;
+// the pairing gate, counters and ack latency they share with loop() are
+// guarded by g_radioMux.
+struct RadioStats {
+    uint32_t rx;                // Frames from the paired display
+    uint32_t ignored;           // Frames from any other MAC
+    uint32_t bad;               // Paired, but wrong type / length / magic
+    uint32_t tx;
+    uint32_t txFail;            // esp_now_send error or no MAC-level ack
+    uint32_t pairings;
+};
+
+static bool g_radioReady = false;
+static RadioPeerGate g_radioGate;
+static portMUX_TYPE g_radioMux = portMUX_INITIALIZER_UNLOCKED;
+static RadioStats g_radioStats = {0, 0, 0, 0, 0, 0};
+static LatencyTracker g_radioAckLatency;    // esp_now_send -> MAC-level ack, per report window
+static uint32_t g_radioTxStartUs = 0;
+static QueueHandle_t g_pairQueue = nullptr;     // Pair request MACs, handled in loop()
+static uint32_t g_pitAckSeq = 0;        // Ack to the pit display (its CtrlToUiPacket.seq_echo)
+static volatile bool g_pitAckPending = false;   // Send status now: a pit command was processed
+static uint32_t g_lastPitStatusMs = 0;
+
+// Framed UART link to the display
+static CobsFrameParser<UI_LINK_MAX_PAYLOAD + 3> g_uiLink;
+static uint32_t g_uiBadPackets = 0;   // Frames with a good CRC but wrong type/length/magic
+static uint32_t g_lastHealthReportMs = 0;
+
 // Timing
-static uint32_t g_lastTempReadMs   = 0;
 static uint32_t g_lastStatusSendMs = 0;
 
-// Current readings
-static float    g_currentTempC = NAN;
-static uint8_t  g_currentFault = FAULT_NONE;
+// Control tick
+static TaskHandle_t g_controlTaskHandle = nullptr;
+static esp_timer_handle_t g_controlTimer = nullptr;
+static int64_t g_controlStartUs = 0;
+static portMUX_TYPE g_tickStatsMux = portMUX_INITIALIZER_UNLOCKED;
+static TickStatsSnapshot g_tickStats = {0, 0, 0, 0, 0};
 
-// Temperature smoothing - moving average filter
-static constexpr int NUM_SAMPLES = 15;  // Increased from 5 for more aggressive smoothing
-static float tempReadings[NUM_SAMPLES] = {0};
-static int readingIndex = 0;
-static float tempSum = 0.0f;
-static bool arrayFilled = false;
+// Calibration edits (see Zone)
+static Preferences g_prefs;
+static QueueHandle_t g_calQueue = nullptr;
+static SemaphoreHandle_t g_calMutex = nullptr;
+static uint8_t g_calViewZone = 0;       // Zone shown on the CAL characteristic
 
 // BLE globals
 static BLEServer* g_bleServer = nullptr;
 static BLECharacteristic* g_charTemp = nullptr;
 static BLECharacteristic* g_charSetpoint = nullptr;
 static BLECharacteristic* g_charStatus = nullptr;
+static BLECharacteristic* g_charCal = nullptr;
 static bool g_bleClientConnected = false;
 static uint32_t g_lastBleUpdateMs = 0;
 
+// Notification scheduling (loop only). STATUS: 5 top-level fields + 6 per zone.
+static constexpr uint8_t BLE_TEMP_FIELDS   = 1;
+static constexpr uint8_t BLE_STATUS_FIELDS = 5 + 6 * MAX_ZONES;
+static NotifyChannel<BLE_TEMP_FIELDS>   g_tempNotify(BLE_COALESCE_MS, BLE_HEARTBEAT_MS);
+static NotifyChannel<BLE_STATUS_FIELDS> g_statusNotify(BLE_COALESCE_MS, BLE_HEARTBEAT_MS);
+static volatile bool g_bleResync = false;       // Set on connect
+static volatile uint32_t g_bleConnectMs = 0;
+static uint8_t g_calShownZone = 0;              // Live reading on the CAL characteristic
+static int16_t g_calShownRawX10 = INT16_MIN;
+
 // ============================================================================
 // BLE CALLBACK CLASSES
 // ============================================================================
@@ -227,6 +524,8 @@ static uint32_t g_lastBleUpdateMs = 0;
 // Server callbacks - track connection state
 class BleServerCallbacks : public BLEServerCallbacks {
     void onConnect(BLEServer* pServer) {
+        g_bleConnectMs = millis();
+        g_bleResync = true;
         g_bleClientConnected = true;
         Serial.println("[BLE] Client connected");
     }
@@ -239,20 +538,110 @@ class BleServerCallbacks : public BLEServerCallbacks {
 };
 
 // Setpoint characteristic callback - receives setpoint in Fahrenheit as string
+bool queueCommand(uint8_t source, uint8_t zone, uint16_t setpointX10, uint8_t enable, uint32_t seq);
+
+/**
+ * Strip an optional "Z<n> " zone prefix from a BLE write
+ * @return zone index (0 without a prefix), or -1 if the zone does not exist
+ */
+int parseZonePrefix(const char*& text) {
+    if (text[0] != 'Z') {
+        return 0;
+    }
+    char* end = nullptr;
+    long zone = strtol(text + 1, &end, 10);
+    if (end == text + 1 || zone < 0 || zone >= ZONE_COUNT) {
+        return -1;
+    }
+    while (*end == ' ') {
+        end++;
+    }
+    text = end;
+    return (int)zone;
+}
+
+// Setpoint characteristic callback - receives setpoint in Fahrenheit as string,
+// optionally followed by the app's sequence number: "230.0" or "230.0,17".
+// A "Z<n> " prefix addresses another zone: "Z1 230.0,17".
 class SetpointCallbacks : public BLECharacteristicCallbacks {
     void onWrite(BLECharacteristic* pCharacteristic) {
         std::string value = pCharacteristic->getValue();
         if (value.length() > 0) {
+            const char* text = value.c_str();
+            int zone = parseZonePrefix(text);
+            if (zone < 0) {
+                Serial.printf("[BLE] Setpoint write for unknown zone: %s\n", value.c_str());
+                return;
+            }
+
             // Parse Fahrenheit string
-            float setpointF = atof(value.c_str());
+            float setpointF = 0.0f;
+            unsigned long seq = 0;
+            int fields = sscanf(text, "%f,%lu", &setpointF, &seq);
+            if (fields < 1) {
+                return;
+            }
+            if (fields < 2) {
+                seq = ++g_bleCmdSeq;
+            }
             // Convert F to C
             float setpointC = (setpointF - 32.0f) * 5.0f / 9.0f;
-            // Constrain and store
-            g_setpointC = constrain(setpointC, MIN_SETPOINT_C, MAX_SETPOINT_C);
-            // Reset watchdog timer (CRITICAL SAFETY)
-            g_lastCmdMs = millis();
+            setpointC = constrain(setpointC, MIN_SETPOINT_C, MAX_SETPOINT_C);
+
+            // Applied (and the watchdog refreshed) by the control task
+            queueCommand(CMD_SRC_BLE, (uint8_t)zone, (uint16_t)lroundf(setpointC * 10.0f),
+                         CMD_ENABLE_UNCHANGED, (uint32_t)seq);
+
+            Serial.printf("[BLE] Setpoint write: zone %d %.1fF (%.1fC) seq=%lu\n",
+                          zone, setpointF, setpointC, seq);
+        }
+    }
+};
+
+// Calibration characteristic callback - ASCII commands, temperatures in °C:
+//   "CAP <ref>"        capture current raw reading as <ref>
+//   "SET <raw> <ref>"  add a point
+//   "DEL <index>"      remove a point
+//   "CLR"              clear the table (uncalibrated)
+//   "FACTORY"          reload the compiled-in default
+// A "Z<n> " prefix addresses another zone's table: "Z1 CAP 100.0".
+class CalibrationCallbacks : public BLECharacteristicCallbacks {
+    void onWrite(BLECharacteristic* pCharacteristic) {
+        std::string value = pCharacteristic->getValue();
+        CalCommandPacket cmd = {};
+        cmd.magic = MAGIC_CAL;
+
+        float a = 0.0f, b = 0.0f;
+        int index = 0;
+        const char* text = value.c_str();
+        int zone = parseZonePrefix(text);
+        if (zone < 0) {
+            Serial.printf("[BLE] Calibration command for unknown zone: %s\n", value.c_str());
+            return;
+        }
+        cmd.zone = (uint8_t)zone;
+
+        if (sscanf(text, "CAP %f", &a) == 1) {
+            cmd.op = CAL_OP_CAPTURE;
+            cmd.ref_c_x10 = (int16_t)lroundf(a * 10.0f);
+        } else if (sscanf(text, "SET %f %f", &a, &b) == 2) {
+            cmd.op = CAL_OP_SET;
+            cmd.raw_c_x10 = (int16_t)lroundf(a * 10.0f);
+            cmd.ref_c_x10 = (int16_t)lroundf(b * 10.0f);
+        } else if (sscanf(text, "DEL %d", &index) == 1) {
+            cmd.op = CAL_OP_REMOVE;
+            cmd.index = (uint8_t)index;
+        } else if (strncmp(text, "CLR", 3) == 0) {
+            cmd.op = CAL_OP_CLEAR;
+        } else if (strncmp(text, "FACTORY", 7) == 0) {
+            cmd.op = CAL_OP_FACTORY;
+        } else {
+            Serial.printf("[BLE] Unknown calibration command: %s\n", text);
+            return;
+        }
 
-            Serial.printf("[BLE] Setpoint write: %.1fF (%.1fC)\n", setpointF, g_setpointC);
+        if (xQueueSend(g_calQueue, &cmd, 0) != pdTRUE) {
+            Serial.println("[BLE] Calibration queue full - command dropped");
         }
     }
 };
@@ -261,12 +650,12 @@ class SetpointCallbacks : public BLECharacteristicCallbacks {
 // RELAY CONTROL
 // ============================================================================
 
-void setRelay(bool on) {
-    g_relayState = on;
+void setRelay(uint8_t zone, bool on) {
+    g_zones[zone].relayOn = on;
     if (RELAY_ACTIVE_HIGH) {
-        digitalWrite(PIN_RELAY, on ? HIGH : LOW);
+        digitalWrite(ZONES[zone].relayPin, on ? HIGH : LOW);
     } else {
-        digitalWrite(PIN_RELAY, on ? LOW : HIGH);
+        digitalWrite(ZONES[zone].relayPin, on ? LOW : HIGH);
     }
 }
 
@@ -275,75 +664,161 @@ void setRelay(bool on) {
 // ============================================================================
 
 /**
- * Apply calibration to raw thermocouple reading based on selected mode
- * @param rawTempC Raw temperature from MAX6675 in °C
- * @return Calibrated temperature in °C
+ * Seed a zone's calibration table from the compiled-in CAL_MODE constants
+ * (the same factory default for every zone)
  */
-float calibrateTemperature(float rawTempC) {
+void loadFactoryCalibration(CalibrationTable& table) {
+    table.clear();
+
     switch (CAL_MODE) {
         case CAL_NONE:
-            // No calibration - return raw reading
-            return rawTempC;
+            break;
 
         case CAL_SINGLE:
-            // Single-point: just add offset
-            return rawTempC + CAL_SINGLE_OFFSET_C;
+            // One point = constant offset; the raw value itself does not matter
+            table.addPoint(1000, (int16_t)lroundf(1000 + CAL_SINGLE_OFFSET_C * 10.0f));
+            break;
 
-        case CAL_TWO_POINT: {
-            // Two-point: apply scale and offset
-            // Formula: calibrated = (raw - raw_ice) * scale + ref_ice
-            float scale = (CAL_REF_BOIL_C - CAL_REF_ICE_C) /
-                          (CAL_RAW_BOIL_C - CAL_RAW_ICE_C);
-            return (rawTempC - CAL_RAW_ICE_C) * scale + CAL_REF_ICE_C;
-        }
+        case CAL_TWO_POINT:
+            table.addPoint((int16_t)lroundf(CAL_RAW_ICE_C * 10.0f),
+                           (int16_t)lroundf(CAL_REF_ICE_C * 10.0f));
+            table.addPoint((int16_t)lroundf(CAL_RAW_BOIL_C * 10.0f),
+                           (int16_t)lroundf(CAL_REF_BOIL_C * 10.0f));
+            break;
+    }
+}
 
-        default:
-            return rawTempC;
+// NVS key of a zone's table; zone 0 keeps the single-zone key
+void calibrationKey(uint8_t zone, char* key, size_t len) {
+    if (zone == 0) {
+        snprintf(key, len, "%s", NVS_CAL_KEY);
+    } else {
+        snprintf(key, len, "%s%u", NVS_CAL_KEY, zone);
     }
 }
 
+void saveCalibration(uint8_t zone) {
+    char key[16];
+    calibrationKey(zone, key, sizeof(key));
+    CalBlob blob;
+    g_zones[zone].cal.toBlob(blob);
+    g_prefs.putBytes(key, &blob, sizeof(blob));
+}
+
 /**
- * Print calibration information at startup
+ * Load a zone's calibration table from NVS, falling back to the factory default
+ * @return true if a stored table was found
  */
-void printCalibrationInfo() {
-    Serial.println("[CAL] Thermocouple calibration:");
+bool loadCalibration(uint8_t zone) {
+    char key[16];
+    calibrationKey(zone, key, sizeof(key));
+    CalibrationTable& table = g_zones[zone].cal;
+    CalBlob blob;
+    if (g_prefs.getBytesLength(key) == sizeof(blob) &&
+        g_prefs.getBytes(key, &blob, sizeof(blob)) == sizeof(blob) &&
+        table.fromBlob(blob)) {
+        return true;
+    }
+    loadFactoryCalibration(table);
+    return false;
+}
 
-    switch (CAL_MODE) {
-        case CAL_NONE:
-            Serial.println("      Mode: NONE (raw readings)");
-            Serial.println("      Status: UNCALIBRATED");
-            break;
+/**
+ * Apply one calibration command (from BLE or the display link)
+ * @return true if the table changed
+ */
+bool applyCalCommand(const CalCommandPacket& cmd) {
+    if (cmd.zone >= ZONE_COUNT) {
+        Serial.printf("[CAL] Command for unknown zone %u rejected\n", cmd.zone);
+        return false;
+    }
+    Zone& zone = g_zones[cmd.zone];
 
-        case CAL_SINGLE:
-            Serial.println("      Mode: SINGLE-POINT");
-            Serial.printf("      Offset: %+.2f C\n", CAL_SINGLE_OFFSET_C);
-            if (CAL_SINGLE_OFFSET_C == 0.0f) {
-                Serial.println("      Status: NOT CONFIGURED");
-            } else {
-                Serial.println("      Status: CALIBRATED");
-            }
+    if (cmd.op == CAL_OP_CAPTURE && zone.rawTempX10 == INT16_MIN) {
+        Serial.printf("[CAL] Zone %u capture rejected: no sensor reading\n", cmd.zone);
+        return false;
+    }
+    int16_t capturedX10 = zone.rawTempX10;
+
+    // Table edits rebuild the lookup table (~4096 entries); keep the control
+    // task out while that happens, and do logging and NVS writes afterwards
+    bool changed = false;
+    xSemaphoreTake(g_calMutex, portMAX_DELAY);
+    switch (cmd.op) {
+        case CAL_OP_CAPTURE:
+            changed = zone.cal.addPoint(capturedX10, cmd.ref_c_x10);
+            break;
+        case CAL_OP_SET:
+            changed = zone.cal.addPoint(cmd.raw_c_x10, cmd.ref_c_x10);
+            break;
+        case CAL_OP_REMOVE:
+            changed = zone.cal.removePoint(cmd.index);
+            break;
+        case CAL_OP_CLEAR:
+            zone.cal.clear();
+            changed = true;
+            break;
+        case CAL_OP_FACTORY:
+            loadFactoryCalibration(zone.cal);
+            changed = true;
+            break;
+        default:
             break;
+    }
+    xSemaphoreGive(g_calMutex);
 
-        case CAL_TWO_POINT: {
-            Serial.println("      Mode: TWO-POINT");
-            Serial.printf("      Ice reading:  %.2f C (ref: %.2f C)\n",
-                          CAL_RAW_ICE_C, CAL_REF_ICE_C);
-            Serial.printf("      Boil reading: %.2f C (ref: %.2f C)\n",
-                          CAL_RAW_BOIL_C, CAL_REF_BOIL_C);
-
-            float scale = (CAL_REF_BOIL_C - CAL_REF_ICE_C) /
-                          (CAL_RAW_BOIL_C - CAL_RAW_ICE_C);
-            float offset = CAL_REF_ICE_C - (CAL_RAW_ICE_C * scale);
-            Serial.printf("      Calculated scale:  %.4f\n", scale);
-            Serial.printf("      Calculated offset: %+.2f C\n", offset);
-
-            if (CAL_RAW_ICE_C == 0.0f && CAL_RAW_BOIL_C == 100.0f) {
-                Serial.println("      Status: NOT CONFIGURED");
-            } else {
-                Serial.println("      Status: CALIBRATED");
-            }
+    switch (cmd.op) {
+        case CAL_OP_CAPTURE:
+            Serial.printf("[CAL] Zone %u capture raw %.1f C = ref %.1f C: %s\n", cmd.zone,
+                          capturedX10 / 10.0f, cmd.ref_c_x10 / 10.0f,
+                          changed ? "OK" : "rejected");
+            break;
+        case CAL_OP_SET:
+            Serial.printf("[CAL] Zone %u set raw %.1f C = ref %.1f C: %s\n", cmd.zone,
+                          cmd.raw_c_x10 / 10.0f, cmd.ref_c_x10 / 10.0f,
+                          changed ? "OK" : "rejected");
+            break;
+        case CAL_OP_REMOVE:
+            Serial.printf("[CAL] Zone %u remove point %u: %s\n", cmd.zone, cmd.index,
+                          changed ? "OK" : "rejected");
             break;
+        case CAL_OP_CLEAR:
+            Serial.printf("[CAL] Zone %u table cleared (uncalibrated)\n", cmd.zone);
+            break;
+        case CAL_OP_FACTORY:
+            Serial.printf("[CAL] Zone %u factory default restored\n", cmd.zone);
+            break;
+    }
+
+    if (changed) {
+        saveCalibration(cmd.zone);
+        // Drop samples filtered through the old table
+        zone.calChanged = true;
+    }
+    return changed;
+}
+
+/**
+ * Print calibration information for one zone
+ */
+void printCalibrationInfo(uint8_t zone) {
+    const CalibrationTable& table = g_zones[zone].cal;
+    Serial.printf("[CAL] Zone %u (%s) thermocouple calibration:\n", zone, ZONES[zone].name);
+
+    uint8_t n = table.size();
+    if (n == 0) {
+        Serial.println("      Mode: NONE (raw readings)");
+        Serial.println("      Status: UNCALIBRATED");
+    } else {
+        Serial.printf("      Mode: %s (%u point%s)\n",
+                      n == 1 ? "OFFSET" : "PIECEWISE LINEAR", n, n == 1 ? "" : "s");
+        for (uint8_t i = 0; i < n; i++) {
+            const CalPoint& pt = table.point(i);
+            Serial.printf("      [%u] raw %7.1f C -> ref %7.1f C (%+.1f)\n", i,
+                          pt.raw_c_x10 / 10.0f, pt.ref_c_x10 / 10.0f,
+                          (pt.ref_c_x10 - pt.raw_c_x10) / 10.0f);
         }
+        Serial.println("      Status: CALIBRATED");
     }
     Serial.println();
 }
@@ -352,124 +827,593 @@ void printCalibrationInfo() {
 // UART RECEIVE PROCESSING
 // ============================================================================
 
-void processDisplaySerial() {
-    static uint8_t rxBuffer[32];
-    static int rxIndex = 0;
+// Stamp a command and hand it to the control task (any task)
+bool queueCommand(uint8_t source, uint8_t zone, uint16_t setpointX10, uint8_t enable, uint32_t seq) {
+    HeaterCommand cmd;
+    cmd.source = source;
+    cmd.zone = zone;
+    cmd.enable = enable;
+    cmd.setpoint_c_x10 = setpointX10;
+    cmd.seq = seq;
+    cmd.receivedMs = millis();
+    cmd.receivedUs = esp_timer_get_time();
+
+    if (xQueueSend(g_cmdQueue, &cmd, 0) != pdTRUE) {
+        g_cmdDropped++;
+        return false;
+    }
+    return true;
+}
 
-    while (UI_SERIAL.available()) {
-        uint8_t b = UI_SERIAL.read();
-        rxBuffer[rxIndex++] = b;
+void queueDisplayCommand(const UiToCtrlPacket& pkt) {
+    // Mark UI as connected on first valid packet
+    if (!g_uiConnected) {
+        g_uiConnected = true;
+        Serial.println("[OK] Display connected via UART!");
+    }
 
-        if (rxIndex >= sizeof(rxBuffer)) {
-            rxIndex = 0;  // Overflow protection
-        }
+    // An unknown zone still counts as a keepalive; it refreshes the watchdog
+    // but is rejected by the arbiter
+    queueCommand(CMD_SRC_DISPLAY, pkt.zone, pkt.setpoint_c_x10, pkt.enable != 0 ? 1 : 0, pkt.seq);
 
-        // Check for complete packet
-        if (rxIndex >= sizeof(UiToCtrlPacket)) {
-            uint32_t magic;
-            memcpy(&magic, rxBuffer, sizeof(magic));
+    Serial.printf("RX: Zone=%u Set=%.1fC En=%d Seq=%lu\n",
+                  pkt.zone, pkt.setpoint_c_x10 / 10.0f, pkt.enable != 0, pkt.seq);
+}
 
-            if (magic == MAGIC_UI2CTRL) {
-                UiToCtrlPacket pkt;
-                memcpy(&pkt, rxBuffer, sizeof(pkt));
+// Called once per frame that passed COBS decoding and the CRC check
+void handleUiFrame(uint8_t type, const uint8_t* payload, size_t len) {
+    if (type == FRAME_UI_COMMAND && len == sizeof(UiToCtrlPacket)) {
+        UiToCtrlPacket pkt;
+        memcpy(&pkt, payload, sizeof(pkt));
+        if (pkt.magic == MAGIC_UI2CTRL) {
+            queueDisplayCommand(pkt);
+            return;
+        }
+    } else if (type == FRAME_CAL_COMMAND &&
+               (len == sizeof(CalCommandPacket) || len == CAL_COMMAND_V1_SIZE)) {
+        CalCommandPacket cmd = {};      // v1 packets leave zone at 0
+        memcpy(&cmd, payload, len);
+        if (cmd.magic == MAGIC_CAL) {
+            xQueueSend(g_calQueue, &cmd, 0);
+            return;
+        }
+    }
+    g_uiBadPackets++;
+}
 
-                // Update last command time (for watchdog)
-                g_lastCmdMs = millis();
-                g_lastCmdSeq = pkt.seq;
+// Unframed protocol: bare packets found by scanning for the magic number.
+// Kept for display firmware that predates the framed link.
+void processLegacyByte(uint8_t b) {
+    static uint8_t rxBuffer[32];
+    static size_t rxIndex = 0;
 
-                // Mark UI as connected on first valid packet
-                if (!g_uiConnected) {
-                    g_uiConnected = true;
-                    Serial.println("[OK] Display connected via UART!");
-                }
+    rxBuffer[rxIndex++] = b;
 
-                // Apply setpoint (convert from Cx10 to C)
-                g_setpointC = constrain(pkt.setpoint_c_x10 / 10.0f, MIN_SETPOINT_C, MAX_SETPOINT_C);
+    if (rxIndex >= sizeof(rxBuffer)) {
+        rxIndex = 0;  // Overflow protection
+    }
+
+    // Check for complete packet
+    if (rxIndex >= sizeof(UiToCtrlPacket)) {
+        uint32_t magic;
+        memcpy(&magic, rxBuffer, sizeof(magic));
 
-                // Apply enable state
-                g_heaterEnabled = (pkt.enable != 0);
+        if (magic == MAGIC_UI2CTRL) {
+            UiToCtrlPacket pkt;
+            memcpy(&pkt, rxBuffer, sizeof(pkt));
+            queueDisplayCommand(pkt);
+            rxIndex = 0;  // Clear buffer
+        } else {
+            // Resync - shift buffer by 1 byte
+            memmove(rxBuffer, rxBuffer + 1, rxIndex - 1);
+            rxIndex--;
+        }
+    }
+}
 
-                Serial.printf("RX: Set=%.1fC En=%d Seq=%lu\n",
-                              g_setpointC, g_heaterEnabled, pkt.seq);
+void processDisplaySerial() {
+    // Drain everything the UART driver has buffered in as few calls as
+    // possible; the framed parser works on whole runs between delimiters.
+    uint8_t chunk[128];
+
+    int avail;
+    while ((avail = UI_SERIAL.available()) > 0) {
+        size_t want = ((size_t)avail < sizeof(chunk)) ? (size_t)avail : sizeof(chunk);
+        size_t n = UI_SERIAL.read(chunk, want);
+        if (n == 0) {
+            break;
+        }
 
-                rxIndex = 0;  // Clear buffer
-            } else {
-                // Resync - shift buffer by 1 byte
-                memmove(rxBuffer, rxBuffer + 1, rxIndex - 1);
-                rxIndex--;
+        if (UI_LINK_FRAMED) {
+            g_uiLink.feed(chunk, n, handleUiFrame);
+        } else {
+            for (size_t i = 0; i < n; i++) {
+                processLegacyByte(chunk[i]);
             }
         }
     }
 }
 
+const char* commandSourceName(uint8_t source) {
+    switch (source) {
+        case CMD_SRC_BLE: return "ble";
+        case CMD_SRC_PIT: return "pit";
+        default:          return "display";
+    }
+}
+
+void printTickStats() {
+    TickStatsSnapshot snap;
+    portENTER_CRITICAL(&g_tickStatsMux);
+    snap = g_tickStats;
+    portEXIT_CRITICAL(&g_tickStatsMux);
+
+    if (snap.ticks == 0) {
+        return;  // First window not complete yet
+    }
+    Serial.printf("[TICK] period=%luus min=%luus p99=%luus max=%luus missed=%lu\n",
+                  (unsigned long)CONTROL_TICK_US, (unsigned long)snap.minUs,
+                  (unsigned long)snap.p99Us, (unsigned long)snap.maxUs,
+                  (unsigned long)snap.missed);
+}
+
+void printCommandStats() {
+    const CommandArbiter::Counters& counters = g_arbiter.getCounters();
+    Serial.printf("[CMD] applied=%lu dup=%lu stale=%lu dropped=%lu owner=%s lat=%luus max=%luus\n",
+                  (unsigned long)counters.applied, (unsigned long)counters.duplicates,
+                  (unsigned long)counters.stale, (unsigned long)g_cmdDropped,
+                  commandSourceName(g_arbiter.getOwner(0)),
+                  (unsigned long)g_cmdLatencyLastUs, (unsigned long)g_cmdLatencyMaxUs);
+}
+
+void printRecorderStats() {
+    if (!g_recorder.isReady()) {
+        return;
+    }
+    const FlightRecorder::Stats& stats = g_recorder.getStats();
+    Serial.printf("[REC] samples=%lu pages=%lu errors=%lu pinned=%lu dropped=%lu flush=%luus max=%luus\n",
+                  (unsigned long)stats.samples, (unsigned long)stats.pagesWritten,
+                  (unsigned long)stats.writeErrors, (unsigned long)stats.faultsPinned,
+                  (unsigned long)g_recDropped, (unsigned long)stats.lastFlushUs,
+                  (unsigned long)stats.maxFlushUs);
+}
+
+void printBleStats() {
+    const NotifyCounters& temp = g_tempNotify.getCounters();
+    const NotifyCounters& status = g_statusNotify.getCounters();
+    Serial.printf("[BLE] temp sent=%lu hb=%lu coalesced=%lu suppressed=%lu  "
+                  "status sent=%lu hb=%lu coalesced=%lu suppressed=%lu\n",
+                  (unsigned long)temp.sent, (unsigned long)temp.heartbeats,
+                  (unsigned long)temp.coalesced, (unsigned long)temp.suppressed,
+                  (unsigned long)status.sent, (unsigned long)status.heartbeats,
+                  (unsigned long)status.coalesced, (unsigned long)status.suppressed);
+}
+
+void printRadioStats() {
+    if (!g_radioReady) {
+        return;
+    }
+    RadioStats stats;
+    LatencySnapshot ack;
+    bool paired;
+    uint8_t peer[RADIO_MAC_LEN];
+    portENTER_CRITICAL(&g_radioMux);
+    stats = g_radioStats;
+    ack = g_radioAckLatency.snapshot();
+    g_radioAckLatency.reset();
+    paired = g_radioGate.isPaired();
+    memcpy(peer, g_radioGate.peer(), RADIO_MAC_LEN);
+    portEXIT_CRITICAL(&g_radioMux);
+
+    if (paired) {
+        Serial.printf("[RADIO] peer=%02x:%02x:%02x:%02x:%02x:%02x", peer[0], peer[1], peer[2],
+                      peer[3], peer[4], peer[5]);
+    } else {
+        Serial.print("[RADIO] peer=none");
+    }
+    Serial.printf(" rx=%lu ignored=%lu bad=%lu tx=%lu txFail=%lu macAck=%lu/%lu/%luus\n",
+                  (unsigned long)stats.rx, (unsigned long)stats.ignored, (unsigned long)stats.bad,
+                  (unsigned long)stats.tx, (unsigned long)stats.txFail,
+                  (unsigned long)ack.minUs, (unsigned long)ack.avgUs, (unsigned long)ack.maxUs);
+}
+
+void printLinkStats() {
+    if (!UI_LINK_FRAMED) {
+        return;
+    }
+    const LinkStats& stats = g_uiLink.getStats();
+    Serial.printf("[LINK] bytes=%lu good=%lu badCrc=%lu resync=%lu badPkt=%lu\n",
+                  (unsigned long)stats.bytes, (unsigned long)stats.good,
+                  (unsigned long)stats.badCrc, (unsigned long)stats.resync,
+                  (unsigned long)g_uiBadPackets);
+}
+
 // ============================================================================
 // SEND STATUS TO DISPLAY
 // ============================================================================
 
-void sendStatusToDisplay() {
-    CtrlToUiPacket pkt = {};
+// °C × 10 as sent on the link, INT16_MIN for no reading
+int16_t tempToX10(float tempC) {
+    return isnan(tempC) ? INT16_MIN : (int16_t)lroundf(tempC * 10.0f);
+}
+
+/**
+ * Fill a status packet (shared by the UART and ESP-NOW links)
+ * @param seqEcho last command seq processed from the receiving display
+ */
+void buildStatusPacket(CtrlToUiPacket& pkt, uint32_t seqEcho) {
+    memset(&pkt, 0, sizeof(pkt));
     pkt.magic = MAGIC_CTRL2UI;
 
-    if (isnan(g_currentTempC)) {
-        pkt.temp_c_x10 = INT16_MIN;
+    // v1 fields describe zone 0
+    const Zone& first = g_zones[0];
+    pkt.temp_c_x10     = tempToX10(first.tempC);
+    pkt.setpoint_c_x10 = (uint16_t)lroundf(first.setpointC * 10.0f);
+    pkt.relay_on       = first.relayOn ? 1 : 0;
+    pkt.fault_code     = first.fault;
+    pkt.uptime_s       = millis() / 1000;
+    pkt.seq_echo       = seqEcho;
+
+    TickStatsSnapshot snap;
+    portENTER_CRITICAL(&g_tickStatsMux);
+    snap = g_tickStats;
+    portEXIT_CRITICAL(&g_tickStatsMux);
+    pkt.tick_min_us = (uint16_t)(snap.minUs < UINT16_MAX ? snap.minUs : UINT16_MAX);
+    pkt.tick_max_us = (uint16_t)(snap.maxUs < UINT16_MAX ? snap.maxUs : UINT16_MAX);
+    pkt.tick_p99_us = (uint16_t)(snap.p99Us < UINT16_MAX ? snap.p99Us : UINT16_MAX);
+    pkt.tick_missed = (uint16_t)(snap.missed < UINT16_MAX ? snap.missed : UINT16_MAX);
+
+    pkt.zone_count = ZONE_COUNT;
+    for (uint8_t i = 0; i < ZONE_COUNT; i++) {
+        const Zone& zone = g_zones[i];
+        ZoneStatus& out = pkt.zones[i];
+        out.temp_c_x10     = tempToX10(zone.tempC);
+        out.setpoint_c_x10 = (uint16_t)lroundf(zone.setpointC * 10.0f);
+        out.flags          = (zone.relayOn ? ZONE_FLAG_RELAY : 0) |
+                             (zone.enabled ? ZONE_FLAG_ENABLED : 0);
+        out.fault_code     = zone.fault;
+    }
+}
+
+void sendStatusToDisplay() {
+    CtrlToUiPacket pkt;
+    buildStatusPacket(pkt, g_lastCmdSeq);
+
+    if (UI_LINK_FRAMED) {
+        uint8_t frame[cobsFrameSize(sizeof(pkt))];
+        size_t len = cobsEncodeFrame(FRAME_CTRL_STATUS, &pkt, sizeof(pkt), frame);
+        UI_SERIAL.write(frame, len);
     } else {
-        pkt.temp_c_x10 = (int16_t)lroundf(g_currentTempC * 10.0f);
+        // Legacy receivers expect exactly the v1 packet
+        UI_SERIAL.write((uint8_t*)&pkt, CTRL_TO_UI_V1_SIZE);
     }
+}
 
-    pkt.setpoint_c_x10 = (uint16_t)lroundf(g_setpointC * 10.0f);
-    pkt.relay_on       = g_relayState ? 1 : 0;
-    pkt.fault_code     = g_currentFault;
-    pkt.uptime_s       = millis() / 1000;
-    pkt.seq_echo       = g_lastCmdSeq;
+void sendCalTableToDisplay(uint8_t zone, bool result) {
+    if (!UI_LINK_FRAMED) {
+        return;  // Legacy display firmware has no calibration screen
+    }
+
+    const Zone& z = g_zones[zone];
+    CalTablePacket pkt = {};
+    pkt.magic = MAGIC_CAL;
+    pkt.result = result ? 1 : 0;
+    pkt.count = z.cal.size();
+    pkt.live_raw_c_x10 = z.rawTempX10;
+    for (uint8_t i = 0; i < pkt.count; i++) {
+        pkt.points[i] = z.cal.point(i);
+    }
+    pkt.zone = zone;
 
-    UI_SERIAL.write((uint8_t*)&pkt, sizeof(pkt));
+    uint8_t frame[cobsFrameSize(sizeof(pkt))];
+    size_t len = cobsEncodeFrame(FRAME_CAL_TABLE, &pkt, sizeof(pkt), frame);
+    UI_SERIAL.write(frame, len);
 }
 
 // ============================================================================
-// TEMPERATURE SMOOTHING
+// ESP-NOW LINK (wireless pit display)
 // ============================================================================
 
-float getSmoothedTemperature() {
-    // Read raw temperature from MAX6675
-    float rawTemp = thermocouple.readCelsius();
+// RadioPort over esp_now_send; loop() is the only sender
+class EspNowRadio : public RadioPort {
+public:
+    bool send(const uint8_t* mac, const uint8_t* data, size_t len) override {
+        g_radioTxStartUs = (uint32_t)esp_timer_get_time();
+        bool ok = esp_now_send(mac, data, len) == ESP_OK;
+        portENTER_CRITICAL(&g_radioMux);
+        g_radioStats.tx++;
+        if (!ok) {
+            g_radioStats.txFail++;
+        }
+        portEXIT_CRITICAL(&g_radioMux);
+        return ok;
+    }
+};
 
-    // If sensor error, return NAN immediately (no smoothing)
-    if (isnan(rawTemp)) {
-        return NAN;
+static EspNowRadio g_radio;
+
+// Send one packet as an ESP-NOW frame (loop only)
+bool sendRadioFrame(const uint8_t* mac, uint8_t type, const void* payload, size_t len) {
+    uint8_t frame[1 + UI_LINK_MAX_PAYLOAD];
+    if (len > UI_LINK_MAX_PAYLOAD) {
+        return false;
     }
+    frame[0] = type;
+    memcpy(frame + 1, payload, len);
+    return g_radio.send(mac, frame, len + 1);
+}
 
-    // Apply calibration to raw reading
-    float calibratedTemp = calibrateTemperature(rawTemp);
+// Send one packet to the paired pit display (loop only)
+bool sendRadioPacket(uint8_t type, const void* payload, size_t len) {
+    uint8_t peer[RADIO_MAC_LEN];
+    portENTER_CRITICAL(&g_radioMux);
+    bool paired = g_radioGate.isPaired();
+    memcpy(peer, g_radioGate.peer(), RADIO_MAC_LEN);
+    portEXIT_CRITICAL(&g_radioMux);
 
-    // Optional debug output for calibration testing
-    #if CAL_DEBUG_RAW
-        Serial.printf("[CAL] Raw: %.2f C -> Calibrated: %.2f C\n",
-                      rawTemp, calibratedTemp);
-    #endif
+    if (!paired) {
+        return false;
+    }
+    return sendRadioFrame(peer, type, payload, len);
+}
 
-    // Update circular buffer for moving average (using calibrated value)
-    tempSum -= tempReadings[readingIndex];          // Subtract oldest reading
-    tempReadings[readingIndex] = calibratedTemp;    // Add new calibrated reading
-    tempSum += calibratedTemp;                      // Update sum
+// The paired display is an encrypted peer; broadcast (pairing) is not
+bool addRadioPeer(const uint8_t* mac, bool encrypt) {
+    if (esp_now_is_peer_exist(mac)) {
+        return true;
+    }
+    esp_now_peer_info_t peer = {};
+    memcpy(peer.peer_addr, mac, RADIO_MAC_LEN);
+    peer.channel = ESPNOW_CHANNEL;
+    peer.ifidx = WIFI_IF_STA;
+    peer.encrypt = encrypt;
+    if (encrypt) {
+        memcpy(peer.lmk, ESPNOW_LMK, ESP_NOW_KEY_LEN);
+    }
+    return esp_now_add_peer(&peer) == ESP_OK;
+}
 
-    // Move to next position in circular buffer
-    readingIndex = (readingIndex + 1) % NUM_SAMPLES;
+// ESP-NOW receive callback (WiFi task). Commands from the paired display go
+// straight to the control task's queue; pair requests wait for loop().
+void onRadioRecv(const uint8_t* mac, const uint8_t* data, int len) {
+    if (len < 1) {
+        return;
+    }
+    uint8_t type = data[0];
+    const uint8_t* payload = data + 1;
+    size_t payloadLen = (size_t)len - 1;
+
+    if (type == FRAME_PAIR_REQUEST && payloadLen == sizeof(PairPacket)) {
+        PairPacket pkt;
+        memcpy(&pkt, payload, sizeof(pkt));
+        if (pkt.magic == MAGIC_PAIR) {
+            xQueueSend(g_pairQueue, mac, 0);
+        }
+        return;
+    }
 
-    // Mark array as filled after first complete cycle
-    if (readingIndex == 0 && !arrayFilled) {
-        arrayFilled = true;
+    portENTER_CRITICAL(&g_radioMux);
+    bool accepted = g_radioGate.accepts(mac);
+    if (accepted) {
+        g_radioStats.rx++;
+    } else {
+        g_radioStats.ignored++;
+    }
+    portEXIT_CRITICAL(&g_radioMux);
+    if (!accepted) {
+        return;
     }
 
-    // Calculate and return average
-    if (arrayFilled) {
-        return tempSum / NUM_SAMPLES;
+    if (type == FRAME_UI_COMMAND && payloadLen == sizeof(UiToCtrlPacket)) {
+        UiToCtrlPacket pkt;
+        memcpy(&pkt, payload, sizeof(pkt));
+        if (pkt.magic == MAGIC_UI2CTRL) {
+            queueCommand(CMD_SRC_PIT, pkt.zone, pkt.setpoint_c_x10, pkt.enable != 0 ? 1 : 0, pkt.seq);
+            return;
+        }
+    }
+    portENTER_CRITICAL(&g_radioMux);
+    g_radioStats.bad++;
+    portEXIT_CRITICAL(&g_radioMux);
+}
+
+// ESP-NOW send callback (WiFi task): MAC-level ack or failure. The time
+// measured is send -> MAC ack only; command -> seq_echo round trips are the
+// display's to measure.
+void onRadioSent(const uint8_t* mac, esp_now_send_status_t status) {
+    uint32_t ackUs = (uint32_t)esp_timer_get_time() - g_radioTxStartUs;
+    portENTER_CRITICAL(&g_radioMux);
+    if (status == ESP_NOW_SEND_SUCCESS) {
+        g_radioAckLatency.record(ackUs);
     } else {
-        // Until buffer is full, average only the readings we have
-        int validSamples = readingIndex > 0 ? readingIndex : NUM_SAMPLES;
-        return tempSum / validSamples;
+        g_radioStats.txFail++;
+    }
+    portEXIT_CRITICAL(&g_radioMux);
+}
+
+void handlePairRequests() {
+    uint8_t mac[RADIO_MAC_LEN];
+    while (xQueueReceive(g_pairQueue, mac, 0) == pdTRUE) {
+        uint8_t previous[RADIO_MAC_LEN];
+        portENTER_CRITICAL(&g_radioMux);
+        bool hadPeer = g_radioGate.isPaired();
+        memcpy(previous, g_radioGate.peer(), RADIO_MAC_LEN);
+        bool accepted = g_radioGate.pairRequest(mac, millis());
+        portEXIT_CRITICAL(&g_radioMux);
+
+        if (!accepted) {
+            Serial.printf("[RADIO] Pair request from %02x:%02x:%02x:%02x:%02x:%02x ignored "
+                          "(pairing window closed, press 'p')\n",
+                          mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+            continue;
+        }
+
+        if (!hadPeer || memcmp(previous, mac, RADIO_MAC_LEN) != 0) {
+            if (hadPeer) {
+                esp_now_del_peer(previous);
+            }
+            if (!addRadioPeer(mac, true)) {
+                Serial.println("[RADIO] Could not add the encrypted peer");
+            }
+            g_prefs.putBytes(NVS_PEER_KEY, mac, RADIO_MAC_LEN);
+            portENTER_CRITICAL(&g_radioMux);
+            g_radioStats.pairings++;
+            portEXIT_CRITICAL(&g_radioMux);
+            Serial.printf("[RADIO] Paired with pit display %02x:%02x:%02x:%02x:%02x:%02x\n",
+                          mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+        }
+
+        // Reply every time; the display may have missed the last one. It is
+        // broadcast in the clear: the display learns our MAC from it before it
+        // can add us as an encrypted peer.
+        PairPacket reply = {MAGIC_PAIR, ZONE_COUNT};
+        sendRadioFrame(RADIO_BROADCAST, FRAME_PAIR_ACCEPT, &reply, sizeof(reply));
     }
 }
 
+void processRadio() {
+    if (!g_radioReady) {
+        return;
+    }
+    handlePairRequests();
+
+    // Status at the usual rate, and straight after each pit command so the
+    // display sees its seq_echo without waiting for the next period
+    uint32_t now = millis();
+    if (g_pitAckPending || (now - g_lastPitStatusMs) >= STATUS_SEND_MS) {
+        g_pitAckPending = false;
+        g_lastPitStatusMs = now;
+        CtrlToUiPacket pkt;
+        buildStatusPacket(pkt, g_pitAckSeq);
+        sendRadioPacket(FRAME_CTRL_STATUS, &pkt, sizeof(pkt));
+    }
+}
+
+void initRadio() {
+    if (!ESPNOW_ENABLED) {
+        return;
+    }
+
+    WiFi.mode(WIFI_STA);
+    WiFi.disconnect();
+    esp_wifi_set_channel(ESPNOW_CHANNEL, WIFI_SECOND_CHAN_NONE);
+
+    g_pairQueue = xQueueCreate(2, RADIO_MAC_LEN);
+    if (esp_now_init() != ESP_OK) {
+        Serial.println("[ERR] ESP-NOW init failed - pit display disabled");
+        return;
+    }
+    esp_now_register_recv_cb(onRadioRecv);
+    esp_now_register_send_cb(onRadioSent);
+    esp_now_set_pmk(ESPNOW_PMK);
+    addRadioPeer(RADIO_BROADCAST, false);   // Pair replies
+
+    // A stored peer is trusted as is; the pairing window only opens at boot
+    // when there is none (or later with 'p'), so a restart near another
+    // display cannot steal the link
+    uint8_t mac[RADIO_MAC_LEN];
+    if (g_prefs.getBytesLength(NVS_PEER_KEY) == RADIO_MAC_LEN &&
+        g_prefs.getBytes(NVS_PEER_KEY, mac, RADIO_MAC_LEN) == RADIO_MAC_LEN) {
+        g_radioGate.restore(mac);
+        addRadioPeer(mac, true);
+        Serial.printf("[OK] ESP-NOW on channel %u, paired with %02x:%02x:%02x:%02x:%02x:%02x\n",
+                      ESPNOW_CHANNEL, mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+    } else {
+        g_radioGate.openWindow(millis(), PAIRING_WINDOW_MS);
+        Serial.printf("[OK] ESP-NOW on channel %u, not paired - pairing window open for %lu s\n",
+                      ESPNOW_CHANNEL, (unsigned long)(PAIRING_WINDOW_MS / 1000));
+    }
+    g_radioReady = true;
+}
+
+// ============================================================================
+// CALIBRATION COMMANDS
+// ============================================================================
+
+void updateCalCharacteristic() {
+    // {"zone":0,"raw":95.0,"points":[[1.2,0.0],[98.5,99.0]]} - the zone of
+    // the last calibration command
+    const Zone& zone = g_zones[g_calViewZone];
+    char json[256];
+    int pos = snprintf(json, sizeof(json), "{\"zone\":%u,", g_calViewZone);
+    if (zone.rawTempX10 == INT16_MIN) {
+        pos += snprintf(json + pos, sizeof(json) - pos, "\"raw\":null,\"points\":[");
+    } else {
+        pos += snprintf(json + pos, sizeof(json) - pos, "\"raw\":%.1f,\"points\":[",
+                        zone.rawTempX10 / 10.0f);
+    }
+    for (uint8_t i = 0; i < zone.cal.size(); i++) {
+        const CalPoint& pt = zone.cal.point(i);
+        pos += snprintf(json + pos, sizeof(json) - pos, "%s[%.1f,%.1f]",
+                        i ? "," : "", pt.raw_c_x10 / 10.0f, pt.ref_c_x10 / 10.0f);
+    }
+    snprintf(json + pos, sizeof(json) - pos, "]}");
+    g_charCal->setValue(json);
+    g_calShownZone = g_calViewZone;
+    g_calShownRawX10 = zone.rawTempX10;
+}
+
+void processCalCommands() {
+    CalCommandPacket cmd;
+    while (xQueueReceive(g_calQueue, &cmd, 0) == pdTRUE) {
+        bool changed = applyCalCommand(cmd);
+        if (cmd.zone >= ZONE_COUNT) {
+            continue;
+        }
+        if (changed) {
+            printCalibrationInfo(cmd.zone);
+        }
+        g_calViewZone = cmd.zone;
+        sendCalTableToDisplay(cmd.zone, changed || cmd.op == CAL_OP_QUERY);
+        updateCalCharacteristic();
+    }
+}
+
+// ============================================================================
+// TEMPERATURE SMOOTHING
+// ============================================================================
+
+float getSmoothedTemperature(uint8_t index) {
+    Zone& zone = g_zones[index];
+
+    // Read raw temperature from this zone's MAX6675. Reading ends its
+    // conversion; the next one starts when CS goes high again.
+    float rawTemp = zone.thermocouple->readCelsius();
+
+    // If sensor error, return NAN immediately and drop filter history so a
+    // reconnected probe is not averaged with pre-fault readings
+    if (isnan(rawTemp)) {
+        zone.filter.reset();
+        zone.rawFilter.reset();
+        zone.model.reset();
+        zone.rawTempX10 = INT16_MIN;
+        return NAN;
+    }
+
+    if (zone.calChanged) {
+        zone.calChanged = false;
+        zone.filter.reset();
+        zone.model.reset();     // A new table may step the reading
+    }
+
+    // Calibrate with one table lookup on the MAX6675 code (0.25 °C steps)
+    uint16_t code = rawTemp > 0.0f ? (uint16_t)lroundf(rawTemp * 4.0f) : 0;
+    xSemaphoreTake(g_calMutex, portMAX_DELAY);
+    int16_t calibratedX10 = zone.cal.apply(code);
+    xSemaphoreGive(g_calMutex);
+    zone.rawTempX10 = (int16_t)zone.rawFilter.update((int32_t)lroundf(rawTemp * 10.0f));
+
+    // Optional debug output for calibration testing
+    #if CAL_DEBUG_RAW
+        Serial.printf("[CAL] Zone %u raw: %.2f C -> Calibrated: %.1f C\n",
+                      index, rawTemp, calibratedX10 / 10.0f);
+    #endif
+
+    // Filter in integer deci-degrees; only the edges touch floats
+    int32_t filtered = zone.filter.update(calibratedX10);
+    return filtered / 10.0f;
+}
+
 // ============================================================================
 // BLE SERVER INITIALIZATION
 // ============================================================================
@@ -513,6 +1457,14 @@ void initBLE() {
     );
     g_charStatus->addDescriptor(new BLE2902());
 
+    // Calibration characteristic (Read + Write)
+    g_charCal = pService->createCharacteristic(
+        BLE_CHAR_CAL_UUID,
+        BLECharacteristic::PROPERTY_READ | BLECharacteristic::PROPERTY_WRITE
+    );
+    g_charCal->setCallbacks(new CalibrationCallbacks());
+    updateCalCharacteristic();
+
     // Start service
     pService->start();
 
@@ -524,89 +1476,182 @@ void initBLE() {
     pAdvertising->setMinPreferred(0x12);
     BLEDevice::startAdvertising();
 
-    Serial.println("[OK] BLE server started - advertising as: " BLE_DEVICE_NAME);
+    Serial.printf("[OK] BLE server started - advertising as: %s\n", deviceName.c_str());
 }
 
 // ============================================================================
 // BLE CHARACTERISTIC UPDATES
 // ============================================================================
 
+// °F × 10 for change detection, INT32_MIN for no reading
+int32_t tempToFX10(float tempC) {
+    return isnan(tempC) ? INT32_MIN : (int32_t)lroundf(tempC * 18.0f + 320.0f);
+}
+
+/**
+ * Notify temperature and status if they changed (loop only). Payloads are
+ * formatted only when a notify goes out.
+ */
 void updateBLECharacteristics() {
     if (!g_bleClientConnected) {
         return;  // No client connected, skip updates
     }
+    uint32_t now = millis();
 
-    // Temperature characteristic - send current temp in Fahrenheit as string
-    char tempStr[16];
-    if (isnan(g_currentTempC)) {
-        strcpy(tempStr, "ERR");
-    } else {
-        float tempF = (g_currentTempC * 9.0f / 5.0f) + 32.0f;
-        snprintf(tempStr, sizeof(tempStr), "%.1f", tempF);
+    // A new client gets everything once it has had time to subscribe
+    if (g_bleResync && (now - g_bleConnectMs) >= BLE_RESYNC_MS) {
+        g_bleResync = false;
+        g_tempNotify.force();
+        g_statusNotify.force();
     }
-    g_charTemp->setValue(tempStr);
-    g_charTemp->notify();
 
-    // Setpoint characteristic - send setpoint in Fahrenheit as string
-    char setpointStr[16];
-    float setpointF = (g_setpointC * 9.0f / 5.0f) + 32.0f;
-    snprintf(setpointStr, sizeof(setpointStr), "%.1f", setpointF);
-    g_charSetpoint->setValue(setpointStr);
+    // Temperature and setpoint characteristics carry zone 0; every zone is
+    // in the STATUS JSON
+    const Zone& first = g_zones[0];
+
+    // Temperature characteristic - send current temp in Fahrenheit as string
+    NotifyFields<BLE_TEMP_FIELDS> tempFields;
+    tempFields.add(tempToFX10(first.tempC), BLE_TEMP_DEADBAND);
+    if (g_tempNotify.poll(tempFields, now)) {
+        char tempStr[16];
+        if (isnan(first.tempC)) {
+            strcpy(tempStr, "ERR");
+        } else {
+            float tempF = (first.tempC * 9.0f / 5.0f) + 32.0f;
+            snprintf(tempStr, sizeof(tempStr), "%.1f", tempF);
+        }
+        g_charTemp->setValue(tempStr);
+        g_charTemp->notify();
+    }
 
     // Status characteristic - send JSON string
     // FIXED: Changed format to match mobile-oil-heater app expectations:
     // - "heater" instead of "heating"
     // - "safetyShutdown" boolean instead of numeric "fault"
     // - "sensorError" boolean for sensor faults
-    char statusJson[128];
-    bool safetyShutdown = (g_currentFault == FAULT_OVERTEMP || g_currentFault == FAULT_COMM_TIMEOUT);
-    bool sensorError = (g_currentFault == FAULT_SENSOR_OPEN);
+    // - "ackSeq" / "owner" acknowledge setpoint writes (see SetpointCallbacks)
+    // - "zones" lists every zone; the top-level fields describe zone 0
+    // cmdLatencyMs changes with every command and rides along without
+    // triggering a notify.
+    bool safetyShutdown = (first.fault == FAULT_OVERTEMP || first.fault == FAULT_COMM_TIMEOUT ||
+                           first.fault == FAULT_STUCK_RELAY || first.fault == FAULT_OPEN_ELEMENT);
+    bool sensorError = (first.fault == FAULT_SENSOR_OPEN || first.fault == FAULT_PROBE_DETACHED);
+
+    NotifyFields<BLE_STATUS_FIELDS> statusFields;
+    statusFields.add(first.relayOn);
+    statusFields.add(safetyShutdown);
+    statusFields.add(sensorError);
+    statusFields.add((int32_t)g_bleAckSeq);
+    statusFields.add(g_arbiter.getOwner(0));
+    for (uint8_t i = 0; i < ZONE_COUNT; i++) {
+        const Zone& zone = g_zones[i];
+        statusFields.add(tempToFX10(zone.tempC), BLE_TEMP_DEADBAND);
+        statusFields.add(lroundf(zone.setpointC * 10.0f));
+        statusFields.add(zone.enabled);
+        statusFields.add(zone.relayOn);
+        statusFields.add(zone.fault);
+        statusFields.add(g_arbiter.getOwner(i));
+    }
+    if (g_statusNotify.poll(statusFields, now)) {
+        // Setpoint characteristic - read only, refreshed with the status
+        char setpointStr[16];
+        float setpointF = (first.setpointC * 9.0f / 5.0f) + 32.0f;
+        snprintf(setpointStr, sizeof(setpointStr), "%.1f", setpointF);
+        g_charSetpoint->setValue(setpointStr);
+
+        char statusJson[512];
+        int pos = snprintf(statusJson, sizeof(statusJson),
+                 "{\"heater\":%s,\"safetyShutdown\":%s,\"sensorError\":%s,"
+                 "\"ackSeq\":%lu,\"owner\":\"%s\",\"cmdLatencyMs\":%lu,\"zones\":[",
+                 first.relayOn ? "true" : "false",
+                 safetyShutdown ? "true" : "false",
+                 sensorError ? "true" : "false",
+                 (unsigned long)g_bleAckSeq,
+                 commandSourceName(g_arbiter.getOwner(0)),
+                 (unsigned long)(g_cmdLatencyLastUs / 1000));
+
+        // {"name":"sump","temp":215.6,"setpoint":230.0,"enabled":true,"heater":false,"fault":0,"owner":"ble"}
+        for (uint8_t i = 0; i < ZONE_COUNT; i++) {
+            const Zone& zone = g_zones[i];
+            char temp[12];
+            if (isnan(zone.tempC)) {
+                strcpy(temp, "null");
+            } else {
+                snprintf(temp, sizeof(temp), "%.1f", (zone.tempC * 9.0f / 5.0f) + 32.0f);
+            }
+            pos += snprintf(statusJson + pos, sizeof(statusJson) - pos,
+                            "%s{\"name\":\"%s\",\"temp\":%s,\"setpoint\":%.1f,\"enabled\":%s,"
+                            "\"heater\":%s,\"fault\":%u,\"owner\":\"%s\"}",
+                            i ? "," : "", ZONES[i].name, temp,
+                            (zone.setpointC * 9.0f / 5.0f) + 32.0f,
+                            zone.enabled ? "true" : "false",
+                            zone.relayOn ? "true" : "false",
+                            zone.fault,
+                            commandSourceName(g_arbiter.getOwner(i)));
+        }
+        snprintf(statusJson + pos, sizeof(statusJson) - pos, "]}");
+        g_charStatus->setValue(statusJson);
+        g_charStatus->notify();
+    }
 
-    snprintf(statusJson, sizeof(statusJson),
-             "{\"heater\":%s,\"safetyShutdown\":%s,\"sensorError\":%s}",
-             g_relayState ? "true" : "false",
-             safetyShutdown ? "true" : "false",
-             sensorError ? "true" : "false");
-    g_charStatus->setValue(statusJson);
-    g_charStatus->notify();
+    // Calibration characteristic - refresh the live raw reading for capture
+    // (read, not notified)
+    const Zone& calZone = g_zones[g_calViewZone];
+    if (g_calViewZone != g_calShownZone || calZone.rawTempX10 != g_calShownRawX10) {
+        updateCalCharacteristic();
+    }
 }
 
 // ============================================================================
 // THERMOSTAT LOGIC
 // ============================================================================
 
-void updateThermostat() {
+void updateThermostat(uint8_t index) {
+    Zone& zone = g_zones[index];
+
     // Read smoothed temperature
-    float tempC = getSmoothedTemperature();
-    g_currentTempC = tempC;
+    float tempC = getSmoothedTemperature(index);
+    zone.tempC = tempC;
     
     // Determine fault state
-    g_currentFault = FAULT_NONE;
+    uint8_t fault = FAULT_NONE;
     
-    // Check comm timeout
+    // Any fault forces the relay off below. The commanded enable is kept,
+    // so heating resumes once the fault clears, as it did when every
+    // display packet re-sent the enable flag.
+
+    // Check comm timeout (shared by all zones)
     if ((millis() - g_lastCmdMs) > CMD_TIMEOUT_MS) {
-        g_currentFault = FAULT_COMM_TIMEOUT;
-        g_heaterEnabled = false;
+        fault = FAULT_COMM_TIMEOUT;
+    }
+
+    // Check rate of rise against the relay state it was read under
+    if (!isnan(tempC)) {
+        switch (zone.model.update(tempToX10(tempC), zone.relayOn, millis())) {
+            case HeaterModel::STUCK_RELAY:    fault = FAULT_STUCK_RELAY;    break;
+            case HeaterModel::OPEN_ELEMENT:   fault = FAULT_OPEN_ELEMENT;   break;
+            case HeaterModel::PROBE_DETACHED: fault = FAULT_PROBE_DETACHED; break;
+            default: break;
+        }
     }
     
     // Check sensor
     if (isnan(tempC)) {
-        g_currentFault = FAULT_SENSOR_OPEN;
-        g_heaterEnabled = false;
+        fault = FAULT_SENSOR_OPEN;
     }
     
     // Check overtemp
     if (!isnan(tempC) && tempC >= MAX_SAFE_TEMP_C) {
-        g_currentFault = FAULT_OVERTEMP;
-        g_heaterEnabled = false;
+        fault = FAULT_OVERTEMP;
     }
+    zone.fault = fault;
     
     // Bang-bang thermostat with hysteresis
     bool wantRelayOn = false;
     
-    if (g_currentFault == FAULT_NONE && g_heaterEnabled && !isnan(tempC)) {
-        float lowThresh  = g_setpointC - HYSTERESIS_C;
-        float highThresh = g_setpointC + HYSTERESIS_C;
+    if (fault == FAULT_NONE && zone.enabled && !isnan(tempC)) {
+        float lowThresh  = zone.setpointC - HYSTERESIS_C;
+        float highThresh = zone.setpointC + HYSTERESIS_C;
         
         if (tempC <= lowThresh) {
             wantRelayOn = true;
@@ -614,11 +1659,204 @@ void updateThermostat() {
             wantRelayOn = false;
         } else {
             // In deadband - maintain current state
-            wantRelayOn = g_relayState;
+            wantRelayOn = zone.relayOn;
         }
     }
     
-    setRelay(wantRelayOn);
+    setRelay(index, wantRelayOn);
+}
+
+// ============================================================================
+// CONTROL TICK
+// ============================================================================
+
+/**
+ * Drain the command queue through the arbiter (control task only)
+ * @param oldestUs receive stamp of the oldest command applied
+ * @return true if any command was applied
+ */
+bool processCommands(int64_t& oldestUs) {
+    bool applied = false;
+    HeaterCommand cmd;
+
+    while (xQueueReceive(g_cmdQueue, &cmd, 0) == pdTRUE) {
+        // Any well-formed command proves the sender is alive (CRITICAL SAFETY)
+        if ((int32_t)(cmd.receivedMs - g_lastCmdMs) > 0) {
+            g_lastCmdMs = cmd.receivedMs;
+        }
+        if (cmd.zone >= ZONE_COUNT) {
+            continue;
+        }
+
+        CommandArbiter::Verdict verdict = g_arbiter.arbitrate(cmd);
+
+        // Acknowledge everything processed, applied or not
+        if (cmd.source == CMD_SRC_DISPLAY) {
+            g_lastCmdSeq = g_arbiter.lastSeq(CMD_SRC_DISPLAY);
+        } else if (cmd.source == CMD_SRC_BLE) {
+            g_bleAckSeq = g_arbiter.lastSeq(CMD_SRC_BLE);
+        } else if (cmd.source == CMD_SRC_PIT) {
+            g_pitAckSeq = g_arbiter.lastSeq(CMD_SRC_PIT);
+            g_pitAckPending = true;     // Reply without waiting for the status period
+        }
+
+        if (verdict != CommandArbiter::APPLY) {
+            continue;
+        }
+
+        Zone& zone = g_zones[cmd.zone];
+        if (cmd.setpoint_c_x10 != CMD_SETPOINT_UNCHANGED) {
+            zone.setpointC = constrain(cmd.setpoint_c_x10 / 10.0f, MIN_SETPOINT_C, MAX_SETPOINT_C);
+        }
+        if (cmd.enable != CMD_ENABLE_UNCHANGED) {
+            bool enable = (cmd.enable != 0);
+            if (enable && !zone.enabled) {
+                zone.model.clear();     // Re-enabling acknowledges a model fault
+            }
+            zone.enabled = enable;
+        }
+
+        if (!applied) {
+            oldestUs = cmd.receivedUs;
+            applied = true;
+        }
+    }
+    return applied;
+}
+
+/**
+ * Queue a zone's state for the flight recorder (control task only).
+ * Never blocks: if loop() has fallen behind, the sample is dropped.
+ */
+void queueRecorderSample(uint8_t index) {
+    const Zone& zone = g_zones[index];
+    RecorderSample sample;
+    sample.uptimeMs       = millis();
+    sample.temp_c_x10     = tempToX10(zone.tempC);
+    sample.setpoint_c_x10 = (uint16_t)lroundf(zone.setpointC * 10.0f);
+    sample.relay          = zone.relayOn ? 1 : 0;
+    sample.fault          = zone.fault;
+    sample.owner          = g_arbiter.getOwner(index);
+    sample.zone           = index;
+    sample.seq            = g_arbiter.getAppliedSeq(index);
+
+    if (xQueueSend(g_recQueue, &sample, 0) != pdTRUE) {
+        g_recDropped++;
+    }
+}
+
+/**
+ * Write queued samples to the flight recorder and continue a dump (loop only)
+ */
+void processRecorder() {
+    RecorderSample sample;
+    while (xQueueReceive(g_recQueue, &sample, 0) == pdTRUE) {
+        g_recorder.record(sample);
+    }
+    if (g_recorder.isDumping()) {
+        g_recorder.serviceDump(Serial, RECORDER_DUMP_LINES);
+    }
+}
+
+/**
+ * Single-character commands on the USB serial console
+ *   l  list flight recorder files
+ *   d  dump flight recorder files as hex
+ *   p  open the ESP-NOW pairing window
+ */
+void processSerialCommands() {
+    while (Serial.available() > 0) {
+        int c = Serial.read();
+        if (c == 'l') {
+            g_recorder.list(Serial);
+            printRecorderStats();
+        } else if (c == 'd' && g_recorder.isReady() && !g_recorder.isDumping()) {
+            g_recorder.startDump(Serial);
+        } else if (c == 'p' && g_radioReady) {
+            portENTER_CRITICAL(&g_radioMux);
+            g_radioGate.openWindow(millis(), PAIRING_WINDOW_MS);
+            portEXIT_CRITICAL(&g_radioMux);
+            Serial.printf("[RADIO] Pairing window open for %lu s\n",
+                          (unsigned long)(PAIRING_WINDOW_MS / 1000));
+        }
+    }
+}
+
+// esp_timer callback (esp_timer task context): just wake the control task
+void onControlTimer(void* arg) {
+    xTaskNotifyGive(g_controlTaskHandle);
+}
+
+void controlTask(void* param) {
+    TickLatencyStats stats;
+    int64_t dueUs = 0;
+    uint32_t cmdLatencyMaxUs = 0;
+    uint32_t slot = 0;          // Round-robin zone schedule
+
+    for (;;) {
+        uint32_t pending = ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        int64_t startUs = esp_timer_get_time();
+
+        // esp_timer runs periodic alarms on a fixed grid from the start time,
+        // so the ideal time of tick n is start + n * period
+        if (dueUs == 0) {
+            dueUs = g_controlStartUs + CONTROL_TICK_US;
+        }
+
+        // Ticks that fired while the previous one was still running are
+        // skipped rather than run back-to-back. Their zones' slots are
+        // skipped too, so every chip keeps its full conversion time.
+        uint32_t missed = pending > 1 ? pending - 1 : 0;
+        dueUs += (int64_t)missed * CONTROL_TICK_US;
+        int64_t lateUs = startUs - dueUs;
+        dueUs += CONTROL_TICK_US;
+        slot += missed;
+        uint8_t zone = (uint8_t)(slot % ZONE_COUNT);
+        slot++;
+
+        int64_t cmdUs = 0;
+        bool applied = processCommands(cmdUs);
+
+        updateThermostat(zone);
+        queueRecorderSample(zone);
+
+        if (applied) {
+            uint32_t latencyUs = (uint32_t)(esp_timer_get_time() - cmdUs);
+            g_cmdLatencyLastUs = latencyUs;
+            if (latencyUs > cmdLatencyMaxUs) {
+                cmdLatencyMaxUs = latencyUs;
+            }
+        }
+
+        stats.record(lateUs > 0 ? (uint32_t)lateUs : 0, missed);
+        if (stats.count() >= TICK_STATS_WINDOW) {
+            TickStatsSnapshot snap = stats.snapshot();
+            portENTER_CRITICAL(&g_tickStatsMux);
+            g_tickStats = snap;
+            portEXIT_CRITICAL(&g_tickStatsMux);
+            g_cmdLatencyMaxUs = cmdLatencyMaxUs;
+            cmdLatencyMaxUs = 0;
+            stats.reset();
+        }
+    }
+}
+
+void startControlTick() {
+    xTaskCreatePinnedToCore(controlTask, "control", CONTROL_TASK_STACK, nullptr,
+                            CONTROL_TASK_PRIORITY, &g_controlTaskHandle, CONTROL_TASK_CORE);
+
+    esp_timer_create_args_t timerArgs = {};
+    timerArgs.callback = onControlTimer;
+    timerArgs.dispatch_method = ESP_TIMER_TASK;
+    timerArgs.name = "control_tick";
+    esp_timer_create(&timerArgs, &g_controlTimer);
+
+    g_controlStartUs = esp_timer_get_time();
+    esp_timer_start_periodic(g_controlTimer, CONTROL_TICK_US);
+
+    Serial.printf("[OK] Control tick started: %lu us (%u zone%s, %lu ms each), priority %u, core %d\n",
+                  (unsigned long)CONTROL_TICK_US, ZONE_COUNT, ZONE_COUNT == 1 ? "" : "s",
+                  (unsigned long)TEMP_READ_MS, (unsigned)CONTROL_TASK_PRIORITY, (int)CONTROL_TASK_CORE);
 }
 
 // ============================================================================
@@ -635,35 +1873,66 @@ void setup() {
     Serial.println("========================================");
     Serial.println();
     
-    // Initialize relay (OFF)
-    pinMode(PIN_RELAY, OUTPUT);
-    setRelay(false);
-    Serial.println("[OK] Relay initialized (OFF)");
+    // Initialize relays (OFF) and thermocouples (shared SCK / SO)
+    for (uint8_t i = 0; i < ZONE_COUNT; i++) {
+        pinMode(ZONES[i].relayPin, OUTPUT);
+        setRelay(i, false);
+        g_zones[i].thermocouple = new MAX6675(PIN_THERMO_SCK, ZONES[i].csPin, PIN_THERMO_SO);
+        Serial.printf("[OK] Zone %u (%s): relay GPIO %d (OFF), thermocouple CS GPIO %d\n",
+                      i, ZONES[i].name, ZONES[i].relayPin, ZONES[i].csPin);
+    }
+
+    // Load calibration table (before BLE, which publishes it)
+    g_calQueue = xQueueCreate(4, sizeof(CalCommandPacket));
+    g_calMutex = xSemaphoreCreateMutex();
+    g_cmdQueue = xQueueCreate(COMMAND_QUEUE_LENGTH, sizeof(HeaterCommand));
+    g_recQueue = xQueueCreate(RECORDER_QUEUE_LENGTH, sizeof(RecorderSample));
+    g_prefs.begin(NVS_NAMESPACE, false);
+    for (uint8_t i = 0; i < ZONE_COUNT; i++) {
+        bool stored = loadCalibration(i);
+        Serial.printf("[OK] Zone %u calibration loaded (%s)\n", i, stored ? "NVS" : "factory default");
+    }
 
     // Initialize BLE server
     initBLE();
 
+    // ESP-NOW link to the pit display (shares the radio with BLE)
+    initRadio();
+
     // Initialize UART to display
     UI_SERIAL.begin(UI_BAUD, SERIAL_8N1, UI_RX_PIN, UI_TX_PIN);
     Serial.println("[OK] Display UART initialized");
     Serial.printf("     RX: GPIO %d, TX: GPIO %d, Baud: %d\n", UI_RX_PIN, UI_TX_PIN, UI_BAUD);
+    Serial.printf("     Link: %s\n", UI_LINK_FRAMED ? "COBS + CRC-16 framed" : "legacy raw packets");
+
+    // Mount LittleFS and open a new flight recorder segment
+    if (g_recorder.begin()) {
+        Serial.println("[OK] Flight recorder started (LittleFS " REC_DIR ")");
+    } else {
+        Serial.println("[ERR] Flight recorder disabled - LittleFS mount failed");
+    }
 
     // Print calibration configuration
     Serial.println();
-    printCalibrationInfo();
+    for (uint8_t i = 0; i < ZONE_COUNT; i++) {
+        printCalibrationInfo(i);
+    }
 
     // Initialize timing
     g_lastCmdMs = millis();
-    g_lastTempReadMs = millis();
     g_lastStatusSendMs = millis();
     g_lastBleUpdateMs = millis();
+    g_lastHealthReportMs = millis();
+
+    // Sensor read, fault evaluation and relay decisions run from here on
+    startControlTick();
 
     Serial.println("Waiting for display connection...");
     Serial.println();
 }
 
 // ============================================================================
-// MAIN LOOP
+// MAIN LOOP (telemetry, display link and BLE; control runs in controlTask)
 // ============================================================================
 
 void loop() {
@@ -672,31 +1941,50 @@ void loop() {
     // Process incoming commands from display
     processDisplaySerial();
 
-    // Read temperature and update thermostat
-    if ((now - g_lastTempReadMs) >= TEMP_READ_MS) {
-        g_lastTempReadMs = now;
-        updateThermostat();
-    }
+    // Apply calibration edits from BLE / display
+    processCalCommands();
+
+    // Pit display link: pairing and status
+    processRadio();
+
+    // Flight recorder writes and console commands
+    processRecorder();
+    processSerialCommands();
 
     // Send status to display at regular intervals
     if ((now - g_lastStatusSendMs) >= STATUS_SEND_MS) {
         g_lastStatusSendMs = now;
         sendStatusToDisplay();
 
-        // Serial debug output
-        Serial.printf("T=%.1fC  Set=%.1fC  En=%d  Relay=%s  Fault=%d\n",
-                      isnan(g_currentTempC) ? -999.0f : g_currentTempC,
-                      g_setpointC,
-                      g_heaterEnabled,
-                      g_relayState ? "ON " : "OFF",
-                      g_currentFault);
+        // Serial debug output, one line per zone
+        for (uint8_t i = 0; i < ZONE_COUNT; i++) {
+            const Zone& zone = g_zones[i];
+            Serial.printf("Z%u T=%.1fC  Set=%.1fC  En=%d  Relay=%s  Fault=%d\n",
+                          i,
+                          isnan(zone.tempC) ? -999.0f : zone.tempC,
+                          zone.setpointC,
+                          zone.enabled,
+                          zone.relayOn ? "ON " : "OFF",
+                          zone.fault);
+        }
     }
 
-    // Update BLE characteristics at 500ms intervals
-    if ((now - g_lastBleUpdateMs) >= BLE_UPDATE_MS) {
+    // Check BLE characteristics for changes worth a notify
+    if ((now - g_lastBleUpdateMs) >= BLE_POLL_MS) {
         g_lastBleUpdateMs = now;
         updateBLECharacteristics();
     }
 
+    // Report UART link health and control tick latency
+    if ((now - g_lastHealthReportMs) >= HEALTH_REPORT_MS) {
+        g_lastHealthReportMs = now;
+        printLinkStats();
+        printTickStats();
+        printCommandStats();
+        printRadioStats();
+        printBleStats();
+        printRecorderStats();
+    }
+
     delay(10);
 }
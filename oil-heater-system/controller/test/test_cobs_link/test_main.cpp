@@ -0,0 +1,240 @@
+// Host tests for the COBS / CRC-16 UART link: round trips, fuzzed and
+// corrupted streams, and a parser throughput figure (pio test -e native)
+
+#include <stdio.h>
+#include <chrono>
+#include <unity.h>
+#include "cobs_link.h"
+
+static const size_t MAX_PAYLOAD = 64;          // UI_LINK_MAX_PAYLOAD
+typedef CobsFrameParser<MAX_PAYLOAD + 3> LinkParser;
+
+// Deterministic generator, zero-heavy so COBS blocks of every length occur
+static uint32_t rngState = 1;
+static uint32_t rng() {
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 17;
+    rngState ^= rngState << 5;
+    return rngState;
+}
+static uint8_t rngByte() {
+    uint32_t r = rng();
+    return (r & 0x300) == 0 ? 0x00 : (uint8_t)r;
+}
+
+// Collects decoded frames
+struct Sink {
+    static const size_t MAX_FRAMES = 512;
+    uint8_t type[MAX_FRAMES];
+    uint8_t payload[MAX_FRAMES][MAX_PAYLOAD];
+    size_t len[MAX_FRAMES];
+    size_t count = 0;
+
+    void operator()(uint8_t t, const uint8_t* p, size_t n) {
+        if (count < MAX_FRAMES && n <= MAX_PAYLOAD) {
+            type[count] = t;
+            memcpy(payload[count], p, n);
+            len[count] = n;
+        }
+        count++;
+    }
+};
+
+struct SinkRef {
+    Sink* sink;
+    void operator()(uint8_t t, const uint8_t* p, size_t n) { (*sink)(t, p, n); }
+};
+
+void setUp(void) { rngState = 1; }
+void tearDown(void) {}
+
+void test_crc_check_value(void) {
+    const uint8_t check[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+    TEST_ASSERT_EQUAL_HEX16(0x29B1, crc16Ccitt(check, sizeof(check)));
+}
+
+// Every length across the 254-byte block boundary: no zero inside the frame,
+// size within cobsFrameSize(), decodes back to type | payload | crc
+void test_encode_decode_round_trip(void) {
+    static uint8_t payload[600];
+    static uint8_t frame[cobsFrameSize(600)];
+    static uint8_t decoded[cobsFrameSize(600)];
+
+    for (size_t len = 0; len <= 600; len++) {
+        for (size_t i = 0; i < len; i++) payload[i] = rngByte();
+        if (len == 300) memset(payload, 0xAB, len);    // Long zero-free run
+
+        size_t n = cobsEncodeFrame(0x42, payload, len, frame);
+        TEST_ASSERT_LESS_OR_EQUAL_UINT32(cobsFrameSize(len), n);
+        TEST_ASSERT_EQUAL_HEX8(0x00, frame[n - 1]);
+        TEST_ASSERT_NULL(memchr(frame, 0x00, n - 1));
+
+        size_t m = cobsDecode(frame, n - 1, decoded);
+        TEST_ASSERT_EQUAL_UINT32(len + 3, m);
+        TEST_ASSERT_EQUAL_HEX8(0x42, decoded[0]);
+        if (len > 0) {
+            TEST_ASSERT_EQUAL_MEMORY(payload, decoded + 1, len);
+        }
+        uint16_t crc = (uint16_t)(decoded[m - 2] | (decoded[m - 1] << 8));
+        TEST_ASSERT_EQUAL_HEX16(crc16Ccitt(decoded, m - 2), crc);
+    }
+}
+
+// The same stream split at random points delivers the same frames
+void test_parser_any_chunking(void) {
+    static uint8_t stream[64 * cobsFrameSize(MAX_PAYLOAD)];
+    uint8_t payloads[64][MAX_PAYLOAD];
+    size_t lens[64];
+    size_t total = 0;
+
+    for (int f = 0; f < 64; f++) {
+        lens[f] = rng() % (MAX_PAYLOAD + 1);
+        for (size_t i = 0; i < lens[f]; i++) payloads[f][i] = rngByte();
+        total += cobsEncodeFrame((uint8_t)f, payloads[f], lens[f], stream + total);
+    }
+
+    for (int pass = 0; pass < 50; pass++) {
+        LinkParser parser;
+        Sink sink;
+        size_t pos = 0;
+        while (pos < total) {
+            size_t chunk = pass == 0 ? 1 : 1 + rng() % 97;
+            if (chunk > total - pos) chunk = total - pos;
+            parser.feed(stream + pos, chunk, SinkRef{&sink});
+            pos += chunk;
+        }
+        TEST_ASSERT_EQUAL_UINT32(64, sink.count);
+        TEST_ASSERT_EQUAL_UINT32(64, parser.getStats().good);
+        for (int f = 0; f < 64; f++) {
+            TEST_ASSERT_EQUAL_UINT8(f, sink.type[f]);
+            TEST_ASSERT_EQUAL_UINT32(lens[f], sink.len[f]);
+            if (lens[f] > 0) {
+                TEST_ASSERT_EQUAL_MEMORY(payloads[f], sink.payload[f], lens[f]);
+            }
+        }
+    }
+}
+
+// Random noise: nothing crashes, and what little gets through has a valid CRC
+// (about 1 in 65536 noise frames is expected to pass)
+void test_parser_fuzz_noise(void) {
+    LinkParser parser;
+    Sink sink;
+    static uint8_t noise[1 << 16];
+    uint32_t frames = 0;
+
+    for (int round = 0; round < 64; round++) {
+        for (size_t i = 0; i < sizeof(noise); i++) noise[i] = rngByte();
+        for (size_t i = 0; i < sizeof(noise); i++) frames += noise[i] == 0;
+        parser.feed(noise, sizeof(noise), SinkRef{&sink});
+    }
+    const LinkStats& stats = parser.getStats();
+    TEST_ASSERT_EQUAL_UINT32(64UL << 16, stats.bytes);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(frames, stats.good + stats.badCrc + stats.resync);
+    TEST_ASSERT_LESS_THAN_UINT32(frames / 1000 + 2, stats.good);
+}
+
+// One bit flipped in each of a run of frames: none of them is delivered
+// damaged, and every intact frame after a damaged one still arrives
+void test_parser_corrupted_frames_resync(void) {
+    static const int FRAMES = 400;
+    static uint8_t stream[FRAMES * cobsFrameSize(MAX_PAYLOAD)];
+    static uint8_t payloads[FRAMES][MAX_PAYLOAD];
+    static size_t lens[FRAMES];
+    bool damaged[FRAMES];
+    size_t total = 0;
+
+    for (int f = 0; f < FRAMES; f++) {
+        lens[f] = 4 + rng() % (MAX_PAYLOAD - 3);
+        for (size_t i = 0; i < lens[f]; i++) payloads[f][i] = rngByte();
+        payloads[f][0] = (uint8_t)f;
+        payloads[f][1] = (uint8_t)(f >> 8);
+        size_t n = cobsEncodeFrame(0x01, payloads[f], lens[f], stream + total);
+        damaged[f] = (f % 3) == 1;
+        if (damaged[f]) {
+            stream[total + rng() % (n - 1)] ^= (uint8_t)(1 << (rng() % 8));
+        }
+        total += n;
+    }
+
+    LinkParser parser;
+    Sink sink;
+    parser.feed(stream, total, SinkRef{&sink});
+
+    bool seen[FRAMES] = {};
+    for (size_t k = 0; k < sink.count && k < Sink::MAX_FRAMES; k++) {
+        TEST_ASSERT_GREATER_OR_EQUAL_UINT32(2, sink.len[k]);
+        int f = sink.payload[k][0] | (sink.payload[k][1] << 8);
+        TEST_ASSERT_TRUE(f < FRAMES);
+        TEST_ASSERT_EQUAL_UINT32(lens[f], sink.len[k]);
+        TEST_ASSERT_EQUAL_MEMORY(payloads[f], sink.payload[k], lens[f]);
+        seen[f] = true;
+    }
+    for (int f = 0; f < FRAMES; f++) {
+        if (!damaged[f]) {
+            TEST_ASSERT_TRUE(seen[f]);
+        }
+    }
+}
+
+void test_parser_drops_oversized_frame(void) {
+    uint8_t big[MAX_PAYLOAD + 40];
+    uint8_t small[4] = {1, 2, 3, 4};
+    uint8_t stream[cobsFrameSize(sizeof(big)) + cobsFrameSize(sizeof(small))];
+    memset(big, 0x55, sizeof(big));
+    size_t n = cobsEncodeFrame(0x01, big, sizeof(big), stream);
+    n += cobsEncodeFrame(0x02, small, sizeof(small), stream + n);
+
+    LinkParser parser;
+    Sink sink;
+    parser.feed(stream, n, SinkRef{&sink});
+    TEST_ASSERT_EQUAL_UINT32(1, sink.count);
+    TEST_ASSERT_EQUAL_UINT8(0x02, sink.type[0]);
+    TEST_ASSERT_EQUAL_UINT32(1, parser.getStats().resync);
+}
+
+// Parser speed on the host, in status-sized frames. Not a device figure, but
+// a regression here shows up long before it costs UART bytes on the ESP32.
+void test_parser_throughput(void) {
+    static uint8_t stream[1024 * cobsFrameSize(32)];
+    uint8_t payload[32];
+    size_t total = 0;
+    for (int f = 0; f < 1024; f++) {
+        for (size_t i = 0; i < sizeof(payload); i++) payload[i] = rngByte();
+        total += cobsEncodeFrame(0x02, payload, sizeof(payload), stream + total);
+    }
+
+    LinkParser parser;
+    uint32_t frames = 0;
+    const int ROUNDS = 200;
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < ROUNDS; r++) {
+        size_t pos = 0;
+        while (pos < total) {
+            size_t chunk = total - pos < 128 ? total - pos : 128;    // UART FIFO-sized reads
+            parser.feed(stream + pos, chunk, [&frames](uint8_t, const uint8_t*, size_t) { frames++; });
+            pos += chunk;
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    double mbPerS = (double)total * ROUNDS / seconds / 1e6;
+
+    char msg[96];
+    snprintf(msg, sizeof(msg), "parser: %.1f MB/s, %.0f frames/s (115200 baud is 0.0115 MB/s)",
+             mbPerS, frames / seconds);
+    TEST_MESSAGE(msg);
+    TEST_ASSERT_EQUAL_UINT32(1024UL * ROUNDS, frames);
+    TEST_ASSERT_GREATER_THAN_FLOAT(1.0f, (float)mbPerS);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_crc_check_value);
+    RUN_TEST(test_encode_decode_round_trip);
+    RUN_TEST(test_parser_any_chunking);
+    RUN_TEST(test_parser_fuzz_noise);
+    RUN_TEST(test_parser_corrupted_frames_resync);
+    RUN_TEST(test_parser_drops_oversized_frame);
+    RUN_TEST(test_parser_throughput);
+    return UNITY_END();
+}
@@ -0,0 +1,101 @@
+// Host tests for CommandArbiter (pio test -e native)
+
+#include <unity.h>
+#include "command_arbiter.h"
+
+static const uint32_t RESTART_MS = 5000;
+
+static HeaterCommand makeCommand(uint8_t source, uint32_t seq, int64_t us, uint8_t zone = 0) {
+    HeaterCommand cmd;
+    cmd.source = source;
+    cmd.zone = zone;
+    cmd.enable = CMD_ENABLE_UNCHANGED;
+    cmd.setpoint_c_x10 = 1000;
+    cmd.seq = seq;
+    cmd.receivedMs = (uint32_t)(us / 1000);
+    cmd.receivedUs = us;
+    return cmd;
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_last_writer_wins(void) {
+    CommandArbiter arbiter(RESTART_MS);
+    TEST_ASSERT_EQUAL(CommandArbiter::APPLY, arbiter.arbitrate(makeCommand(CMD_SRC_DISPLAY, 1, 1000)));
+    TEST_ASSERT_EQUAL(CommandArbiter::APPLY, arbiter.arbitrate(makeCommand(CMD_SRC_BLE, 1, 2000)));
+    TEST_ASSERT_EQUAL(CMD_SRC_BLE, arbiter.getOwner(0));
+    TEST_ASSERT_EQUAL(CommandArbiter::APPLY, arbiter.arbitrate(makeCommand(CMD_SRC_DISPLAY, 2, 3000)));
+    TEST_ASSERT_EQUAL(CMD_SRC_DISPLAY, arbiter.getOwner(0));
+}
+
+void test_keepalive_is_duplicate(void) {
+    CommandArbiter arbiter(RESTART_MS);
+    arbiter.arbitrate(makeCommand(CMD_SRC_DISPLAY, 5, 1000));
+    arbiter.arbitrate(makeCommand(CMD_SRC_BLE, 1, 2000));
+    // Display keepalive repeats seq 5: must not take the zone back
+    TEST_ASSERT_EQUAL(CommandArbiter::DUPLICATE, arbiter.arbitrate(makeCommand(CMD_SRC_DISPLAY, 5, 3000)));
+    TEST_ASSERT_EQUAL(CMD_SRC_BLE, arbiter.getOwner(0));
+    TEST_ASSERT_EQUAL(1, arbiter.getCounters().duplicates);
+}
+
+void test_race_loser_is_stale(void) {
+    CommandArbiter arbiter(RESTART_MS);
+    // BLE stamped later but dequeued first; the older display command lost
+    TEST_ASSERT_EQUAL(CommandArbiter::APPLY, arbiter.arbitrate(makeCommand(CMD_SRC_BLE, 1, 2000)));
+    TEST_ASSERT_EQUAL(CommandArbiter::STALE, arbiter.arbitrate(makeCommand(CMD_SRC_DISPLAY, 1, 1500)));
+    TEST_ASSERT_EQUAL(CMD_SRC_BLE, arbiter.getOwner(0));
+    TEST_ASSERT_EQUAL(1, arbiter.lastSeq(CMD_SRC_DISPLAY));
+}
+
+void test_zones_are_independent(void) {
+    CommandArbiter arbiter(RESTART_MS);
+    arbiter.arbitrate(makeCommand(CMD_SRC_BLE, 1, 2000, 1));
+    TEST_ASSERT_EQUAL(CommandArbiter::APPLY, arbiter.arbitrate(makeCommand(CMD_SRC_DISPLAY, 1, 1500, 0)));
+    TEST_ASSERT_EQUAL(CMD_SRC_DISPLAY, arbiter.getOwner(0));
+    TEST_ASSERT_EQUAL(CMD_SRC_BLE, arbiter.getOwner(1));
+}
+
+void test_source_restart_is_accepted(void) {
+    CommandArbiter arbiter(RESTART_MS);
+    arbiter.arbitrate(makeCommand(CMD_SRC_DISPLAY, 5000, 1000));
+    // Seq jumped back past the restart window: the display rebooted
+    TEST_ASSERT_EQUAL(CommandArbiter::APPLY, arbiter.arbitrate(makeCommand(CMD_SRC_DISPLAY, 1, 2000)));
+    TEST_ASSERT_EQUAL(1, arbiter.lastSeq(CMD_SRC_DISPLAY));
+}
+
+void test_invalid_zone_rejected(void) {
+    CommandArbiter arbiter(RESTART_MS);
+    TEST_ASSERT_EQUAL(CommandArbiter::STALE,
+                      arbiter.arbitrate(makeCommand(CMD_SRC_DISPLAY, 1, 1000, CMD_MAX_ZONES)));
+    TEST_ASSERT_EQUAL(CMD_SRC_DISPLAY, arbiter.getOwner(CMD_MAX_ZONES));
+}
+
+// A command after a long idle must apply: the 32-bit low half of the stamp
+// wraps every 71.6 min and would look older than the one in force
+void test_long_idle_does_not_wrap(void) {
+    const int64_t HALF_WRAP = (int64_t)1 << 31;
+    const int64_t idles[] = { HALF_WRAP + 1000, 3 * HALF_WRAP, 2 * HALF_WRAP + 1000, 10 * HALF_WRAP };
+
+    for (unsigned i = 0; i < sizeof(idles) / sizeof(idles[0]); i++) {
+        CommandArbiter arbiter(RESTART_MS);
+        const int64_t t0 = 123456789LL;
+        arbiter.arbitrate(makeCommand(CMD_SRC_DISPLAY, 1, t0));
+        TEST_ASSERT_EQUAL(CommandArbiter::APPLY,
+                          arbiter.arbitrate(makeCommand(CMD_SRC_BLE, 1, t0 + idles[i])));
+        TEST_ASSERT_EQUAL(CMD_SRC_BLE, arbiter.getOwner(0));
+        TEST_ASSERT_EQUAL(0, arbiter.getCounters().stale);
+    }
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_last_writer_wins);
+    RUN_TEST(test_keepalive_is_duplicate);
+    RUN_TEST(test_race_loser_is_stale);
+    RUN_TEST(test_zones_are_independent);
+    RUN_TEST(test_source_restart_is_accepted);
+    RUN_TEST(test_invalid_zone_rejected);
+    RUN_TEST(test_long_idle_does_not_wrap);
+    return UNITY_END();
+}
@@ -0,0 +1,282 @@
+// Host tests for the ESP-NOW pairing gate, latency stats and command sender
+// (pio test -e native)
+
+#include <unity.h>
+#include <stdio.h>
+#include "espnow_link.h"
+
+static const uint8_t DISPLAY_A[RADIO_MAC_LEN] = {0x24, 0x6f, 0x28, 0xaa, 0x10, 0x3c};
+static const uint8_t DISPLAY_B[RADIO_MAC_LEN] = {0x24, 0x6f, 0x28, 0xbb, 0x20, 0x4d};
+static const uint8_t CONTROLLER[RADIO_MAC_LEN] = {0x24, 0x6f, 0x28, 0x01, 0x02, 0x03};
+static const uint32_t WINDOW_MS = 60000;
+
+// Link model: each pump() is one step of air time, so a clean command ->
+// status round trip takes two steps.
+static const uint32_t STEP_US  = 1000;
+static const uint32_t RETRY_US = 20000;
+static const uint8_t  RETRIES  = 3;
+
+// Minimal frames: [type][seq, 4 bytes little endian]
+static const uint8_t FRAME_COMMAND = 0x01;
+static const uint8_t FRAME_STATUS  = 0x02;
+static const size_t  FRAME_LEN     = 5;
+
+static void encodeFrame(uint8_t* out, uint8_t type, uint32_t seq) {
+    out[0] = type;
+    for (int i = 0; i < 4; i++) out[1 + i] = (uint8_t)(seq >> (8 * i));
+}
+
+static uint32_t decodeSeq(const uint8_t* data) {
+    return (uint32_t)data[1] | ((uint32_t)data[2] << 8) |
+           ((uint32_t)data[3] << 16) | ((uint32_t)data[4] << 24);
+}
+
+// Controller stand-in: gated like processRadio(), echoes each command's seq
+struct ControllerSim {
+    LoopbackRadio& radio;
+    RadioPeerGate gate;
+    uint32_t commands;
+    uint32_t lastSeq;
+
+    explicit ControllerSim(LoopbackRadio& port) : radio(port), commands(0), lastSeq(0) {}
+
+    static void onFrame(void* context, const uint8_t* mac, const uint8_t* data, size_t len) {
+        ControllerSim* self = (ControllerSim*)context;
+        if (!self->gate.accepts(mac) || len != FRAME_LEN || data[0] != FRAME_COMMAND) {
+            return;
+        }
+        self->commands++;
+        self->lastSeq = decodeSeq(data);
+        uint8_t status[FRAME_LEN];
+        encodeFrame(status, FRAME_STATUS, self->lastSeq);
+        self->radio.send(mac, status, sizeof(status));
+    }
+};
+
+struct DisplaySim {
+    CommandSender& sender;
+    uint32_t nowUs;
+
+    static void onFrame(void* context, const uint8_t* mac, const uint8_t* data, size_t len) {
+        (void)mac;
+        DisplaySim* self = (DisplaySim*)context;
+        if (len == FRAME_LEN && data[0] == FRAME_STATUS) {
+            self->sender.onEcho(decodeSeq(data), self->nowUs);
+        }
+    }
+};
+
+struct Link {
+    LoopbackRadio displayRadio;
+    LoopbackRadio controllerRadio;
+    ControllerSim controller;
+    CommandSender sender;
+    DisplaySim display;
+
+    Link()
+        : displayRadio(DISPLAY_A), controllerRadio(CONTROLLER), controller(controllerRadio),
+          sender(displayRadio, CONTROLLER, RETRY_US, RETRIES), display{sender, 0} {
+        LoopbackRadio::connect(displayRadio, controllerRadio);
+        controller.gate.restore(DISPLAY_A);
+    }
+
+    void step() {
+        display.nowUs += STEP_US;
+        displayRadio.pump(DisplaySim::onFrame, &display);
+        controllerRadio.pump(ControllerSim::onFrame, &controller);
+        sender.poll(display.nowUs);
+    }
+
+    void command(uint32_t seq) {
+        uint8_t frame[FRAME_LEN];
+        encodeFrame(frame, FRAME_COMMAND, seq);
+        sender.send(frame, sizeof(frame), seq, display.nowUs);
+    }
+
+    // Step until the command is echoed or abandoned
+    void settle() {
+        for (int i = 0; i < 1000 && sender.isPending(); i++) {
+            step();
+        }
+    }
+};
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_unpaired_accepts_nothing(void) {
+    RadioPeerGate gate;
+    TEST_ASSERT_FALSE(gate.isPaired());
+    TEST_ASSERT_FALSE(gate.accepts(DISPLAY_A));
+    TEST_ASSERT_FALSE(gate.pairRequest(DISPLAY_A, 1000));
+}
+
+void test_pairs_inside_window_only(void) {
+    RadioPeerGate gate;
+    gate.openWindow(1000, WINDOW_MS);
+    TEST_ASSERT_TRUE(gate.pairRequest(DISPLAY_A, 2000));
+    TEST_ASSERT_TRUE(gate.accepts(DISPLAY_A));
+    TEST_ASSERT_FALSE(gate.accepts(DISPLAY_B));
+    // Pairing closes the window: a second display cannot take over
+    TEST_ASSERT_FALSE(gate.pairRequest(DISPLAY_B, 3000));
+    TEST_ASSERT_TRUE(gate.accepts(DISPLAY_A));
+}
+
+void test_window_expires(void) {
+    RadioPeerGate gate;
+    gate.openWindow(1000, WINDOW_MS);
+    TEST_ASSERT_TRUE(gate.isWindowOpen(1000 + WINDOW_MS - 1));
+    TEST_ASSERT_FALSE(gate.pairRequest(DISPLAY_A, 1000 + WINDOW_MS));
+    TEST_ASSERT_FALSE(gate.isPaired());
+}
+
+void test_restored_peer_needs_no_window(void) {
+    RadioPeerGate gate;
+    gate.restore(DISPLAY_A);
+    TEST_ASSERT_TRUE(gate.accepts(DISPLAY_A));
+    TEST_ASSERT_FALSE(gate.isWindowOpen(0));
+    // The stored display may repeat its request; a stranger may not pair
+    TEST_ASSERT_TRUE(gate.pairRequest(DISPLAY_A, 5000));
+    TEST_ASSERT_FALSE(gate.pairRequest(DISPLAY_B, 5000));
+}
+
+void test_repair_replaces_peer(void) {
+    RadioPeerGate gate;
+    gate.restore(DISPLAY_A);
+    gate.openWindow(1000, WINDOW_MS);
+    TEST_ASSERT_TRUE(gate.pairRequest(DISPLAY_B, 2000));
+    TEST_ASSERT_TRUE(gate.accepts(DISPLAY_B));
+    TEST_ASSERT_FALSE(gate.accepts(DISPLAY_A));
+}
+
+void test_latency_tracker(void) {
+    LatencyTracker tracker;
+    LatencySnapshot empty = tracker.snapshot();
+    TEST_ASSERT_EQUAL(0, empty.samples);
+    TEST_ASSERT_EQUAL(0, empty.minUs);
+
+    tracker.record(800);
+    tracker.record(1200);
+    tracker.record(2500);
+    LatencySnapshot snap = tracker.snapshot();
+    TEST_ASSERT_EQUAL(3, snap.samples);
+    TEST_ASSERT_EQUAL(800, snap.minUs);
+    TEST_ASSERT_EQUAL(1500, snap.avgUs);
+    TEST_ASSERT_EQUAL(2500, snap.maxUs);
+
+    tracker.reset();
+    TEST_ASSERT_EQUAL(0, tracker.snapshot().samples);
+}
+
+void test_clean_link_samples_every_rtt(void) {
+    Link link;
+    for (uint32_t seq = 1; seq <= 10; seq++) {
+        link.command(seq);
+        link.settle();
+    }
+    const CommandSender::Counters& c = link.sender.getCounters();
+    TEST_ASSERT_EQUAL(10, c.sent);
+    TEST_ASSERT_EQUAL(10, c.acked);
+    TEST_ASSERT_EQUAL(0, c.retransmits);
+    TEST_ASSERT_EQUAL(0, c.failed);
+
+    LatencySnapshot rtt = link.sender.getRtt();
+    TEST_ASSERT_EQUAL(10, rtt.samples);
+    TEST_ASSERT_EQUAL(2 * STEP_US, rtt.minUs);
+    TEST_ASSERT_EQUAL(2 * STEP_US, rtt.maxUs);
+}
+
+void test_dropped_command_resent_until_echoed(void) {
+    Link link;
+    link.displayRadio.dropNext(2);     // First copy and first resend lost
+    link.command(7);
+    link.settle();
+
+    const CommandSender::Counters& c = link.sender.getCounters();
+    TEST_ASSERT_FALSE(link.sender.isPending());
+    TEST_ASSERT_EQUAL(1, c.acked);
+    TEST_ASSERT_EQUAL(2, c.retransmits);
+    TEST_ASSERT_EQUAL(0, c.failed);
+    TEST_ASSERT_EQUAL(1, link.controller.commands);
+    TEST_ASSERT_EQUAL(7, link.controller.lastSeq);
+    // Acknowledged only after resends: no RTT sample
+    TEST_ASSERT_EQUAL(0, link.sender.getRtt().samples);
+}
+
+void test_rtt_sampled_only_without_resend(void) {
+    Link link;
+    // The controller ran the first copy but its echo was lost, so the echo
+    // that finally arrives answers the resend, not the original
+    link.controllerRadio.dropNext(1);
+    link.command(1);
+    link.settle();
+    TEST_ASSERT_EQUAL(1, link.sender.getCounters().retransmits);
+    TEST_ASSERT_EQUAL(2, link.controller.commands);
+    TEST_ASSERT_EQUAL(0, link.sender.getRtt().samples);
+
+    link.command(2);
+    link.settle();
+    LatencySnapshot rtt = link.sender.getRtt();
+    TEST_ASSERT_EQUAL(1, rtt.samples);
+    TEST_ASSERT_EQUAL(2 * STEP_US, rtt.maxUs);
+}
+
+void test_stale_echo_does_not_ack_newer_command(void) {
+    Link link;
+    link.command(5);
+    link.sender.onEcho(4, link.display.nowUs);
+    TEST_ASSERT_TRUE(link.sender.isPending());
+    link.settle();
+    TEST_ASSERT_EQUAL(1, link.sender.getCounters().acked);
+}
+
+void test_gives_up_after_retry_limit(void) {
+    Link link;
+    link.controller.gate.forget();      // Controller ignores the display
+    link.command(3);
+    link.settle();
+
+    const CommandSender::Counters& c = link.sender.getCounters();
+    TEST_ASSERT_FALSE(link.sender.isPending());
+    TEST_ASSERT_EQUAL(RETRIES, c.retransmits);
+    TEST_ASSERT_EQUAL(1, c.failed);
+    TEST_ASSERT_EQUAL(0, c.acked);
+    TEST_ASSERT_EQUAL(1 + RETRIES, link.displayRadio.sendCount());
+    TEST_ASSERT_EQUAL(0, link.sender.getRtt().samples);
+}
+
+void test_lossy_link_delivers_every_command(void) {
+    Link link;
+    link.displayRadio.setDropMask(0x3);     // Every fourth frame lost
+    for (uint32_t seq = 1; seq <= 200; seq++) {
+        link.command(seq);
+        link.settle();
+        TEST_ASSERT_EQUAL(seq, link.controller.lastSeq);
+    }
+    const CommandSender::Counters& c = link.sender.getCounters();
+    TEST_ASSERT_EQUAL(200, c.acked);
+    TEST_ASSERT_EQUAL(0, c.failed);
+    TEST_ASSERT_EQUAL(c.retransmits + 200, link.displayRadio.sendCount());
+
+    char msg[96];
+    snprintf(msg, sizeof(msg), "200 commands, %lu retransmits, %lu RTT samples",
+             (unsigned long)c.retransmits, (unsigned long)link.sender.getRtt().samples);
+    TEST_MESSAGE(msg);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_unpaired_accepts_nothing);
+    RUN_TEST(test_pairs_inside_window_only);
+    RUN_TEST(test_window_expires);
+    RUN_TEST(test_restored_peer_needs_no_window);
+    RUN_TEST(test_repair_replaces_peer);
+    RUN_TEST(test_latency_tracker);
+    RUN_TEST(test_clean_link_samples_every_rtt);
+    RUN_TEST(test_dropped_command_resent_until_echoed);
+    RUN_TEST(test_rtt_sampled_only_without_resend);
+    RUN_TEST(test_stale_echo_does_not_ack_newer_command);
+    RUN_TEST(test_gives_up_after_retry_limit);
+    RUN_TEST(test_lossy_link_delivers_every_command);
+    return UNITY_END();
+}
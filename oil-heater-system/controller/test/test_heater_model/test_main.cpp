@@ -0,0 +1,232 @@
+// Validates HeaterModel against simulated zone traces: healthy heat-up and
+// hold, welded relay, open element, detached probe (pio test -e native)
+
+#include <stdio.h>
+#include <math.h>
+#include <unity.h>
+#include "temp_filter.h"
+#include "heater_model.h"
+
+// Values from main.cpp
+static const uint32_t TEMP_READ_MS         = 250;
+static const uint32_t HEATER_LAG_MS        = 20000;
+static const uint32_t HEATER_WINDOW_MS     = 30000;
+static const int32_t  HEATER_MIN_RISE      = 6;
+static const int32_t  HEATER_NOMINAL_RISE  = 30;
+static const int32_t  PROBE_DETACH_FALL    = 300;
+static const uint8_t  PROBE_DETACH_CONFIRM = 8;
+static const float    SETPOINT_C           = 110.0f;
+static const float    HYSTERESIS_C         = 2.0f;
+
+typedef FilterChain<Median3, MovingAverage<4>> TempFilter;
+
+// ============================================================================
+// Zone simulation
+// ============================================================================
+// Element and oil as two thermal masses, so the element's stored heat keeps
+// the oil rising for a while after the relay opens. The probe follows the
+// oil with a 4 s lag (20 s towards ambient once detached). Readings are
+// MAX6675 counts with 0.25 °C of noise, through the controller's filter.
+enum Event { NONE, WELD, OPEN, DETACH };
+
+struct ZoneSim {
+    double elementC = 20, oilC = 20, probeC = 20;
+    double ambientC = 20;
+    double heaterW;
+    double oilJPerC = 7000, elementJPerC = 300, couplingWPerC = 50;
+    bool welded = false, open = false, detached = false;
+    uint32_t rng;
+
+    ZoneSim(double watts, uint32_t seed) : heaterW(watts), rng(seed * 2654435761u + 1) {}
+
+    double gaussian() {
+        double u1, u2;
+        rng ^= rng << 13; rng ^= rng >> 17; rng ^= rng << 5;
+        u1 = ((rng >> 8) + 1.0) / 16777217.0;
+        rng ^= rng << 13; rng ^= rng >> 17; rng ^= rng << 5;
+        u2 = (rng >> 8) / 16777216.0;
+        return sqrt(-2.0 * log(u1)) * cos(6.283185307179586 * u2);
+    }
+
+    // Advance one read period with the relay commanded to relay; returns
+    // the raw reading in °C × 10
+    int32_t step(bool relay) {
+        const double dt = TEMP_READ_MS / 1000.0;
+        bool on = (relay || welded) && !open;
+        double toOil = couplingWPerC * (elementC - oilC);
+        double lossW = heaterW / 180.0 * (oilC - ambientC);     // Full power levels off ~200 °C up
+        elementC += ((on ? heaterW : 0.0) - toOil) / elementJPerC * dt;
+        oilC += (toOil - lossW) / oilJPerC * dt;
+        double target = detached ? ambientC + 5.0 : oilC;
+        probeC += (target - probeC) * dt / (detached ? 20.0 : 4.0);
+        double counts = floor((probeC + 0.25 * gaussian()) * 4.0 + 0.5);
+        return (int32_t)lround(counts * 2.5);
+    }
+};
+
+struct RunResult {
+    HeaterModel::Verdict verdict;   // Latched at the end of the run
+    double eventS;          // When the fault was injected, -1 if never
+    double detectS;         // Time of the first non-OK verdict, -1 if none
+};
+
+static const HeaterModelConfig CONFIG = {
+    TEMP_READ_MS, HEATER_LAG_MS, HEATER_WINDOW_MS, HEATER_MIN_RISE,
+    HEATER_NOMINAL_RISE, PROBE_DETACH_FALL, PROBE_DETACH_CONFIRM,
+};
+
+// Bang-bang thermostat as in updateThermostat(), relay forced off on a fault.
+// The event is injected at eventS, or with onRelayOff at the first relay-off
+// edge after it.
+static RunResult run(const HeaterModelConfig& cfg, double watts, uint32_t seed,
+                     Event event, double eventS, bool onRelayOff = false,
+                     double minutes = 90) {
+    ZoneSim zone(watts, seed);
+    HeaterModel model(cfg);
+    TempFilter filter;
+    RunResult r = {HeaterModel::OK, -1, -1};
+    bool relay = false;
+    bool wasRelay = false;
+
+    uint32_t steps = (uint32_t)(minutes * 60000 / TEMP_READ_MS);
+    for (uint32_t i = 0; i < steps; i++) {
+        double t = i * TEMP_READ_MS / 1000.0;
+        bool edge = wasRelay && !relay;
+        wasRelay = relay;
+        if (r.eventS < 0 && event != NONE && t >= eventS && (!onRelayOff || edge)) {
+            r.eventS = t;
+            zone.welded = event == WELD;
+            zone.open = event == OPEN;
+            zone.detached = event == DETACH;
+        }
+
+        int32_t filtered = filter.update(zone.step(relay));
+        HeaterModel::Verdict v = model.update(filtered, relay, i * TEMP_READ_MS);
+        if (v != HeaterModel::OK && r.detectS < 0) {
+            r.detectS = t;
+        }
+
+        float c = filtered / 10.0f;
+        if (v != HeaterModel::OK) relay = false;
+        else if (c <= SETPOINT_C - HYSTERESIS_C) relay = true;
+        else if (c >= SETPOINT_C + HYSTERESIS_C) relay = false;
+    }
+    r.verdict = model.verdict();
+    return r;
+}
+
+static const uint32_t SEEDS = 5;
+
+void setUp(void) {}
+void tearDown(void) {}
+
+// 90 minutes from cold through hold: no false alarm, with either element size
+void test_healthy_zone_never_faults(void) {
+    const double watts[] = {500, 250};
+    for (unsigned w = 0; w < 2; w++) {
+        for (uint32_t seed = 1; seed <= SEEDS; seed++) {
+            RunResult r = run(CONFIG, watts[w], seed, NONE, 0);
+            if (r.verdict != HeaterModel::OK) {
+                char msg[80];
+                snprintf(msg, sizeof(msg), "%.0f W seed %u: verdict %d at %.1f s",
+                         watts[w], (unsigned)seed, r.verdict, r.detectS);
+                TEST_MESSAGE(msg);
+            }
+            TEST_ASSERT_EQUAL(HeaterModel::OK, r.verdict);
+        }
+    }
+}
+
+// Without the post-switch lag, the element's stored heat after each relay-off
+// reads as a welded relay: HEATER_LAG_MS is what keeps healthy zones quiet
+void test_lag_suppresses_overshoot_false_alarm(void) {
+    HeaterModelConfig noLag = CONFIG;
+    noLag.lagMs = 0;
+    uint32_t falseAlarms = 0;
+    for (uint32_t seed = 1; seed <= SEEDS; seed++) {
+        RunResult r = run(noLag, 500, seed, NONE, 0);
+        if (r.verdict == HeaterModel::STUCK_RELAY) falseAlarms++;
+    }
+    TEST_ASSERT_GREATER_THAN_UINT32(0, falseAlarms);
+}
+
+// Relay welded as the thermostat opens it during the hold. Nothing is judged
+// inside the lag, and the excess rise is judged before the window completes,
+// so detection lands between lag and lag + window.
+void test_welded_relay_detected_early(void) {
+    for (uint32_t seed = 1; seed <= SEEDS; seed++) {
+        RunResult r = run(CONFIG, 500, seed, WELD, 3000, true);
+        TEST_ASSERT_EQUAL(HeaterModel::STUCK_RELAY, r.verdict);
+        double latency = r.detectS - r.eventS;
+        char msg[64];
+        snprintf(msg, sizeof(msg), "seed %u: stuck relay after %.1f s", (unsigned)seed, latency);
+        TEST_MESSAGE(msg);
+        TEST_ASSERT_GREATER_OR_EQUAL_FLOAT(HEATER_LAG_MS / 1000.0f, (float)latency);
+        TEST_ASSERT_LESS_THAN_FLOAT((HEATER_LAG_MS + HEATER_WINDOW_MS) / 1000.0f, (float)latency);
+    }
+}
+
+void test_open_element_detected(void) {
+    for (uint32_t seed = 1; seed <= SEEDS; seed++) {
+        RunResult r = run(CONFIG, 500, seed, OPEN, 3000);
+        TEST_ASSERT_EQUAL(HeaterModel::OPEN_ELEMENT, r.verdict);
+        TEST_ASSERT_LESS_THAN_FLOAT(180.0f, (float)(r.detectS - r.eventS));
+    }
+}
+
+// Pulled off during the hold: flagged within seconds, whether the relay is
+// on or off, and not later overridden by the flat reading it leaves
+void test_detached_probe_detected(void) {
+    for (uint32_t seed = 1; seed <= SEEDS; seed++) {
+        RunResult r = run(CONFIG, 500, seed, DETACH, 3000);
+        TEST_ASSERT_EQUAL(HeaterModel::PROBE_DETACHED, r.verdict);
+        TEST_ASSERT_LESS_THAN_FLOAT(10.0f, (float)(r.detectS - r.eventS));
+    }
+}
+
+// Probe pulled off early in a cold heat-up: it barely falls, but the relay
+// is on and the reading stops rising, so some fault must latch
+void test_detached_probe_during_heatup_faults(void) {
+    for (uint32_t seed = 1; seed <= SEEDS; seed++) {
+        RunResult r = run(CONFIG, 500, seed, DETACH, 300, false, 10);
+        TEST_ASSERT_TRUE(r.verdict != HeaterModel::OK);
+    }
+}
+
+// Fed directly: an open-element verdict is replaced by a stuck relay, and
+// faults hold until clear()
+void test_stuck_relay_overrides_latched_fault(void) {
+    HeaterModel model(CONFIG);
+    uint32_t ms = 0;
+    int32_t temp = 1000;
+
+    // Relay on, temperature flat: open element after lag + window
+    for (int i = 0; i < 4 * 60; i++, ms += TEMP_READ_MS) model.update(temp, true, ms);
+    TEST_ASSERT_EQUAL(HeaterModel::OPEN_ELEMENT, model.verdict());
+
+    // Relay off, temperature climbing 3 °C/min: welded
+    for (int i = 0; i < 4 * 60; i++, ms += TEMP_READ_MS) {
+        temp += 1;      // 0.1 °C per 250 ms sample
+        model.update(temp, false, ms);
+    }
+    TEST_ASSERT_EQUAL(HeaterModel::STUCK_RELAY, model.verdict());
+
+    // Normal cooling afterwards does not unlatch it
+    for (int i = 0; i < 4 * 120; i++, ms += TEMP_READ_MS) model.update(temp, false, ms);
+    TEST_ASSERT_EQUAL(HeaterModel::STUCK_RELAY, model.verdict());
+
+    model.clear();
+    TEST_ASSERT_EQUAL(HeaterModel::OK, model.verdict());
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_healthy_zone_never_faults);
+    RUN_TEST(test_lag_suppresses_overshoot_false_alarm);
+    RUN_TEST(test_welded_relay_detected_early);
+    RUN_TEST(test_open_element_detected);
+    RUN_TEST(test_detached_probe_detected);
+    RUN_TEST(test_detached_probe_during_heatup_faults);
+    RUN_TEST(test_stuck_relay_overrides_latched_fault);
+    return UNITY_END();
+}
@@ -0,0 +1,233 @@
+// Host tests and benchmark for the fixed-point temperature filters, against
+// the 15-tap float moving average they replaced (pio test -e native)
+
+#include <stdio.h>
+#include <math.h>
+#include <chrono>
+#include <unity.h>
+#include "temp_filter.h"
+
+// The controller's chain (main.cpp TempFilter)
+typedef FilterChain<Median3, MovingAverage<4>> TempFilter;
+
+// The previous getSmoothedTemperature(): running float sum over 15 samples
+class LegacyAverage15 {
+private:
+    static const int NUM_SAMPLES = 15;
+    float readings[NUM_SAMPLES] = {0};
+    int index = 0;
+    float sum = 0.0f;
+    bool filled = false;
+
+public:
+    float update(float x) {
+        sum -= readings[index];
+        readings[index] = x;
+        sum += x;
+        index = (index + 1) % NUM_SAMPLES;
+        if (index == 0) filled = true;
+        return filled ? sum / NUM_SAMPLES : sum / (index > 0 ? index : NUM_SAMPLES);
+    }
+};
+
+// Thermocouple trace at the 250 ms read interval: MAX6675 counts (0.25 °C)
+// with about 0.3 °C of noise and an occasional one-sample spike
+struct TraceSource {
+    uint32_t state = 2463534242u;
+    uint32_t n = 0;
+
+    float uniform() {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return (state & 0xFFFFFF) / (float)0x1000000;
+    }
+
+    // Reading in °C for a true temperature
+    float read(float trueC, bool spikes) {
+        n++;
+        float noise = (uniform() + uniform() + uniform() - 1.5f) * 0.6f;
+        float c = trueC + noise;
+        if (spikes && n % 97 == 0) c += 8.0f;
+        return roundf(c * 4.0f) / 4.0f;
+    }
+};
+
+static int32_t toX10(float c) { return (int32_t)lroundf(c * 10.0f); }
+
+struct Metrics {
+    float rampLagC;         // Mean shortfall while ramping at 0.1 °C / sample
+    float holdStdC;         // Standard deviation at a constant temperature
+    float spikeC;           // Largest excursion caused by spikes while holding
+};
+
+template <typename Filter>
+static Metrics measure(Filter& filter) {
+    TraceSource source;
+    Metrics m = {0, 0, 0};
+
+    // 400 samples at 100 °C, then a 0.4 °C/s ramp (0.1 per sample)
+    double sum = 0, sumSq = 0;
+    int count = 0;
+    for (int i = 0; i < 400; i++) {
+        float out = filter.update(source.read(100.0f, false));
+        if (i >= 100) {
+            sum += out;
+            sumSq += (double)out * out;
+            count++;
+        }
+    }
+    double mean = sum / count;
+    m.holdStdC = (float)sqrt(sumSq / count - mean * mean);
+
+    filter.reset();
+    TraceSource spikes;
+    for (int i = 0; i < 2000; i++) {
+        float out = filter.update(spikes.read(100.0f, true));
+        if (i >= 100 && fabsf(out - 100.0f) > m.spikeC) m.spikeC = fabsf(out - 100.0f);
+    }
+
+    filter.reset();
+    double lag = 0;
+    count = 0;
+    for (int i = 0; i < 400; i++) {
+        float trueC = 100.0f + 0.1f * i;
+        float out = filter.update(source.read(trueC, false));
+        if (i >= 100) {
+            lag += trueC - out;
+            count++;
+        }
+    }
+    m.rampLagC = (float)(lag / count);
+    return m;
+}
+
+// Adapters: °C in and out, integer deci-degrees inside
+template <typename Chain>
+struct FixedPoint {
+    Chain chain;
+    float update(float c) { return chain.update(toX10(c)) / 10.0f; }
+    void reset() { chain.reset(); }
+};
+
+struct Legacy {
+    LegacyAverage15 avg;
+    float update(float c) { return avg.update(c); }
+    void reset() { avg = LegacyAverage15(); }
+};
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_median3_rejects_single_spike(void) {
+    Median3 m;
+    const int32_t in[] = {1000, 1000, 1000, 1800, 1000, 1000};
+    for (unsigned i = 0; i < sizeof(in) / sizeof(in[0]); i++) {
+        int32_t out = m.update(in[i]);
+        TEST_ASSERT_EQUAL_INT32(1000, out);
+    }
+}
+
+void test_moving_average_is_exact_over_long_runs(void) {
+    MovingAverage<4> avg;
+    // Ten days at 4 Hz of a slowly varying signal, then settle on 150.0 °C
+    for (uint32_t i = 0; i < 10UL * 24 * 3600 * 4; i++) {
+        avg.update(1000 + (int32_t)(i % 1000));
+    }
+    int32_t out = 0;
+    for (int i = 0; i < 4; i++) {
+        out = avg.update(1500);
+    }
+    TEST_ASSERT_EQUAL_INT32(1500, out);
+}
+
+void test_divround_symmetric(void) {
+    TEST_ASSERT_EQUAL_INT32(3, divRound(5, 2));
+    TEST_ASSERT_EQUAL_INT32(-3, divRound(-5, 2));
+    TEST_ASSERT_EQUAL_INT32(-2, divRound(-7, 4));
+    TEST_ASSERT_EQUAL_INT32(0, divRound(0, 3));
+}
+
+void test_ema_reaches_input(void) {
+    Ema<3> ema;
+    ema.update(1000);
+    int32_t out = 0;
+    for (int i = 0; i < 200; i++) out = ema.update(1003);
+    TEST_ASSERT_EQUAL_INT32(1003, out);    // A plain integer EMA stalls at 1000
+    for (int i = 0; i < 200; i++) out = ema.update(-250);
+    TEST_ASSERT_EQUAL_INT32(-250, out);
+}
+
+void test_kalman_converges(void) {
+    Kalman1D<1, 25> kalman;
+    int32_t out = kalman.update(200);
+    TEST_ASSERT_EQUAL_INT32(200, out);
+    for (int i = 0; i < 400; i++) out = kalman.update(1000);
+    TEST_ASSERT_INT_WITHIN(1, 1000, out);
+}
+
+void test_chain_reset_forgets_history(void) {
+    TempFilter filter;
+    for (int i = 0; i < 10; i++) filter.update(1500);
+    filter.reset();
+    TEST_ASSERT_EQUAL_INT32(200, filter.update(200));
+}
+
+// The controller chain against the old 15-tap float average on the same trace
+void test_benchmark_against_legacy_average(void) {
+    FixedPoint<TempFilter> chain;
+    Legacy legacy;
+    Metrics c = measure(chain);
+    Metrics l = measure(legacy);
+
+    char msg[128];
+    snprintf(msg, sizeof(msg), "median3+avg4: lag %.2fC noise %.3fC spike %.2fC",
+             c.rampLagC, c.holdStdC, c.spikeC);
+    TEST_MESSAGE(msg);
+    snprintf(msg, sizeof(msg), "legacy avg15: lag %.2fC noise %.3fC spike %.2fC",
+             l.rampLagC, l.holdStdC, l.spikeC);
+    TEST_MESSAGE(msg);
+
+    // Less than half the lag; spikes rejected; the shorter window is noisier
+    // than 15 taps but stays under one MAX6675 count
+    TEST_ASSERT_LESS_THAN_FLOAT(l.rampLagC * 0.5f, c.rampLagC);
+    TEST_ASSERT_LESS_THAN_FLOAT(1.0f, c.spikeC);
+    TEST_ASSERT_LESS_THAN_FLOAT(0.25f, c.holdStdC);
+}
+
+// Cost per sample on the host. Relative figures only: the ESP32 has an FPU
+// for floats but the chain avoids it altogether.
+void test_benchmark_cost_per_sample(void) {
+    const int SAMPLES = 4000000;
+    TempFilter chain;
+    LegacyAverage15 legacy;
+    volatile int32_t sinkI = 0;
+    volatile float sinkF = 0;
+
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < SAMPLES; i++) sinkI = chain.update(1000 + (i & 63));
+    auto t1 = std::chrono::steady_clock::now();
+    for (int i = 0; i < SAMPLES; i++) sinkF = legacy.update(100.0f + (i & 63) * 0.1f);
+    auto t2 = std::chrono::steady_clock::now();
+
+    double chainNs = std::chrono::duration<double, std::nano>(t1 - t0).count() / SAMPLES;
+    double legacyNs = std::chrono::duration<double, std::nano>(t2 - t1).count() / SAMPLES;
+    char msg[96];
+    snprintf(msg, sizeof(msg), "per sample: median3+avg4 %.1f ns, legacy avg15 %.1f ns", chainNs, legacyNs);
+    TEST_MESSAGE(msg);
+    (void)sinkI;
+    (void)sinkF;
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_median3_rejects_single_spike);
+    RUN_TEST(test_moving_average_is_exact_over_long_runs);
+    RUN_TEST(test_divround_symmetric);
+    RUN_TEST(test_ema_reaches_input);
+    RUN_TEST(test_kalman_converges);
+    RUN_TEST(test_chain_reset_forgets_history);
+    RUN_TEST(test_benchmark_against_legacy_average);
+    RUN_TEST(test_benchmark_cost_per_sample);
+    return UNITY_END();
+}
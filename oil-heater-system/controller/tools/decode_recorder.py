@@ -0,0 +1,149 @@
+#!/usr/bin/env python3
+"""
+Decode oil heater flight recorder logs to CSV.
+
+Input is either a serial capture of the controller's 'd' (dump) command,
+which contains lines of the form
+
+    REC <file name> <hex bytes>
+
+or one or more raw page files copied off the LittleFS image (s_<n>.bin,
+f_<n>.bin). The page format is documented in include/recorder_codec.h.
+
+Usage:
+    decode_recorder.py capture.log > log.csv
+    decode_recorder.py s_3.bin s_4.bin f_0.bin > log.csv
+"""
+
+import re
+import struct
+import sys
+
+PAGE_SIZE = 256
+TAG_KEY = 0x80
+TAG_PAD = 0xFF
+
+BIT_RELAY = 0x01
+BIT_SETPOINT = 0x02
+BIT_FAULT = 0x04
+BIT_SEQ = 0x08
+BIT_GAP = 0x10
+BIT_OWNER = 0x20
+BIT_ZONE = 0x40
+
+TEMP_INVALID = -32768
+TICK_MS = 250           # TEMP_READ_MS in src/main.cpp (per zone)
+
+FAULTS = {0: "", 1: "sensor_open", 2: "overtemp", 3: "comm_timeout",
+          4: "stuck_relay", 5: "open_element", 6: "probe_detached"}
+OWNERS = {0: "display", 1: "wireless"}     # UART display / BLE or ESP-NOW
+
+
+def read_varint(page, pos):
+    value = 0
+    shift = 0
+    while True:
+        byte = page[pos]
+        pos += 1
+        value |= (byte & 0x7F) << shift
+        shift += 7
+        if not byte & 0x80:
+            return value, pos
+
+
+def unzigzag(value):
+    return (value >> 1) ^ -(value & 1)
+
+
+def decode_page(page, tick_ms):
+    """Yield one dict per sample in a page."""
+    if len(page) < 14 or page[0] & 0xC0 != TAG_KEY:
+        return
+    zones = {}          # Last sample of each zone on this page
+    zone_count = 1
+    zone = 0
+    pos = 0
+    while pos < len(page) and page[pos] != TAG_PAD:
+        flags = page[pos]
+        pos += 1
+        if flags & 0xC0 == TAG_KEY:
+            zone = (flags >> 1) & 0x03
+            zone_count = ((flags >> 3) & 0x03) + 1
+            uptime, temp, setpoint, fault, seq = struct.unpack_from("<IhHBI", page, pos)
+            pos += 13
+            s = {"zone": zone, "uptime_ms": uptime, "temp": temp,
+                 "setpoint": setpoint, "fault": fault, "seq": seq}
+        else:
+            if flags & BIT_ZONE:
+                zone = page[pos]
+                pos += 1
+            else:
+                zone = (zone + 1) % zone_count
+            s = dict(zones[zone])
+            delta, pos = read_varint(page, pos)
+            s["temp"] += unzigzag(delta)
+            if flags & BIT_SETPOINT:
+                s["setpoint"] = struct.unpack_from("<H", page, pos)[0]
+                pos += 2
+            if flags & BIT_FAULT:
+                s["fault"] = page[pos]
+                pos += 1
+            if flags & BIT_SEQ:
+                delta, pos = read_varint(page, pos)
+                s["seq"] = (s["seq"] + unzigzag(delta)) & 0xFFFFFFFF
+            ticks = 1
+            if flags & BIT_GAP:
+                gap, pos = read_varint(page, pos)
+                ticks += gap
+            s["uptime_ms"] = (s["uptime_ms"] + ticks * tick_ms) & 0xFFFFFFFF
+        s["relay"] = flags & BIT_RELAY
+        s["owner"] = 1 if flags & BIT_OWNER else 0
+        zones[zone] = s
+        yield s
+
+
+def files_from_dump(lines):
+    """Collect 'REC <name> <hex>' lines into {name: bytes}, in order."""
+    files = {}
+    pattern = re.compile(r"^REC (\S+) ([0-9a-fA-F]+)\s*$")
+    for line in lines:
+        match = pattern.match(line)
+        if match:
+            name = match.group(1).rsplit("/", 1)[-1]
+            files.setdefault(name, bytearray()).extend(bytes.fromhex(match.group(2)))
+    return files
+
+
+def main(argv):
+    if len(argv) < 2:
+        sys.stderr.write(__doc__)
+        return 1
+
+    files = {}
+    for path in argv[1:]:
+        if path.endswith(".bin"):
+            with open(path, "rb") as f:
+                files[path.rsplit("/", 1)[-1]] = f.read()
+        else:
+            with open(path, "r", errors="replace") as f:
+                files.update(files_from_dump(f))
+
+    out = sys.stdout
+    out.write("file,zone,uptime_ms,temp_c,setpoint_c,relay,fault,owner,seq\n")
+    for name, data in files.items():
+        for offset in range(0, len(data) - PAGE_SIZE + 1, PAGE_SIZE):
+            page = data[offset:offset + PAGE_SIZE]
+            try:
+                for s in decode_page(page, TICK_MS):
+                    temp = "" if s["temp"] == TEMP_INVALID else "%.1f" % (s["temp"] / 10.0)
+                    out.write("%s,%d,%d,%s,%.1f,%d,%s,%s,%d\n" % (
+                        name, s["zone"], s["uptime_ms"], temp, s["setpoint"] / 10.0, s["relay"],
+                        FAULTS.get(s["fault"], str(s["fault"])),
+                        OWNERS.get(s["owner"], str(s["owner"])), s["seq"]))
+            except (IndexError, struct.error):
+                sys.stderr.write("%s: truncated page at offset %d\n" % (name, offset))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
@@ -1,74 +1,145 @@
 #ifndef ADAPTIVE_FILTER_H
 #define ADAPTIVE_FILTER_H
 
-#include "config.h"
+#include <stdint.h>
+#include <math.h>
 
 // ================================================================
 // ADAPTIVE FILTER CLASS
 // ================================================================
-
+//
+// Exponential filter that switches to a fast alpha while the weight is
+// changing and back to a slow one once it has settled. Stable means not
+// settling and the last WINDOW filtered values span less than
+// STABILITY_RANGE.
+//
+// Tuning comes from a config type with the same constants as ScaleConfig
+// (FAST_FILTER_ALPHA, SLOW_FILTER_ALPHA, CHANGE_DETECT_THRESHOLD,
+// STABILITY_RANGE, SETTLE_TIME_MS), so other tunings can sit side by side:
+//
+//   AdaptiveFilter<ScaleConfig, ScaleConfig::STABILITY_WINDOW> filter;
+//
+// The window min/max are kept in two monotonic deques, so isStable() is
+// O(1) and update() amortised O(1) whatever the window length. At the
+// default 5 samples a plain scan is cheaper; the deques let the window
+// grow to seconds. Sample times are passed in rather than read here.
+
+template <typename Config, uint8_t WINDOW>
 class AdaptiveFilter {
+    static_assert(WINDOW >= 2, "AdaptiveFilter window needs at least 2 samples");
+
 private:
+    // Ring of (sequence, value) pairs. Values run monotonic from front to
+    // back; entries older than the window fall off the front.
+    struct Deque {
+        uint32_t seq[WINDOW];
+        float value[WINDOW];
+        uint8_t head = 0;
+        uint8_t count = 0;
+
+        uint8_t at(uint8_t i) const { return (uint8_t)((head + i) % WINDOW); }
+        float front() const { return value[head]; }
+
+        // keepBefore(back, v): back entry stays in front of v
+        template <typename Keep>
+        void push(uint32_t n, float v, Keep keepBefore) {
+            while (count > 0 && !keepBefore(value[at(count - 1)], v)) {
+                count--;
+            }
+            uint8_t slot = at(count);
+            seq[slot] = n;
+            value[slot] = v;
+            count++;
+        }
+
+        void expire(uint32_t oldest) {
+            while (count > 0 && (int32_t)(seq[head] - oldest) < 0) {
+                head = at(1);
+                count--;
+            }
+        }
+
+        void clear() {
+            head = 0;
+            count = 0;
+        }
+    };
+
+    struct Greater {
+        bool operator()(float kept, float v) const { return kept > v; }
+    };
+    struct Less {
+        bool operator()(float kept, float v) const { return kept < v; }
+    };
+
+    bool primed = false;            // First sample seen since reset()
     float lastValue = 0;
     float lastRawValue = 0;
-    unsigned long lastChangeTime = 0;
+    uint32_t lastChangeUs = 0;
     bool inTransition = false;
-    float stabilityBuffer[5] = {0};
-    uint8_t stabilityIndex = 0;
+
+    Deque maxWindow;                // Front is the window maximum
+    Deque minWindow;                // Front is the window minimum
+    uint32_t samples = 0;           // Sequence number of the next sample
 
 public:
-    float update(float raw) {
-        float diff = abs(raw - lastRawValue);
+    /**
+     * Filter one reading
+     * @param raw    weight in display units
+     * @param nowUs  sample time (wraps; intervals under 71 min)
+     * @return the filtered weight
+     */
+    float update(float raw, uint32_t nowUs) {
+        if (!primed) {
+            primed = true;
+            lastValue = raw;
+            lastRawValue = raw;
+        }
 
         // Detect significant change
-        if (diff > ScaleConfig::CHANGE_DETECT_THRESHOLD) {
+        if (fabsf(raw - lastRawValue) > Config::CHANGE_DETECT_THRESHOLD) {
             inTransition = true;
-            lastChangeTime = millis();
+            lastChangeUs = nowUs;
         }
 
         // Check if we've settled
-        if (inTransition && (millis() - lastChangeTime > ScaleConfig::SETTLE_TIME_MS)) {
+        if (inTransition && (nowUs - lastChangeUs > Config::SETTLE_TIME_MS * 1000UL)) {
             inTransition = false;
         }
 
         // Apply adaptive filtering
-        float alpha = inTransition ? ScaleConfig::FAST_FILTER_ALPHA : ScaleConfig::SLOW_FILTER_ALPHA;
-
-        // First reading initialization
-        if (lastValue == 0) {
-            lastValue = raw;
-        }
-
+        float alpha = inTransition ? Config::FAST_FILTER_ALPHA : Config::SLOW_FILTER_ALPHA;
         lastValue = (alpha * raw) + ((1.0f - alpha) * lastValue);
         lastRawValue = raw;
 
-        // Update stability buffer
-        stabilityBuffer[stabilityIndex] = lastValue;
-        stabilityIndex = (stabilityIndex + 1) % 5;
+        // Slide the stability window: drop what falls out first, so a
+        // deque never holds more than WINDOW entries
+        if (samples >= WINDOW) {
+            maxWindow.expire(samples + 1 - WINDOW);
+            minWindow.expire(samples + 1 - WINDOW);
+        }
+        maxWindow.push(samples, lastValue, Greater());
+        minWindow.push(samples, lastValue, Less());
+        samples++;
 
         return lastValue;
     }
 
-    bool isStable() {
-        if (inTransition) return false;
-
-        float minVal = stabilityBuffer[0];
-        float maxVal = stabilityBuffer[0];
-
-        for (int i = 1; i < 5; i++) {
-            if (stabilityBuffer[i] < minVal) minVal = stabilityBuffer[i];
-            if (stabilityBuffer[i] > maxVal) maxVal = stabilityBuffer[i];
-        }
-
-        return (maxVal - minVal) < ScaleConfig::STABILITY_RANGE;
+    bool isStable() const {
+        if (inTransition || samples < WINDOW) return false;
+        return (maxWindow.front() - minWindow.front()) < Config::STABILITY_RANGE;
     }
 
+    float value() const { return lastValue; }
+
     void reset() {
+        primed = false;
         lastValue = 0;
         lastRawValue = 0;
         inTransition = false;
-        for (int i = 0; i < 5; i++) stabilityBuffer[i] = 0;
-        stabilityIndex = 0;
+        maxWindow.clear();
+        minWindow.clear();
+        samples = 0;
     }
 };
 
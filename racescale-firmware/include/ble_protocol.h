@@ -78,7 +78,21 @@
  * Fields:
  * - zeroed (bool): Scale has been tared
  * - calibrated (bool): Scale has been calibrated
- * - error (string): Error message (empty if no error)
+ * - error (string): Error message (empty if no error), e.g.
+ *   "tare: scale moving" after a failed tare
+ * - tare (string): idle, settling, averaging, done or failed
+ * - tareProgress (uint): 0-100 while averaging, 100 when done
+ * - streaming (bool): STREAM characteristic active
+ * - streamSent (uint): Stream batches handed to notify()
+ * - streamDropped (uint): Stream batches lost, from three sources:
+ *   - notify() refused them (GATT error)
+ *   - skipped without a notify() while the link was congested
+ *     (ESP_GATTS_CONGEST_EVT); their seq is used up, so the gap shows
+ *   - queued, then discarded by the stack (ESP_GATTS_CONF_EVT with an
+ *     error status)
+ *   Refused and discarded batches are also counted in streamSent.
+ * - samplesLost (uint): HX711 conversions missed or overrun before
+ *   they reached the stream
  *
  * Usage:
  *   #include <ArduinoJson.h>
@@ -97,7 +111,8 @@
  * TARE (26ad)
  * Properties: WRITE
  * Format: UInt8 (1 byte) - ✅ UPDATED from String "1"
- * Command: Write 0x01 to zero the scale
+ * Command: Write 0x01 to zero the scale. Returns at once; follow the
+ *          tare / tareProgress fields of STATUS for the result.
  *
  * Usage (Read from app):
  *   std::string value = pTareChar->getValue();
@@ -140,6 +155,52 @@
  */
 #define CORNER_CHAR_UUID "beb5483e-36e1-4688-b7f5-ea07361b26af"
 
+/**
+ * STREAM (26b0)
+ * Properties: WRITE, NOTIFY
+ * Command: Write 0x01 to start streaming, 0x00 to stop (stops on disconnect)
+ * Rate: Every HX711 conversion (80 Hz), batched to fill the negotiated MTU;
+ *       a partial batch is sent after STREAM_MAX_AGE_MS
+ *
+ * Format (little-endian):
+ *   uint8   seq            Batch sequence (wraps; a gap = lost batch)
+ *   uint8   count          Samples in this batch
+ *   uint32  baseUs         Timestamp of the first sample (µs, wraps)
+ *   count x 8 bytes:
+ *     int24   raw          Net HX711 counts (raw minus tare offset)
+ *     int24   filtered     Filtered weight, 0.01 lb
+ *     uint16  deltaFlags   bit 15: stable
+ *                          bits 0-14: time since previous sample, 10 µs
+ *                          units (0 for the first, saturates at 327 ms)
+ *
+ * MTU 23 carries 1 sample per notification, MTU 247 carries 29.
+ */
+#define STREAM_CHAR_UUID "beb5483e-36e1-4688-b7f5-ea07361b26b0"
+#define STREAM_START 0x01
+#define STREAM_STOP 0x00
+
+/**
+ * SNAPSHOT (26b1)
+ * Properties: READ, WRITE, NOTIFY
+ * Command: Write 0x01 to freeze all four corners (any scale; followers
+ *          forward it to the coordinator)
+ * Notify: Coordinator only, once the corners have reported (or after
+ *         SNAPSHOT_TIMEOUT_MS with the missing ones flagged)
+ *
+ * Format (little-endian, 32 bytes - read it if the MTU is 23):
+ *   uint16  snapshotId
+ *   uint8   present        Bit per corner that reported (bit 0 = LF)
+ *   uint8   stable         Bit per corner that was stable
+ *   int32   corner[4]      LF, RF, LR, RR weight, 0.01 lb
+ *   int32   total          0.01 lb
+ *   uint16  cross          (RF + LR) / total, 0.01 %  (0xFFFF = incomplete)
+ *   uint16  left           (LF + LR) / total, 0.01 %
+ *   uint16  rear           (LR + RR) / total, 0.01 %
+ *   uint16  maxSyncErrUs   Worst clock jitter (0xFFFF = a corner was unsynced)
+ */
+#define SNAPSHOT_CHAR_UUID "beb5483e-36e1-4688-b7f5-ea07361b26b1"
+#define SNAPSHOT_FREEZE 0x01
+
 // ================================================================
 // CORNER IDENTIFIERS
 // ================================================================
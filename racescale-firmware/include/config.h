@@ -33,14 +33,32 @@ struct ScaleConfig {
     // HX711 Settings
     static constexpr uint8_t HX711_SAMPLES = 2;           // Internal averaging
     static constexpr uint8_t SAMPLE_RATE = 80;            // 80 Hz HX711 rate
+    static constexpr uint32_t SAMPLE_PERIOD_US = 1000000UL / SAMPLE_RATE;
+    static constexpr uint8_t HX711_GAIN_PULSES = 1;       // Channel A, gain 128
+
+    // Acquisition task (DOUT interrupt -> task -> ring buffer)
+    static constexpr uint32_t ACQ_TASK_STACK = 2048;
+    static constexpr UBaseType_t ACQ_TASK_PRIORITY = 5;   // Above loop() and BLE
+    static constexpr BaseType_t ACQ_TASK_CORE = 1;
+    static constexpr uint32_t ACQ_STALL_MS = 50;          // No data-ready edge this long = stall
+    static constexpr uint32_t ACQ_READ_TIMEOUT_MS = 500;  // Blocking averages (tare, cal, raw)
 
     // Adaptive Filter Settings - TUNED FOR FAST RESPONSE
     static constexpr float FAST_FILTER_ALPHA = 0.7f;      // During weight changes
     static constexpr float SLOW_FILTER_ALPHA = 0.20f;     // When stable
     static constexpr float CHANGE_DETECT_THRESHOLD = 0.3f; // lbs to trigger fast mode
     static constexpr float STABILITY_RANGE = 0.15f;        // +/- range when stable
+    static constexpr uint8_t STABILITY_WINDOW = 5;         // Filtered samples checked for stability
     static constexpr uint32_t SETTLE_TIME_MS = 1500;       // Time to switch to slow filter
 
+    // Precision tare (non-blocking, from the acquisition stream)
+    static constexpr uint16_t TARE_SAMPLES = 40;          // Conversions averaged (0.5 s)
+    static constexpr uint32_t TARE_SETTLE_MS = 250;       // Let the button press die out first
+    static constexpr float TARE_MOTION_RANGE = 0.15f;     // lbs spread that restarts the average
+    static constexpr uint32_t TARE_TIMEOUT_MS = 5000;     // Give up if still moving
+    static constexpr uint32_t TARE_NO_DATA_MS = 500;      // Give up if the HX711 stops
+    static constexpr uint32_t TARE_DONE_SHOW_MS = 800;    // "TARED" confirmation on the OLED
+
     // Zero Deadband - prevents wandering at zero
     static constexpr float ZERO_DEADBAND = 0.3f;          // Snap to 0 if under this
 
@@ -62,6 +80,18 @@ struct ScaleConfig {
 
     // BLE Update Rate
     static constexpr uint32_t BLE_UPDATE_MS = 250;        // 4Hz BLE updates
+    static constexpr uint32_t STREAM_MAX_AGE_MS = 100;    // Send a partial stream batch after this
+
+    // Four-corner sync (ESP-NOW broadcast between the scales of one car)
+    static constexpr bool SYNC_ENABLED = true;
+    static constexpr uint8_t SYNC_CHANNEL = 1;            // Same on all four scales
+    static constexpr uint32_t SYNC_BEACON_MS = 200;       // Coordinator time beacons
+    static constexpr uint32_t SYNC_TIMEOUT_MS = 2000;     // No beacon this long = unsynced
+    static constexpr uint32_t SYNC_OUTLIER_US = 2000;     // Ignore single offsets this far off
+    static constexpr uint32_t FREEZE_LEAD_MS = 150;       // Freeze time ahead of the request
+    static constexpr uint32_t FREEZE_REPEAT_MS = 30;      // Freeze/report resend spacing
+    static constexpr uint8_t FREEZE_REPEATS = 3;          // Copies of each freeze
+    static constexpr uint32_t SNAPSHOT_TIMEOUT_MS = 600;  // Then publish with corners missing
 
     // Serial Debug Output Rate
     static constexpr uint32_t DEBUG_OUTPUT_MS = 500;      // Debug print interval
@@ -77,6 +107,15 @@ struct ScaleConfig {
 #define DEFAULT_CORNER "LF"  // Fallback if not set via platformio.ini
 #endif
 
+// Snapshot coordinator (time master) and group of the four scales of one car.
+// Override via build flags: -D SYNC_COORDINATOR_CORNER=0 -D SYNC_GROUP=2
+#ifndef SYNC_COORDINATOR_CORNER
+#define SYNC_COORDINATOR_CORNER 0  // CORNER_LF
+#endif
+#ifndef SYNC_GROUP
+#define SYNC_GROUP 1
+#endif
+
 // NVS namespace
 #define NVS_NAMESPACE "racescale_v3"
 #define NVS_CAL_KEY "cal_factor"
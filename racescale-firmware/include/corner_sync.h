@@ -0,0 +1,351 @@
+#ifndef CORNER_SYNC_H
+#define CORNER_SYNC_H
+
+#include <stdint.h>
+#include <string.h>
+
+// ================================================================
+// FOUR-CORNER SYNCHRONISED SNAPSHOT
+// ================================================================
+//
+// One scale (SYNC_COORDINATOR_CORNER) is the time master. Over ESP-NOW
+// broadcast it sends:
+//
+//   BEACON   every SYNC_BEACON_MS. Two-step, as in PTP: beacon n carries
+//            the coordinator's send-complete time of beacon n-1, which a
+//            follower pairs with its own receive time of n-1. A broadcast
+//            reaches all followers at the same instant, so whatever
+//            latency is left is common to them.
+//   FREEZE   "latch your weight at coordinator time T", T a little in
+//            the future, repeated in case a copy is lost.
+//
+// Each scale converts T to its own clock and interpolates its filtered
+// weight at T from the timestamped conversion history, so the four values
+// describe the same instant even though the HX711s are not in phase.
+// Followers answer with a REPORT; the coordinator assembles the snapshot
+// (corners, total, cross, left and rear percentages).
+
+static constexpr uint8_t SYNC_MAGIC = 0x5C;
+static const uint8_t SYNC_BROADCAST[6] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+static constexpr uint8_t SYNC_CORNERS = 4;   // LF, RF, LR, RR (CORNER_* order)
+
+enum SyncFrameType : uint8_t {
+    SYNC_BEACON = 1,
+    SYNC_FREEZE_REQUEST,   // Follower asks the coordinator to freeze
+    SYNC_FREEZE,
+    SYNC_REPORT,
+};
+
+// Every frame starts with this header
+struct __attribute__((packed)) SyncHeader {
+    uint8_t magic;
+    uint8_t type;          // SyncFrameType
+    uint8_t group;         // SYNC_GROUP: scales of one car
+    uint8_t corner;        // Sender's corner
+};
+
+struct __attribute__((packed)) SyncBeaconPacket {
+    SyncHeader hdr;
+    uint8_t seq;
+    uint8_t prevSeq;
+    uint64_t prevTxUs;     // Coordinator time beacon prevSeq went out, 0 = unknown
+};
+
+struct __attribute__((packed)) SyncFreezePacket {
+    SyncHeader hdr;
+    uint16_t snapshotId;
+    uint64_t atUs;         // Coordinator time to latch
+};
+
+struct __attribute__((packed)) SyncReportPacket {
+    SyncHeader hdr;
+    uint16_t snapshotId;
+    int32_t weightCenti;   // 0.01 lb
+    uint8_t flags;         // SYNC_FLAG_*
+    uint16_t syncErrUs;    // Sender's clock jitter estimate
+};
+
+static constexpr uint8_t SYNC_FLAG_STABLE = 0x01;
+static constexpr uint8_t SYNC_FLAG_SYNCED = 0x02;
+
+// Published by the coordinator on the SNAPSHOT characteristic
+struct __attribute__((packed)) CornerSnapshotPacket {
+    uint16_t snapshotId;
+    uint8_t present;           // Bit per corner that reported
+    uint8_t stable;            // Bit per corner that was stable
+    int32_t cornerCenti[SYNC_CORNERS];
+    int32_t totalCenti;
+    uint16_t crossPct;         // (RF + LR) / total, 0.01 % (0xFFFF = n/a)
+    uint16_t leftPct;          // (LF + LR) / total
+    uint16_t rearPct;          // (LR + RR) / total
+    uint16_t maxSyncErrUs;     // Worst corner (0xFFFF = a corner was unsynced)
+};
+
+static constexpr uint16_t SNAPSHOT_PCT_NA = 0xFFFF;
+
+// ----------------------------------------------------------------
+// Follower clock: offset = coordinator time - local time
+// ----------------------------------------------------------------
+
+struct SyncClockStats {
+    uint32_t updates;
+    uint32_t outliers;
+    uint32_t relocks;
+};
+
+class SyncClock {
+private:
+    static constexpr uint8_t RX_SLOTS = 4;
+    static constexpr uint8_t RELOCK_AFTER = 4;   // Consecutive outliers
+
+    uint32_t outlierUs;
+    uint32_t timeoutUs;
+
+    struct RxStamp {
+        bool valid;
+        uint8_t seq;
+        uint64_t rxUs;
+    };
+    RxStamp rx[RX_SLOTS] = {};
+
+    bool coordinator = false;
+    bool locked = false;
+    int64_t offsetUs = 0;
+    uint32_t jitterUs = 0;       // EMA of |residual|
+    uint8_t outlierRun = 0;
+    uint64_t lastUpdateUs = 0;
+    SyncClockStats stats = {0, 0, 0};
+
+public:
+    SyncClock(uint32_t outlierLimitUs, uint32_t staleTimeoutUs)
+        : outlierUs(outlierLimitUs), timeoutUs(staleTimeoutUs) {}
+
+    // The coordinator's clock is the reference
+    void setCoordinator(bool isCoordinator) {
+        coordinator = isCoordinator;
+        locked = isCoordinator;
+        offsetUs = 0;
+        jitterUs = 0;
+    }
+
+    /**
+     * A beacon arrived
+     * @param rxUs  local time of reception (taken in the receive callback)
+     */
+    void onBeacon(const SyncBeaconPacket& b, uint64_t rxUs) {
+        if (coordinator) return;
+
+        rx[b.seq % RX_SLOTS].valid = true;
+        rx[b.seq % RX_SLOTS].seq = b.seq;
+        rx[b.seq % RX_SLOTS].rxUs = rxUs;
+
+        const RxStamp& prev = rx[b.prevSeq % RX_SLOTS];
+        if (b.prevTxUs == 0 || !prev.valid || prev.seq != b.prevSeq) {
+            return;
+        }
+        int64_t measured = (int64_t)(b.prevTxUs - prev.rxUs);
+        stats.updates++;
+
+        if (!locked) {
+            locked = true;
+            offsetUs = measured;
+            jitterUs = 0;
+            outlierRun = 0;
+            lastUpdateUs = rxUs;
+            return;
+        }
+
+        int64_t residual = measured - offsetUs;
+        uint32_t mag = (uint32_t)(residual < 0 ? -residual : residual);
+        if (mag > outlierUs) {
+            // Radio delayed by WiFi/BLE coexistence, or the coordinator
+            // rebooted: only a run of them moves the clock
+            stats.outliers++;
+            if (++outlierRun >= RELOCK_AFTER) {
+                stats.relocks++;
+                offsetUs = measured;
+                jitterUs = 0;
+                outlierRun = 0;
+                lastUpdateUs = rxUs;
+            }
+            return;
+        }
+        outlierRun = 0;
+        offsetUs += residual / 4;
+        jitterUs += ((int32_t)mag - (int32_t)jitterUs) / 8;
+        lastUpdateUs = rxUs;
+    }
+
+    bool synced(uint64_t nowUs) const {
+        return coordinator || (locked && (nowUs - lastUpdateUs) < timeoutUs);
+    }
+
+    uint64_t toLocal(uint64_t coordUs) const { return (uint64_t)((int64_t)coordUs - offsetUs); }
+    uint64_t toCoordinator(uint64_t localUs) const { return (uint64_t)((int64_t)localUs + offsetUs); }
+
+    int64_t offset() const { return offsetUs; }
+    uint32_t jitter() const { return jitterUs; }
+    const SyncClockStats& getStats() const { return stats; }
+};
+
+// ----------------------------------------------------------------
+// Freeze latch: filtered weight interpolated at a given local time
+// ----------------------------------------------------------------
+
+class FreezeLatch {
+public:
+    static constexpr uint8_t HISTORY = 32;   // 400 ms at 80 Hz
+
+    enum State : uint8_t {
+        IDLE,
+        ARMED,
+        LATCHED,
+        MISSED,      // Freeze time older than the history
+    };
+
+private:
+    struct Point {
+        uint32_t us;
+        float weight;
+        bool stable;
+    };
+    Point hist[HISTORY];
+    uint8_t head = 0;      // Next slot to write
+    uint8_t count = 0;
+
+    State state = IDLE;
+    uint32_t atUs = 0;
+    float latchedWeight = 0;
+    bool latchedStable = false;
+
+    const Point& back(uint8_t age) const {   // 0 = newest
+        return hist[(uint8_t)(head + HISTORY - 1 - age) % HISTORY];
+    }
+
+    static bool before(uint32_t a, uint32_t b) { return (int32_t)(a - b) < 0; }
+
+    void tryLatch() {
+        if (state != ARMED || count == 0 || before(back(0).us, atUs)) {
+            return;   // Not yet reached
+        }
+        for (uint8_t age = 0; age + 1 < count; age++) {
+            const Point& hi = back(age);
+            const Point& lo = back(age + 1);
+            if (!before(atUs, lo.us)) {
+                // lo.us <= atUs <= hi.us
+                uint32_t span = hi.us - lo.us;
+                float frac = span ? (float)(atUs - lo.us) / (float)span : 0.0f;
+                latchedWeight = lo.weight + (hi.weight - lo.weight) * frac;
+                latchedStable = lo.stable && hi.stable;
+                state = LATCHED;
+                return;
+            }
+        }
+        state = MISSED;
+    }
+
+public:
+    // Local time (low 32 bits of esp_timer) to latch at; history served
+    // if it is already past
+    void arm(uint32_t localUs) {
+        atUs = localUs;
+        state = ARMED;
+        tryLatch();
+    }
+
+    // One conversion with the filter output after it
+    void feed(uint32_t us, float weight, bool stable) {
+        Point& p = hist[head];
+        p.us = us;
+        p.weight = weight;
+        p.stable = stable;
+        head = (uint8_t)((head + 1) % HISTORY);
+        if (count < HISTORY) count++;
+        tryLatch();
+    }
+
+    State getState() const { return state; }
+    float weight() const { return latchedWeight; }
+    bool stable() const { return latchedStable; }
+
+    // Result consumed
+    void disarm() { state = IDLE; }
+};
+
+// ----------------------------------------------------------------
+// Snapshot assembly (coordinator)
+// ----------------------------------------------------------------
+
+class SnapshotAssembler {
+private:
+    bool active = false;
+    uint16_t id = 0;
+    uint32_t startMs = 0;
+    CornerSnapshotPacket snap;
+
+    static uint16_t pct(int64_t part, int64_t total) {
+        if (total <= 0) return SNAPSHOT_PCT_NA;
+        int64_t p = (part * 10000 + total / 2) / total;
+        if (p < 0 || p > 10000) return SNAPSHOT_PCT_NA;
+        return (uint16_t)p;
+    }
+
+public:
+    void begin(uint16_t snapshotId, uint32_t nowMs) {
+        memset(&snap, 0, sizeof(snap));
+        snap.snapshotId = snapshotId;
+        id = snapshotId;
+        startMs = nowMs;
+        active = true;
+    }
+
+    bool isActive() const { return active; }
+    uint16_t currentId() const { return id; }
+
+    // Returns false for a stale id, unknown corner or duplicate
+    bool report(uint16_t snapshotId, uint8_t corner, int32_t weightCenti,
+                uint8_t flags, uint16_t syncErrUs) {
+        if (!active || snapshotId != id || corner >= SYNC_CORNERS ||
+            (snap.present & (1 << corner))) {
+            return false;
+        }
+        snap.present |= (uint8_t)(1 << corner);
+        if (flags & SYNC_FLAG_STABLE) snap.stable |= (uint8_t)(1 << corner);
+        snap.cornerCenti[corner] = weightCenti;
+        uint16_t err = (flags & SYNC_FLAG_SYNCED) ? syncErrUs : 0xFFFF;
+        if (err > snap.maxSyncErrUs) snap.maxSyncErrUs = err;
+        return true;
+    }
+
+    bool complete() const { return active && snap.present == (1 << SYNC_CORNERS) - 1; }
+    bool expired(uint32_t nowMs, uint32_t timeoutMs) const {
+        return active && (nowMs - startMs) >= timeoutMs;
+    }
+
+    // Close the snapshot and fill in the totals (with what has arrived)
+    const CornerSnapshotPacket& finish() {
+        active = false;
+        int64_t total = 0;
+        for (uint8_t c = 0; c < SYNC_CORNERS; c++) {
+            total += snap.cornerCenti[c];
+        }
+        snap.totalCenti = (int32_t)total;
+        if (snap.present == (1 << SYNC_CORNERS) - 1) {
+            // Corner order LF, RF, LR, RR
+            int64_t lf = snap.cornerCenti[0];
+            int64_t rf = snap.cornerCenti[1];
+            int64_t lr = snap.cornerCenti[2];
+            int64_t rr = snap.cornerCenti[3];
+            snap.crossPct = pct(rf + lr, total);
+            snap.leftPct = pct(lf + lr, total);
+            snap.rearPct = pct(lr + rr, total);
+        } else {
+            snap.crossPct = SNAPSHOT_PCT_NA;
+            snap.leftPct = SNAPSHOT_PCT_NA;
+            snap.rearPct = SNAPSHOT_PCT_NA;
+        }
+        return snap;
+    }
+};
+
+#endif // CORNER_SYNC_H
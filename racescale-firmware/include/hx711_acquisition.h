@@ -0,0 +1,197 @@
+#ifndef HX711_ACQUISITION_H
+#define HX711_ACQUISITION_H
+
+#include "config.h"
+#include "spsc_ring.h"
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+// ================================================================
+// INTERRUPT-DRIVEN HX711 ACQUISITION
+// ================================================================
+//
+// The HX711 pulls DOUT low when a conversion is ready (every 12.5 ms at
+// 80 Hz) and holds it until the 24 bits are clocked out or the next
+// conversion overwrites them. Polling from loop() loses a conversion
+// whenever loop() is busy for longer than that.
+//
+// Here a falling-edge interrupt on DOUT stamps the time and wakes a
+// dedicated high-priority task, which clocks the conversion out with
+// interrupts masked (SCK held high for more than 60 us powers the HX711
+// down) and pushes {raw, timestamp} into a lock-free SPSC ring. loop()
+// drains the ring at its own pace; RING_SIZE covers 3.2 s of stall.
+//
+// Once begin() has run, this task is the only code allowed to clock the
+// HX711. The HX711 library object keeps the offset and scale only; use
+// its read(), get_units() or tare() and both sides see corrupt data.
+
+struct WeightSample {
+    int32_t raw;            // Signed 24-bit counts
+    uint32_t timestampUs;   // DOUT falling edge (esp_timer, low 32 bits)
+};
+
+struct AcquisitionStats {
+    uint32_t samples;       // Conversions read
+    uint32_t overruns;      // Dropped because the ring was full
+    uint32_t missed;        // Conversions lost before they were read
+    uint32_t stalls;        // No data-ready edge for ACQ_STALL_MS
+    uint32_t minIntervalUs;
+    uint32_t avgIntervalUs;
+    uint32_t maxIntervalUs;
+    uint32_t maxLatencyUs;  // Edge to start of read
+    uint16_t ringHighWater;
+};
+
+class HX711Acquisition {
+public:
+    static constexpr uint16_t RING_SIZE = 256;
+
+private:
+    uint8_t doutPin;
+    uint8_t clkPin;
+    uint8_t gainPulses;
+
+    TaskHandle_t task = nullptr;
+    volatile uint32_t edgeUs = 0;
+    SpscRing<WeightSample, RING_SIZE> ring;
+    portMUX_TYPE readMux = portMUX_INITIALIZER_UNLOCKED;
+
+    // Written by the task, read by loop() under statsMux
+    portMUX_TYPE statsMux = portMUX_INITIALIZER_UNLOCKED;
+    AcquisitionStats stats = {0, 0, 0, 0, UINT32_MAX, 0, 0, 0, 0};
+    uint64_t intervalSumUs = 0;
+    uint32_t intervals = 0;
+    uint32_t lastEdgeUs = 0;
+    bool haveLast = false;
+
+    static void ARDUINO_ISR_ATTR onDataReady(void* arg) {
+        HX711Acquisition* self = static_cast<HX711Acquisition*>(arg);
+
+        // Clocking bits out toggles DOUT too. Those edges are serviced once
+        // the read has finished and DOUT is back high, so skip them.
+        if (digitalRead(self->doutPin) != LOW) {
+            return;
+        }
+        self->edgeUs = (uint32_t)esp_timer_get_time();
+
+        BaseType_t woken = pdFALSE;
+        vTaskNotifyGiveFromISR(self->task, &woken);
+        if (woken) {
+            portYIELD_FROM_ISR();
+        }
+    }
+
+    static void taskEntry(void* arg) {
+        static_cast<HX711Acquisition*>(arg)->run();
+    }
+
+    void run() {
+        for (;;) {
+            bool notified = ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(ScaleConfig::ACQ_STALL_MS)) > 0;
+            if (!notified) {
+                portENTER_CRITICAL(&statsMux);
+                stats.stalls++;
+                portEXIT_CRITICAL(&statsMux);
+            }
+            // A conversion that was already waiting gives no edge; read it
+            // on the timeout instead
+            if (digitalRead(doutPin) != LOW) {
+                continue;
+            }
+
+            uint32_t edge = notified ? edgeUs : (uint32_t)esp_timer_get_time();
+            uint32_t startUs = (uint32_t)esp_timer_get_time();
+            int32_t raw = readConversion();
+            record(raw, edge, startUs - edge);
+        }
+    }
+
+    int32_t readConversion() {
+        uint32_t value = 0;
+
+        portENTER_CRITICAL(&readMux);
+        for (uint8_t i = 0; i < 24; i++) {
+            digitalWrite(clkPin, HIGH);
+            delayMicroseconds(1);
+            value = (value << 1) | (digitalRead(doutPin) == HIGH ? 1 : 0);
+            digitalWrite(clkPin, LOW);
+            delayMicroseconds(1);
+        }
+        // Extra pulses select channel and gain for the next conversion
+        for (uint8_t i = 0; i < gainPulses; i++) {
+            digitalWrite(clkPin, HIGH);
+            delayMicroseconds(1);
+            digitalWrite(clkPin, LOW);
+            delayMicroseconds(1);
+        }
+        portEXIT_CRITICAL(&readMux);
+
+        // Sign-extend two's complement 24-bit
+        return (int32_t)(value << 8) >> 8;
+    }
+
+    void record(int32_t raw, uint32_t edge, uint32_t latencyUs) {
+        WeightSample sample = {raw, edge};
+        bool pushed = ring.push(sample);
+        uint16_t depth = (uint16_t)ring.size();
+
+        portENTER_CRITICAL(&statsMux);
+        stats.samples++;
+        if (!pushed) {
+            stats.overruns++;
+        }
+        if (haveLast) {
+            uint32_t interval = edge - lastEdgeUs;
+            if (interval < stats.minIntervalUs) stats.minIntervalUs = interval;
+            if (interval > stats.maxIntervalUs) stats.maxIntervalUs = interval;
+            intervalSumUs += interval;
+            intervals++;
+
+            // More than 1.5 periods apart: the conversions in between
+            // were overwritten before anyone read them
+            const uint32_t period = ScaleConfig::SAMPLE_PERIOD_US;
+            if (interval > period + period / 2) {
+                stats.missed += (interval + period / 2) / period - 1;
+            }
+        }
+        lastEdgeUs = edge;
+        haveLast = true;
+        if (latencyUs > stats.maxLatencyUs) stats.maxLatencyUs = latencyUs;
+        if (depth > stats.ringHighWater) stats.ringHighWater = depth;
+        portEXIT_CRITICAL(&statsMux);
+    }
+
+public:
+    HX711Acquisition(uint8_t dout, uint8_t clk, uint8_t gainPulseCount)
+        : doutPin(dout), clkPin(clk), gainPulses(gainPulseCount) {}
+
+    // Start after HX711::begin() / set_gain() have set up the pins
+    bool begin() {
+        BaseType_t ok = xTaskCreatePinnedToCore(taskEntry, "hx711", ScaleConfig::ACQ_TASK_STACK,
+                                                this, ScaleConfig::ACQ_TASK_PRIORITY, &task,
+                                                ScaleConfig::ACQ_TASK_CORE);
+        if (ok != pdPASS) {
+            return false;
+        }
+        attachInterruptArg(digitalPinToInterrupt(doutPin), onDataReady, this, FALLING);
+        return true;
+    }
+
+    // Consumer side (loop() only)
+    bool pop(WeightSample& sample) { return ring.pop(sample); }
+    uint32_t pending() const { return ring.size(); }
+
+    AcquisitionStats getStats() {
+        portENTER_CRITICAL(&statsMux);
+        AcquisitionStats snap = stats;
+        snap.avgIntervalUs = intervals ? (uint32_t)(intervalSumUs / intervals) : 0;
+        portEXIT_CRITICAL(&statsMux);
+        if (snap.minIntervalUs == UINT32_MAX) {
+            snap.minIntervalUs = 0;
+        }
+        return snap;
+    }
+};
+
+#endif // HX711_ACQUISITION_H
@@ -0,0 +1,56 @@
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <stdint.h>
+#include <atomic>
+
+// ================================================================
+// SINGLE-PRODUCER / SINGLE-CONSUMER RING BUFFER
+// ================================================================
+//
+// Lock-free FIFO between exactly one writer (e.g. the HX711 acquisition
+// task) and one reader (loop()). Each side owns one index and only reads
+// the other's, so neither ever waits or masks interrupts. N must be a power
+// of two; indices run freely and wrap by masking.
+
+template <typename T, uint16_t N>
+class SpscRing {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "SpscRing size must be a power of two");
+
+private:
+    T buffer[N];
+    std::atomic<uint32_t> head{0};  // Next slot to write (producer)
+    std::atomic<uint32_t> tail{0};  // Next slot to read (consumer)
+
+public:
+    // Producer only. Returns false (item dropped) when full.
+    bool push(const T& item) {
+        uint32_t h = head.load(std::memory_order_relaxed);
+        if (h - tail.load(std::memory_order_acquire) >= N) {
+            return false;
+        }
+        buffer[h & (N - 1)] = item;
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer only. Returns false when empty.
+    bool pop(T& item) {
+        uint32_t t = tail.load(std::memory_order_relaxed);
+        if (t == head.load(std::memory_order_acquire)) {
+            return false;
+        }
+        item = buffer[t & (N - 1)];
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Either side; a snapshot that may be stale by the time it is used
+    uint32_t size() const {
+        return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire);
+    }
+
+    static constexpr uint16_t capacity() { return N; }
+};
+
+#endif // SPSC_RING_H
@@ -0,0 +1,160 @@
+#ifndef TARE_MACHINE_H
+#define TARE_MACHINE_H
+
+#include <stdint.h>
+
+// ================================================================
+// NON-BLOCKING PRECISION TARE
+// ================================================================
+//
+// Zeroes the scale from the live acquisition stream instead of blocking
+// in scale.tare(). loop() starts it and feeds it every conversion; the
+// scale keeps filtering, streaming and answering BLE meanwhile.
+//
+//   SETTLING   TARE_SETTLE_MS for the button press or the crew member
+//              stepping away to die out
+//   AVERAGING  TARE_SAMPLES conversions. If they spread wider than the
+//              motion range the average starts over.
+//   DONE       offset() holds the new zero
+//   FAILED     still moving at TARE_TIMEOUT_MS, or no conversions for
+//              TARE_NO_DATA_MS
+//
+// Tuning comes from a config type (ScaleConfig) as for AdaptiveFilter.
+
+template <typename Config>
+class TareMachine {
+public:
+    enum State : uint8_t {
+        IDLE,
+        SETTLING,
+        AVERAGING,
+        DONE,
+        FAILED,
+    };
+
+    enum Failure : uint8_t {
+        NO_FAILURE,
+        MOTION,
+        NO_DATA,
+    };
+
+private:
+    State st = IDLE;
+    Failure why = NO_FAILURE;
+    uint32_t startUs = 0;
+    uint32_t lastSampleUs = 0;
+    int32_t motionCounts = 0;
+
+    int64_t sum = 0;
+    uint16_t count = 0;
+    int32_t minRaw = 0;
+    int32_t maxRaw = 0;
+    uint16_t restartCount = 0;
+    int32_t result = 0;
+
+    void fail(Failure f) {
+        st = FAILED;
+        why = f;
+    }
+
+public:
+    /**
+     * Begin a tare (restarts one in progress)
+     * @param nowUs         current time, same clock as the sample timestamps
+     * @param motionRange   largest raw spread accepted while averaging
+     */
+    void start(uint32_t nowUs, int32_t motionRange) {
+        st = SETTLING;
+        why = NO_FAILURE;
+        startUs = nowUs;
+        lastSampleUs = nowUs;
+        motionCounts = motionRange < 0 ? -motionRange : motionRange;
+        count = 0;
+        sum = 0;
+        restartCount = 0;
+    }
+
+    /**
+     * Feed one conversion
+     * @return true when this sample completed the tare (offset() is new)
+     */
+    bool feed(int32_t raw, uint32_t us) {
+        if (!busy()) return false;
+        lastSampleUs = us;
+
+        if (st == SETTLING) {
+            if ((int32_t)(us - startUs) < (int32_t)(Config::TARE_SETTLE_MS * 1000UL)) {
+                return false;
+            }
+            st = AVERAGING;
+        }
+
+        if (count == 0) {
+            minRaw = raw;
+            maxRaw = raw;
+        } else {
+            if (raw < minRaw) minRaw = raw;
+            if (raw > maxRaw) maxRaw = raw;
+            if (maxRaw - minRaw > motionCounts) {
+                // Moving: start the average over from this sample
+                restartCount++;
+                count = 0;
+                sum = 0;
+                minRaw = raw;
+                maxRaw = raw;
+            }
+        }
+        sum += raw;
+        count++;
+
+        if (count >= Config::TARE_SAMPLES) {
+            result = (int32_t)(sum / count);
+            st = DONE;
+            return true;
+        }
+        if ((us - startUs) >= Config::TARE_TIMEOUT_MS * 1000UL) {
+            fail(MOTION);
+        }
+        return false;
+    }
+
+    // Call from loop(): catches a stalled HX711 when feed() isn't called
+    void poll(uint32_t nowUs) {
+        if (busy() && (int32_t)(nowUs - lastSampleUs) >= (int32_t)(Config::TARE_NO_DATA_MS * 1000UL)) {
+            fail(NO_DATA);
+        }
+    }
+
+    bool busy() const { return st == SETTLING || st == AVERAGING; }
+    State state() const { return st; }
+    Failure failure() const { return why; }
+    int32_t offset() const { return result; }
+    uint16_t restarts() const { return restartCount; }
+
+    // 0-100: settling counts as 0, averaging fills the rest
+    uint8_t progress() const {
+        if (st == DONE) return 100;
+        if (st != AVERAGING) return 0;
+        return (uint8_t)((uint32_t)count * 100 / Config::TARE_SAMPLES);
+    }
+
+    static const char* stateName(State s) {
+        switch (s) {
+            case SETTLING:  return "settling";
+            case AVERAGING: return "averaging";
+            case DONE:      return "done";
+            case FAILED:    return "failed";
+            default:        return "idle";
+        }
+    }
+
+    static const char* failureName(Failure f) {
+        switch (f) {
+            case MOTION:  return "tare: scale moving";
+            case NO_DATA: return "tare: no HX711 data";
+            default:      return "";
+        }
+    }
+};
+
+#endif // TARE_MACHINE_H
@@ -0,0 +1,118 @@
+#ifndef WEIGHT_STREAM_H
+#define WEIGHT_STREAM_H
+
+#include <stdint.h>
+#include <string.h>
+
+// ================================================================
+// WEIGHT STREAM BATCH PACKER
+// ================================================================
+//
+// Packs every HX711 conversion into notifications for the STREAM
+// characteristic (see ble_protocol.h for the wire format). A batch is sent
+// when it fills the negotiated MTU, or from loop() once its first sample
+// is maxAge old, so a small MTU still carries the full 80 Hz and a large
+// one stays responsive. The caller does the notify.
+
+class WeightStreamPacker {
+public:
+    static constexpr uint8_t HEADER_BYTES = 6;    // seq, count, base timestamp
+    static constexpr uint8_t SAMPLE_BYTES = 8;    // raw, filtered, delta/flags
+    static constexpr uint16_t MAX_PAYLOAD = 244;  // ATT MTU 247 less 3 bytes of header
+    static constexpr uint16_t MIN_PAYLOAD = 20;   // Default ATT MTU 23
+
+    static constexpr uint16_t DELTA_UNIT_US = 10;
+    static constexpr uint16_t DELTA_MAX = 0x7FFF;
+    static constexpr uint16_t FLAG_STABLE = 0x8000;
+
+private:
+    uint8_t buf[MAX_PAYLOAD];
+    uint16_t limit = MIN_PAYLOAD;      // Payload size for the current batch
+    uint16_t nextLimit = MIN_PAYLOAD;  // Applied when the next batch starts
+    uint8_t count = 0;
+    uint8_t seq = 0;
+    uint32_t baseUs = 0;
+    uint32_t lastUs = 0;
+
+    static int32_t clampInt24(int32_t v) {
+        if (v > 0x7FFFFF) return 0x7FFFFF;
+        if (v < -0x800000) return -0x800000;
+        return v;
+    }
+
+    static void putInt24(uint8_t* p, int32_t v) {
+        uint32_t u = (uint32_t)clampInt24(v);
+        p[0] = (uint8_t)u;
+        p[1] = (uint8_t)(u >> 8);
+        p[2] = (uint8_t)(u >> 16);
+    }
+
+public:
+    // Payload limit from the negotiated ATT MTU; takes effect next batch
+    void setMtu(uint16_t mtu) {
+        uint16_t payload = mtu > 3 ? mtu - 3 : 0;
+        if (payload < MIN_PAYLOAD) payload = MIN_PAYLOAD;
+        if (payload > MAX_PAYLOAD) payload = MAX_PAYLOAD;
+        nextLimit = payload;
+    }
+
+    // Samples per batch at the current limit
+    uint8_t capacity() const { return (uint8_t)((limit - HEADER_BYTES) / SAMPLE_BYTES); }
+
+    /**
+     * Append one conversion
+     * @param rawCounts       net HX711 counts (raw minus tare offset)
+     * @param filteredCenti   filtered weight, 0.01 lb
+     * @param stable          filter reports stable
+     * @param timestampUs     conversion time (acquisition timestamp)
+     * @return true when the batch is full and should be sent
+     */
+    bool add(int32_t rawCounts, int32_t filteredCenti, bool stable, uint32_t timestampUs) {
+        uint16_t delta = 0;
+        if (count == 0) {
+            limit = nextLimit;
+            baseUs = timestampUs;
+            uint8_t* h = buf;
+            h[0] = seq;
+            h[2] = (uint8_t)timestampUs;
+            h[3] = (uint8_t)(timestampUs >> 8);
+            h[4] = (uint8_t)(timestampUs >> 16);
+            h[5] = (uint8_t)(timestampUs >> 24);
+        } else {
+            uint32_t steps = (timestampUs - lastUs + DELTA_UNIT_US / 2) / DELTA_UNIT_US;
+            delta = steps > DELTA_MAX ? DELTA_MAX : (uint16_t)steps;
+        }
+        lastUs = timestampUs;
+
+        uint8_t* p = buf + HEADER_BYTES + count * SAMPLE_BYTES;
+        putInt24(p, rawCounts);
+        putInt24(p + 3, filteredCenti);
+        uint16_t word = delta | (stable ? FLAG_STABLE : 0);
+        p[6] = (uint8_t)word;
+        p[7] = (uint8_t)(word >> 8);
+
+        count++;
+        buf[1] = count;
+        return count >= capacity();
+    }
+
+    // A partial batch has waited long enough
+    bool due(uint32_t nowUs, uint32_t maxAgeUs) const {
+        return count > 0 && (nowUs - baseUs) >= maxAgeUs;
+    }
+
+    bool empty() const { return count == 0; }
+    const uint8_t* data() const { return buf; }
+    uint16_t length() const { return HEADER_BYTES + count * SAMPLE_BYTES; }
+
+    // Batch handed to the stack (or dropped); start the next one
+    void finish() {
+        count = 0;
+        seq++;
+    }
+
+    // Drop any partial batch, e.g. on disconnect
+    void clear() { count = 0; }
+};
+
+#endif // WEIGHT_STREAM_H
@@ -3,7 +3,9 @@
 //   CrewChiefSteve Standard - Configurable Corner Identity
 //   Features: Adaptive filtering, NVS storage, fast response,
 //   temperature compensation, button handling, async operations,
-//   Serial calibration, zero deadband, corner configuration
+//   Serial calibration, zero deadband, corner configuration,
+//   interrupt-driven 80 Hz HX711 acquisition, synchronised
+//   four-corner snapshots over ESP-NOW
 //   Target: ESP32-S3 with custom pinout (GPIO 42/41 HX711, I2C 8/9)
 // ================================================================
 
@@ -18,23 +20,33 @@
 #include <Adafruit_GFX.h>
 #include <Adafruit_SSD1306.h>
 #include <Preferences.h>
+#include <WiFi.h>
+#include <esp_now.h>
+#include <esp_wifi.h>
+#include <freertos/queue.h>
 
 #include <ArduinoJson.h>  // For STATUS JSON encoding
 #include "config.h"
 #include "ble_protocol.h"
 #include "adaptive_filter.h"
 #include "button_handler.h"
+#include "hx711_acquisition.h"
+#include "weight_stream.h"
+#include "corner_sync.h"
+#include "tare_machine.h"
 
 // ================================================================
 // GLOBAL OBJECTS
 // ================================================================
 
 Adafruit_SSD1306 display(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, OLED_RESET);
-HX711 scale;
+HX711 scale;  // Offset and scale only; acquisition owns the bus
+HX711Acquisition acquisition(DOUT, CLK, ScaleConfig::HX711_GAIN_PULSES);
 OneWire oneWire(ONE_WIRE_BUS);
 DallasTemperature tempSensor(&oneWire);
 Preferences preferences;
-AdaptiveFilter filter;
+AdaptiveFilter<ScaleConfig, ScaleConfig::STABILITY_WINDOW> filter;
+TareMachine<ScaleConfig> tare;
 ButtonHandler tareButton(ZERO_BUTTON);
 
 BLEServer* pServer = nullptr;
@@ -45,6 +57,8 @@ BLECharacteristic* pTempChar = nullptr;
 BLECharacteristic* pStatusChar = nullptr;
 BLECharacteristic* pCornerChar = nullptr;
 BLECharacteristic* pBatteryChar = nullptr;  // ADDED: Battery percentage characteristic
+BLECharacteristic* pStreamChar = nullptr;
+BLECharacteristic* pSnapshotChar = nullptr;
 
 // ================================================================
 // STATE VARIABLES
@@ -64,6 +78,59 @@ String cornerID = DEFAULT_CORNER;  // String name for display/NVS (e.g., "LF")
 uint8_t cornerIDInt = CORNER_LF;   // UInt8 for BLE (0-3)
 String deviceName = "RaceScale_" + String(DEFAULT_CORNER);
 
+// BLE writes land in the BLE task; loop() carries them out so only it
+// consumes the sample ring
+volatile bool bleTareRequested = false;
+volatile float bleCalWeight = 0;
+volatile bool bleStreamRequested = false;
+volatile bool bleFreezeRequested = false;
+
+// High-rate stream (STREAM characteristic)
+WeightStreamPacker streamPacker;
+bool streaming = false;
+uint32_t streamBatches = 0;
+uint32_t streamDropped = 0;              // Refused by notify() or skipped while congested
+volatile uint32_t streamDiscarded = 0;   // Accepted, then discarded by the stack (GATTS task)
+volatile bool streamCongested = false;   // Link transmit buffers full (GATTS task)
+
+// Four-corner sync (ESP-NOW). Frames are timestamped in the receive
+// callback (WiFi task) and handled by loop().
+struct SyncRxFrame {
+    uint64_t rxUs;
+    uint8_t len;
+    uint8_t data[32];
+};
+QueueHandle_t syncRxQueue = nullptr;
+bool syncReady = false;
+bool syncCoordinator = false;
+SyncClock syncClock(ScaleConfig::SYNC_OUTLIER_US, ScaleConfig::SYNC_TIMEOUT_MS * 1000UL);
+FreezeLatch freezeLatch;
+SnapshotAssembler snapshot;
+
+// Beacon send-complete time, for the two-step beacon (WiFi task -> loop)
+portMUX_TYPE syncMux = portMUX_INITIALIZER_UNLOCKED;
+uint8_t syncSendsInFlight = 0;
+bool beaconStampPending = false;
+uint8_t beaconStampSeq = 0;
+uint64_t beaconTxUs = 0;        // 0 = not known
+uint8_t beaconTxSeq = 0;
+
+uint8_t beaconSeq = 0;
+unsigned long lastBeaconMs = 0;
+uint16_t freezeId = 0;           // Coordinator: last freeze started
+uint64_t freezeAtUs = 0;         // Coordinator time of the freeze being handled
+uint8_t freezeRepeatsLeft = 0;
+unsigned long lastFreezeSendMs = 0;
+uint16_t latchId = 0;            // Freeze the latch is armed for
+bool latchSynced = false;
+SyncReportPacket pendingReport;
+uint8_t reportResendsLeft = 0;
+unsigned long lastReportMs = 0;
+bool cornerConflictWarned = false;
+
+// Tare progress (loop only)
+unsigned long tareFinishedMs = 0;
+
 // Async temperature reading
 bool tempRequested = false;
 unsigned long tempRequestTime = 0;
@@ -78,7 +145,20 @@ unsigned long lastBLEUpdate = 0;
 // ================================================================
 
 void updateCalibration();
-void performPrecisionTare();
+bool processWeightSamples();
+bool serviceScale();
+bool readRawAverage(uint8_t count, long& average);
+void applyCalibration(float knownWeight);
+void printAcquisitionStats();
+void streamSample(const WeightSample& sample);
+void sendStreamBatch();
+String buildStatusJson(bool zeroed);
+void initSync();
+void processSync();
+void requestFreeze();
+void printSyncStats();
+void startPrecisionTare();
+void handleTare();
 void performCalibration();
 void initializeBLE();
 void loadSettings();
@@ -87,6 +167,7 @@ void updateDisplay();
 void updateBLE();
 void handleAsyncTemp();
 void handleSerialCommands();
+void handleBLERequests();
 void setCornerID(const String& newCorner);
 
 // ================================================================
@@ -100,12 +181,7 @@ class MyServerCB : public BLEServerCallbacks {
 
         // ✅ UPDATED: Send current status as JSON on connect
         if (pStatusChar) {
-            StaticJsonDocument<128> doc;
-            doc["zeroed"] = true;  // Assume tared if running
-            doc["calibrated"] = (BASE_CALIBRATION > 0);
-            doc["error"] = "";
-            String json;
-            serializeJson(doc, json);
+            String json = buildStatusJson(true);  // Assume tared if running
             pStatusChar->setValue(json.c_str());
             pStatusChar->notify();
         }
@@ -113,6 +189,7 @@ class MyServerCB : public BLEServerCallbacks {
 
     void onDisconnect(BLEServer* p) {
         deviceConnected = false;
+        bleStreamRequested = false;
         Serial.println("BLE Disconnected");
         // Auto-restart advertising
         BLEDevice::getAdvertising()->start();
@@ -125,7 +202,7 @@ class TareCB : public BLECharacteristicCallbacks {
         std::string value = c->getValue();
         if (value.length() > 0 && value[0] == TARE_COMMAND) {
             Serial.println("BLE Request: TARE (UInt8 0x01)");
-            performPrecisionTare();
+            bleTareRequested = true;
         }
     }
 };
@@ -139,17 +216,8 @@ class CalibrationCB : public BLECharacteristicCallbacks {
             memcpy(&knownWeight, value.data(), 4);
 
             if (knownWeight > 0) {
-                float currentReading = scale.get_units(10);
-                float ratio = currentReading / knownWeight;
-                BASE_CALIBRATION = BASE_CALIBRATION * ratio;
-
-                updateCalibration();
-                scale.set_scale(compensatedCalibration);
-                saveSettings();
-                filter.reset();
-
-                Serial.printf("✓ BLE Calibrated: Target=%.1f, Factor=%.1f (saved)\n",
-                    knownWeight, BASE_CALIBRATION);
+                Serial.printf("BLE Request: CALIBRATE to %.1f\n", knownWeight);
+                bleCalWeight = knownWeight;
             }
         } else {
             Serial.printf("❌ BLE Calibration error: Expected 4 bytes, got %d\n", value.length());
@@ -157,6 +225,54 @@ class CalibrationCB : public BLECharacteristicCallbacks {
     }
 };
 
+class StreamCB : public BLECharacteristicCallbacks {
+    void onWrite(BLECharacteristic* c) {
+        std::string value = c->getValue();
+        if (value.length() > 0) {
+            bleStreamRequested = (value[0] == STREAM_START);
+        }
+    }
+
+    // Called from notify(); a GATT error means the stack dropped the batch
+    void onStatus(BLECharacteristic* c, Status s, uint32_t code) {
+        if (s == ERROR_GATT) {
+            streamDropped++;
+        }
+    }
+};
+
+// Bluedroid reports congestion, and a notify it queued but then had to
+// discard, only as GATTS events; notify() itself returns success for both
+static void gattsEventHook(esp_gatts_cb_event_t event, esp_gatt_if_t gattsIf,
+                           esp_ble_gatts_cb_param_t* param) {
+    switch (event) {
+        case ESP_GATTS_CONGEST_EVT:
+            streamCongested = param->congest.congested;
+            break;
+        case ESP_GATTS_CONF_EVT:
+            if (pStreamChar && param->conf.handle == pStreamChar->getHandle() &&
+                param->conf.status != ESP_GATT_OK) {
+                streamDiscarded++;
+            }
+            break;
+        case ESP_GATTS_DISCONNECT_EVT:
+            streamCongested = false;
+            break;
+        default:
+            break;
+    }
+}
+
+class SnapshotCB : public BLECharacteristicCallbacks {
+    void onWrite(BLECharacteristic* c) {
+        std::string value = c->getValue();
+        if (value.length() > 0 && value[0] == SNAPSHOT_FREEZE) {
+            Serial.println("BLE Request: FREEZE");
+            bleFreezeRequested = true;
+        }
+    }
+};
+
 class CornerCB : public BLECharacteristicCallbacks {
     void onWrite(BLECharacteristic* c) {
         // ✅ UPDATED: Changed from String "LF"/"RF"/etc to UInt8 (0-3)
@@ -193,19 +309,14 @@ void handleSerialCommands() {
         if (input.startsWith("cal ")) {
             float knownWeight = input.substring(4).toFloat();
             if (knownWeight > 0) {
-                float currentReading = scale.get_units(10);
-                float ratio = currentReading / knownWeight;
-                BASE_CALIBRATION = BASE_CALIBRATION * ratio;
-                updateCalibration();
-                scale.set_scale(compensatedCalibration);
-                saveSettings();
-                filter.reset();
-                Serial.printf("✓ Calibrated! New factor=%.1f (saved to NVS)\n", BASE_CALIBRATION);
+                applyCalibration(knownWeight);
             } else {
                 Serial.println("✗ Invalid weight. Usage: cal 25");
             }
         } else if (input == "tare") {
-            performPrecisionTare();
+            startPrecisionTare();
+        } else if (input == "freeze") {
+            requestFreeze();
         } else if (input.startsWith("corner ")) {
             String newCorner = input.substring(7);
             newCorner.trim();
@@ -227,10 +338,17 @@ void handleSerialCommands() {
             Serial.printf("Weight: %.2f lbs\n", displayWeight);
             Serial.printf("Stable: %s\n", isStable ? "YES" : "NO");
             Serial.printf("BLE: %s\n", deviceConnected ? "Connected" : "Waiting");
+            printAcquisitionStats();
+            printSyncStats();
             Serial.println("==================\n");
         } else if (input == "raw") {
-            float raw = scale.get_units(10);
-            Serial.printf("Raw reading (10 samples): %.3f lbs\n", raw);
+            long raw;
+            if (readRawAverage(10, raw)) {
+                Serial.printf("Raw reading (10 samples): %ld counts = %.3f lbs\n",
+                    raw, (raw - scale.get_offset()) / scale.get_scale());
+            } else {
+                Serial.println("✗ No HX711 data");
+            }
         } else if (input == "reset") {
             preferences.begin(NVS_NAMESPACE, false);
             preferences.clear();
@@ -240,8 +358,9 @@ void handleSerialCommands() {
             Serial.println("\n=== SERIAL COMMANDS ===");
             Serial.println("cal <weight>  - Calibrate (e.g., 'cal 25')");
             Serial.println("tare          - Zero the scale");
+            Serial.println("freeze        - Synchronised four-corner snapshot");
             Serial.println("corner <ID>   - Set corner (e.g., 'corner LF' or 'corner 01')");
-            Serial.println("info          - Show current settings");
+            Serial.println("info          - Show settings and acquisition stats");
             Serial.println("raw           - Show raw reading");
             Serial.println("reset         - Clear NVS, restore defaults");
             Serial.println("help          - Show this help");
@@ -252,6 +371,37 @@ void handleSerialCommands() {
     }
 }
 
+// ================================================================
+// BLE REQUESTS (tare/calibration written from the BLE task)
+// ================================================================
+
+void handleBLERequests() {
+    if (bleTareRequested) {
+        bleTareRequested = false;
+        startPrecisionTare();
+    }
+    if (bleCalWeight > 0) {
+        float knownWeight = bleCalWeight;
+        bleCalWeight = 0;
+        applyCalibration(knownWeight);
+    }
+
+    if (bleFreezeRequested) {
+        bleFreezeRequested = false;
+        requestFreeze();
+    }
+
+    bool wantStream = bleStreamRequested && deviceConnected;
+    if (wantStream != streaming) {
+        streaming = wantStream;
+        streamPacker.clear();
+        if (streaming) {
+            streamPacker.setMtu(pServer->getPeerMTU(pServer->getConnId()));
+        }
+        Serial.printf("📶 Stream %s\n", streaming ? "started" : "stopped");
+    }
+}
+
 // ================================================================
 // CORNER ID MANAGEMENT
 // ================================================================
@@ -348,14 +498,25 @@ void setup() {
     updateCalibration();
     scale.set_scale(compensatedCalibration);
 
+    // From here on the acquisition task is the only reader of the HX711
+    if (acquisition.begin()) {
+        Serial.printf("  - Acquisition: %d Hz, DOUT interrupt -> task (core %d)\n",
+            ScaleConfig::SAMPLE_RATE, (int)ScaleConfig::ACQ_TASK_CORE);
+    } else {
+        Serial.println("❌ HX711 acquisition task failed to start");
+    }
+
     // Skip auto-tare on startup (scale can be loaded during boot)
     Serial.println("⚠ Auto-tare DISABLED - use button or BLE to tare manually");
-    // performPrecisionTare();  // Commented out - no auto-tare required
+    // startPrecisionTare();  // Commented out - no auto-tare required
 
     // Start BLE stack
     Serial.printf("✓ Starting BLE (%s)...\n", deviceName.c_str());
     initializeBLE();
 
+    // Four-corner sync over ESP-NOW (shares the radio with BLE)
+    initSync();
+
     Serial.println("\n🎉 RACE SCALE V4.0 READY!");
     Serial.println("──────────────────────────────");
     Serial.println("HARDWARE:");
@@ -383,11 +544,14 @@ void loop() {
     // === SERIAL COMMAND HANDLER ===
     handleSerialCommands();
 
+    // === BLE REQUESTS (deferred from the BLE task) ===
+    handleBLERequests();
+
     // === BUTTON HANDLING ===
     ButtonHandler::ButtonEvent btnEvent = tareButton.update();
     if (btnEvent == ButtonHandler::SHORT_PRESS) {
         Serial.println("🔘 Button: PRECISION TARE");
-        performPrecisionTare();
+        startPrecisionTare();
     } else if (btnEvent == ButtonHandler::LONG_PRESS) {
         Serial.println("🔘 Button: CALIBRATION MODE");
         performCalibration();
@@ -396,11 +560,78 @@ void loop() {
     // === ASYNC TEMP SENSOR ===
     handleAsyncTemp();
 
-    // === WEIGHT ACQUISITION (80Hz capable) ===
-    if (scale.is_ready()) {
-        float raw = scale.get_units(ScaleConfig::HX711_SAMPLES);
-        currentWeight = filter.update(raw);
+    // === SYNC, WEIGHT ACQUISITION (80Hz), TARE, 4Hz BLE ===
+    serviceScale();
+
+    // === 40Hz OLED UPDATE ===
+    if (currentMillis - lastDisplayUpdate >= ScaleConfig::UPDATE_RATE_MS) {
+        updateDisplay();
+        lastDisplayUpdate = currentMillis;
+    }
+}
+
+// Everything that has to keep running whatever the UI is doing, also from
+// the calibration screen: sync beacons, freezes and reports for the other
+// corners, the acquisition ring, tare and the BLE notifications.
+// Returns true if the filter was updated.
+bool serviceScale() {
+    // Four-corner sync (beacons, freeze, snapshot)
+    processSync();
+
+    // Weight acquisition (drained from the ring)
+    bool updated = processWeightSamples();
+    handleTare();
+
+    // 4Hz BLE update (when connected)
+    unsigned long now = millis();
+    if (deviceConnected && (now - lastBLEUpdate >= ScaleConfig::BLE_UPDATE_MS)) {
+        updateBLE();
+        lastBLEUpdate = now;
+    }
+    return updated;
+}
+
+// ================================================================
+// WEIGHT SAMPLES (ring buffer -> filter)
+// ================================================================
+
+// Convert raw counts with the current tare offset and calibration
+static float countsToUnits(long raw) {
+    return (raw - scale.get_offset()) / scale.get_scale();
+}
+
+// Drain every queued conversion. Conversions are averaged in blocks of
+// HX711_SAMPLES, as get_units(HX711_SAMPLES) did, so the filter sees the
+// same rate it was tuned for. Returns true if the filter was updated.
+bool processWeightSamples() {
+    static long blockSum = 0;
+    static uint8_t blockCount = 0;
+    bool updated = false;
+
+    WeightSample sample;
+    while (acquisition.pop(sample)) {
+        // A tare that completes moves the zero: start a fresh block
+        if (tare.feed(sample.raw, sample.timestampUs)) {
+            scale.set_offset(tare.offset());
+            filter.reset();
+            blockSum = 0;
+            blockCount = 0;
+            continue;
+        }
+
+        blockSum += sample.raw;
+        if (++blockCount < ScaleConfig::HX711_SAMPLES) {
+            freezeLatch.feed(sample.timestampUs, currentWeight, isStable);
+            streamSample(sample);
+            continue;
+        }
+        float raw = countsToUnits(blockSum / blockCount);
+        blockSum = 0;
+        blockCount = 0;
+
+        currentWeight = filter.update(raw, sample.timestampUs);
         isStable = filter.isStable();
+        updated = true;
 
         // ZERO DEADBAND - snap to zero when under threshold
         if (abs(currentWeight) < ScaleConfig::ZERO_DEADBAND) {
@@ -413,28 +644,94 @@ void loop() {
 
         // Debug print (500ms rate)
         static unsigned long debugTimer = 0;
-        if (currentMillis - debugTimer > ScaleConfig::DEBUG_OUTPUT_MS) {
+        unsigned long now = millis();
+        if (now - debugTimer > ScaleConfig::DEBUG_OUTPUT_MS) {
             Serial.printf("Raw: %6.3f | Filt: %5.2f | Disp: %5.2f lbs | %s | T:%.1fF | Cal:%.0f\n",
                 raw, currentWeight, displayWeight,
                 isStable ? "✅ STABLE" : "⏳ MEASURING",
                 temperature, compensatedCalibration);
-            debugTimer = currentMillis;
+            debugTimer = now;
         }
+        freezeLatch.feed(sample.timestampUs, currentWeight, isStable);
+        streamSample(sample);
     }
 
-    // === 40Hz OLED UPDATE ===
-    if (currentMillis - lastDisplayUpdate >= ScaleConfig::UPDATE_RATE_MS) {
-        updateDisplay();
-        lastDisplayUpdate = currentMillis;
+    // Don't hold a partial batch longer than STREAM_MAX_AGE_MS
+    if (streaming && streamPacker.due((uint32_t)esp_timer_get_time(),
+                                      ScaleConfig::STREAM_MAX_AGE_MS * 1000UL)) {
+        sendStreamBatch();
     }
+    return updated;
+}
 
-    // === 4Hz BLE UPDATE (when connected) ===
-    if (deviceConnected && (currentMillis - lastBLEUpdate >= ScaleConfig::BLE_UPDATE_MS)) {
-        updateBLE();
-        lastBLEUpdate = currentMillis;
+// ================================================================
+// HIGH-RATE STREAM (every conversion, MTU-sized batches)
+// ================================================================
+
+void streamSample(const WeightSample& sample) {
+    if (!streaming) return;
+    int32_t net = sample.raw - scale.get_offset();
+    int32_t centi = (int32_t)lroundf(currentWeight * 100.0f);
+    if (streamPacker.add(net, centi, isStable, sample.timestampUs)) {
+        sendStreamBatch();
     }
 }
 
+void sendStreamBatch() {
+    if (!pStreamChar || streamPacker.empty()) return;
+    if (streamCongested) {
+        // Queued behind the backlog it would arrive late or be discarded:
+        // drop it here. The sequence number still advances, so the app
+        // sees the gap.
+        streamDropped++;
+    } else {
+        pStreamChar->setValue((uint8_t*)streamPacker.data(), streamPacker.length());
+        pStreamChar->notify();
+        streamBatches++;
+    }
+    streamPacker.finish();
+
+    // Follow MTU renegotiation from the next batch on
+    streamPacker.setMtu(pServer->getPeerMTU(pServer->getConnId()));
+}
+
+// Average the next `count` conversions (blocking, loop() only). Queued
+// samples predate the request and are discarded first.
+bool readRawAverage(uint8_t count, long& average) {
+    WeightSample sample;
+    while (acquisition.pop(sample)) {
+    }
+
+    long sum = 0;
+    uint8_t got = 0;
+    unsigned long start = millis();
+    while (got < count) {
+        if (acquisition.pop(sample)) {
+            sum += sample.raw;
+            got++;
+        } else if (millis() - start > ScaleConfig::ACQ_READ_TIMEOUT_MS + count * 1000UL / ScaleConfig::SAMPLE_RATE) {
+            return false;
+        } else {
+            delay(1);
+        }
+    }
+    average = sum / count;
+    return true;
+}
+
+void printAcquisitionStats() {
+    AcquisitionStats s = acquisition.getStats();
+    Serial.printf("HX711: %lu samples, %lu missed, %lu overruns, %lu stalls\n",
+        (unsigned long)s.samples, (unsigned long)s.missed,
+        (unsigned long)s.overruns, (unsigned long)s.stalls);
+    Serial.printf("Interval: min %lu / avg %lu / max %lu us (nominal %lu)\n",
+        (unsigned long)s.minIntervalUs, (unsigned long)s.avgIntervalUs,
+        (unsigned long)s.maxIntervalUs, (unsigned long)ScaleConfig::SAMPLE_PERIOD_US);
+    Serial.printf("Read latency max: %lu us | Ring: %u/%u queued, peak %u\n",
+        (unsigned long)s.maxLatencyUs, (unsigned)acquisition.pending(),
+        (unsigned)HX711Acquisition::RING_SIZE, (unsigned)s.ringHighWater);
+}
+
 // ================================================================
 // ASYNC TEMPERATURE (Non-blocking DS18B20)
 // ================================================================
@@ -488,49 +785,75 @@ void updateCalibration() {
 }
 
 // ================================================================
-// PRECISION TARE (10 samples, visual feedback)
+// PRECISION TARE (non-blocking, motion-rejecting)
 // ================================================================
 
-void performPrecisionTare() {
-    Serial.println("\n=== 🔄 PRECISION TARE (10x avg) ===");
+// Start (or restart) a tare; processWeightSamples() feeds it and loop()
+// keeps running. Progress goes out in the STATUS JSON.
+void startPrecisionTare() {
+    Serial.printf("\n=== 🔄 PRECISION TARE (%ux avg) ===\n", ScaleConfig::TARE_SAMPLES);
+    Serial.println("Stay still...");
 
-    // OLED feedback
-    if (displayAvailable) {
-        display.clearDisplay();
+    // Motion limit in raw counts at the current calibration
+    int32_t motionCounts = (int32_t)(ScaleConfig::TARE_MOTION_RANGE * scale.get_scale());
+    tare.start((uint32_t)esp_timer_get_time(), motionCounts);
+}
+
+// Report tare completion or failure once (loop only)
+void handleTare() {
+    tare.poll((uint32_t)esp_timer_get_time());
+
+    static TareMachine<ScaleConfig>::State lastState = TareMachine<ScaleConfig>::IDLE;
+    TareMachine<ScaleConfig>::State state = tare.state();
+    if (state == lastState) {
+        return;
+    }
+    lastState = state;
+
+    if (state == TareMachine<ScaleConfig>::DONE) {
+        tareFinishedMs = millis();
+        Serial.printf("Tare complete! Zero=%ld counts (%u motion restarts) ✓\n\n",
+            (long)tare.offset(), tare.restarts());
+    } else if (state == TareMachine<ScaleConfig>::FAILED) {
+        tareFinishedMs = millis();
+        Serial.printf("❌ Tare failed: %s (%u motion restarts) - zero unchanged\n\n",
+            TareMachine<ScaleConfig>::failureName(tare.failure()), tare.restarts());
+    }
+}
+
+// Tare screen while zeroing and briefly after; false = show the weight
+static bool drawTareScreen() {
+    TareMachine<ScaleConfig>::State state = tare.state();
+    bool recent = (millis() - tareFinishedMs) < ScaleConfig::TARE_DONE_SHOW_MS;
+
+    if (tare.busy()) {
         display.setTextSize(2);
         display.setCursor(10, 20);
         display.println("TARING...");
-        display.setCursor(20, 45);
         display.setTextSize(1);
+        display.setCursor(20, 45);
         display.println("Stay still...");
-        display.display();
-    }
-
-    float before = scale.get_units(5);
-    Serial.printf("Before tare: %.3f lbs\n", before);
-
-    scale.tare(10);  // 10-sample average
-
-    float after = scale.get_units(5);
-    Serial.printf("After tare:  %.3f lbs ✓\n", after);
-
-    // Reset filter state
-    filter.reset();
-
-    Serial.println("Tare complete!\n");
-
-    // Brief confirmation
-    if (displayAvailable) {
-        display.clearDisplay();
+        display.drawRect(0, 56, 128, 8, SSD1306_WHITE);
+        display.fillRect(0, 56, 128 * tare.progress() / 100, 8, SSD1306_WHITE);
+    } else if (state == TareMachine<ScaleConfig>::DONE && recent) {
         display.setTextSize(2);
         display.setCursor(30, 20);
         display.println("TARED");
         display.setTextSize(1);
         display.setCursor(40, 45);
         display.println("0.00 lbs");
-        display.display();
-        delay(800);
+    } else if (state == TareMachine<ScaleConfig>::FAILED && recent) {
+        display.setTextSize(2);
+        display.setCursor(4, 20);
+        display.println("TARE FAIL");
+        display.setTextSize(1);
+        display.setCursor(0, 45);
+        display.println(tare.failure() == TareMachine<ScaleConfig>::MOTION ? "Scale moving" : "No HX711 data");
+    } else {
+        return false;
     }
+    display.display();
+    return true;
 }
 
 // ================================================================
@@ -559,26 +882,46 @@ void performCalibration() {
         display.display();
     }
 
-    // Show live weight during cal
+    // Show live weight during cal. Sync, tare and BLE keep running, so
+    // another corner can still take a snapshot meanwhile.
     unsigned long calStart = millis();
+    unsigned long lastLive = 0;
     while (millis() - calStart < 10000) {  // 10s timeout
-        if (scale.is_ready()) {
-            float raw = scale.get_units(3);
-            if (displayAvailable) {
-                display.fillRect(0, 55, 128, 9, SSD1306_BLACK);
-                display.setCursor(0, 55);
-                display.printf("Live: %.2f lbs", raw);
-                display.display();
-            }
+        bool updated = serviceScale();
+        if (updated && displayAvailable && millis() - lastLive >= ScaleConfig::UPDATE_RATE_MS) {
+            display.fillRect(0, 55, 128, 9, SSD1306_BLACK);
+            display.setCursor(0, 55);
+            display.printf("Live: %.2f lbs", currentWeight);
+            display.display();
+            lastLive = millis();
         }
 
-        // Check for serial calibration during this time
+        // Check for serial or BLE calibration during this time
         handleSerialCommands();
+        handleBLERequests();
 
-        delay(100);
+        delay(1);
     }
 }
 
+// Scale the calibration so the current load reads knownWeight
+void applyCalibration(float knownWeight) {
+    long raw;
+    if (!readRawAverage(10, raw)) {
+        Serial.println("❌ Calibration failed: no HX711 data");
+        return;
+    }
+    float currentReading = countsToUnits(raw);
+    float ratio = currentReading / knownWeight;
+    BASE_CALIBRATION = BASE_CALIBRATION * ratio;
+    updateCalibration();
+    scale.set_scale(compensatedCalibration);
+    saveSettings();
+    filter.reset();
+    Serial.printf("✓ Calibrated to %.1f lbs! New factor=%.1f (saved to NVS)\n",
+        knownWeight, BASE_CALIBRATION);
+}
+
 // ================================================================
 // OLED DISPLAY (40Hz, Adaptive Precision)
 // ================================================================
@@ -587,6 +930,7 @@ void updateDisplay() {
     if (!displayAvailable) return;  // Skip if no display
 
     display.clearDisplay();
+    if (drawTareScreen()) return;
 
     // Intelligent rounding by weight range
     float weightToShow = displayWeight;
@@ -665,30 +1009,57 @@ void updateBLE() {
 
     // ✅ UPDATED: Status change only - send as JSON
     static bool lastStableState = false;
-    if (isStable != lastStableState && pStatusChar) {
-        StaticJsonDocument<128> doc;
-        doc["zeroed"] = true;  // Assume tared if running
-        doc["calibrated"] = (BASE_CALIBRATION > 0);
-        doc["error"] = "";  // Add error message if needed
-        String json;
-        serializeJson(doc, json);
+    static bool lastStreaming = false;
+    static uint32_t lastDropped = 0;
+    static uint8_t lastTareState = TareMachine<ScaleConfig>::IDLE;
+    static uint8_t lastTareProgress = 0;
+    uint32_t dropped = streamDropped + streamDiscarded;
+    if ((isStable != lastStableState || streaming != lastStreaming || dropped != lastDropped ||
+         tare.state() != lastTareState || tare.progress() != lastTareProgress) &&
+        pStatusChar) {
+        String json = buildStatusJson(true);  // Assume tared if running
         pStatusChar->setValue(json.c_str());
         pStatusChar->notify();
         lastStableState = isStable;
+        lastStreaming = streaming;
+        lastDropped = dropped;
+        lastTareState = tare.state();
+        lastTareProgress = tare.progress();
     }
 }
 
+String buildStatusJson(bool zeroed) {
+    AcquisitionStats acq = acquisition.getStats();
+    StaticJsonDocument<256> doc;
+    doc["zeroed"] = zeroed;
+    doc["calibrated"] = (BASE_CALIBRATION > 0);
+    doc["error"] = (tare.state() == TareMachine<ScaleConfig>::FAILED)
+        ? TareMachine<ScaleConfig>::failureName(tare.failure()) : "";
+    doc["tare"] = TareMachine<ScaleConfig>::stateName(tare.state());
+    doc["tareProgress"] = tare.progress();
+    doc["streaming"] = streaming;
+    doc["streamSent"] = streamBatches;
+    doc["streamDropped"] = streamDropped + streamDiscarded;
+    doc["samplesLost"] = acq.missed + acq.overruns;
+    String json;
+    serializeJson(doc, json);
+    return json;
+}
+
 // ================================================================
 // BLE STACK (CrewChiefSteve Standard UUIDs)
 // ================================================================
 
 void initializeBLE() {
     BLEDevice::init(deviceName.c_str());
+    BLEDevice::setMTU(WeightStreamPacker::MAX_PAYLOAD + 3);  // Larger stream batches
+    BLEDevice::setCustomGattsHandler(gattsEventHook);        // Stream congestion and drops
 
     pServer = BLEDevice::createServer();
     pServer->setCallbacks(new MyServerCB());
 
-    BLEService* pService = pServer->createService(SERVICE_UUID);
+    // 9 characteristics need more than the default 15 attribute handles
+    BLEService* pService = pServer->createService(BLEUUID(SERVICE_UUID), 32);
 
     // Weight (read+notify) - Primary data, Float32LE binary format
     pWeightChar = pService->createCharacteristic(
@@ -728,12 +1099,7 @@ void initializeBLE() {
         BLECharacteristic::PROPERTY_READ | BLECharacteristic::PROPERTY_NOTIFY
     );
     pStatusChar->addDescriptor(new BLE2902());
-    StaticJsonDocument<128> statusDoc;
-    statusDoc["zeroed"] = false;
-    statusDoc["calibrated"] = (BASE_CALIBRATION > 0);
-    statusDoc["error"] = "";
-    String statusJson;
-    serializeJson(statusDoc, statusJson);
+    String statusJson = buildStatusJson(false);
     pStatusChar->setValue(statusJson.c_str());
 
     // Corner ID (read+write+notify) - ✅ UPDATED: UInt8 (0-3) instead of String
@@ -756,6 +1122,24 @@ void initializeBLE() {
     uint8_t initialBattery = 100;
     pBatteryChar->setValue(&initialBattery, 1);
 
+    // High-rate stream (write+notify) - batched raw/filtered samples at 80 Hz
+    pStreamChar = pService->createCharacteristic(
+        STREAM_CHAR_UUID,
+        BLECharacteristic::PROPERTY_WRITE | BLECharacteristic::PROPERTY_NOTIFY
+    );
+    pStreamChar->addDescriptor(new BLE2902());
+    pStreamChar->setCallbacks(new StreamCB());
+
+    // Four-corner snapshot (read+write+notify) - write 0x01 to freeze
+    pSnapshotChar = pService->createCharacteristic(
+        SNAPSHOT_CHAR_UUID,
+        BLECharacteristic::PROPERTY_READ |
+        BLECharacteristic::PROPERTY_WRITE |
+        BLECharacteristic::PROPERTY_NOTIFY
+    );
+    pSnapshotChar->addDescriptor(new BLE2902());
+    pSnapshotChar->setCallbacks(new SnapshotCB());
+
     pService->start();
 
     // Optimized advertising
@@ -770,6 +1154,314 @@ void initializeBLE() {
     Serial.println("   Connect from iOS/Android app");
 }
 
+// ================================================================
+// FOUR-CORNER SYNC (ESP-NOW beacons, freeze, snapshot)
+// ================================================================
+
+static void fillSyncHeader(SyncHeader& h, uint8_t type) {
+    h.magic = SYNC_MAGIC;
+    h.type = type;
+    h.group = SYNC_GROUP;
+    h.corner = cornerIDInt;
+}
+
+// Broadcast one frame (loop only). A beacon sent with nothing else in
+// flight gets its send-complete time stamped by onSyncSent.
+static bool sendSyncFrame(const void* frame, size_t len, bool stampBeacon, uint8_t seq) {
+    portENTER_CRITICAL(&syncMux);
+    if (stampBeacon && syncSendsInFlight == 0) {
+        beaconStampPending = true;
+        beaconStampSeq = seq;
+    }
+    syncSendsInFlight++;
+    portEXIT_CRITICAL(&syncMux);
+
+    bool ok = esp_now_send(SYNC_BROADCAST, (const uint8_t*)frame, len) == ESP_OK;
+    if (!ok) {
+        portENTER_CRITICAL(&syncMux);
+        syncSendsInFlight--;
+        beaconStampPending = false;
+        portEXIT_CRITICAL(&syncMux);
+    }
+    return ok;
+}
+
+// ESP-NOW send callback (WiFi task). Callbacks arrive in send order, so
+// with nothing queued ahead of it the first one belongs to the beacon.
+void onSyncSent(const uint8_t* mac, esp_now_send_status_t status) {
+    uint64_t now = (uint64_t)esp_timer_get_time();
+    portENTER_CRITICAL(&syncMux);
+    if (syncSendsInFlight > 0) {
+        syncSendsInFlight--;
+    }
+    if (beaconStampPending) {
+        beaconStampPending = false;
+        if (status == ESP_NOW_SEND_SUCCESS) {
+            beaconTxUs = now;
+            beaconTxSeq = beaconStampSeq;
+        }
+    }
+    portEXIT_CRITICAL(&syncMux);
+}
+
+// ESP-NOW receive callback (WiFi task): stamp and hand to loop()
+void onSyncRecv(const uint8_t* mac, const uint8_t* data, int len) {
+    SyncRxFrame frame;
+    frame.rxUs = (uint64_t)esp_timer_get_time();
+    if (len < (int)sizeof(SyncHeader) || len > (int)sizeof(frame.data)) {
+        return;
+    }
+    frame.len = (uint8_t)len;
+    memcpy(frame.data, data, len);
+    xQueueSend(syncRxQueue, &frame, 0);
+}
+
+static void sendBeacon() {
+    SyncBeaconPacket b;
+    fillSyncHeader(b.hdr, SYNC_BEACON);
+    portENTER_CRITICAL(&syncMux);
+    b.prevSeq = beaconTxSeq;
+    b.prevTxUs = beaconTxUs;
+    portEXIT_CRITICAL(&syncMux);
+    b.seq = ++beaconSeq;
+    sendSyncFrame(&b, sizeof(b), true, b.seq);
+}
+
+static void sendFreeze() {
+    SyncFreezePacket f;
+    fillSyncHeader(f.hdr, SYNC_FREEZE);
+    f.snapshotId = freezeId;
+    f.atUs = freezeAtUs;
+    sendSyncFrame(&f, sizeof(f), false, 0);
+}
+
+// Latch this scale's weight at a coordinator time
+static void armFreeze(uint16_t id, uint64_t coordAtUs) {
+    uint64_t now = (uint64_t)esp_timer_get_time();
+    latchId = id;
+    latchSynced = syncClock.synced(now);
+    // Without a clock the best we can do is the next sample, flagged
+    freezeLatch.arm((uint32_t)(latchSynced ? syncClock.toLocal(coordAtUs) : now));
+}
+
+// Coordinator: schedule a freeze for all four corners
+static void startFreeze() {
+    if (snapshot.isActive()) {
+        Serial.println("⚠ Freeze already in progress");
+        return;
+    }
+    freezeId++;
+    freezeAtUs = (uint64_t)esp_timer_get_time() + ScaleConfig::FREEZE_LEAD_MS * 1000ULL;
+    snapshot.begin(freezeId, millis());
+    armFreeze(freezeId, freezeAtUs);
+
+    sendFreeze();
+    freezeRepeatsLeft = ScaleConfig::FREEZE_REPEATS - 1;
+    lastFreezeSendMs = millis();
+}
+
+void requestFreeze() {
+    if (!syncReady) {
+        Serial.println("✗ Sync disabled - no snapshot");
+        return;
+    }
+    if (syncCoordinator) {
+        startFreeze();
+    } else {
+        SyncHeader h;
+        fillSyncHeader(h, SYNC_FREEZE_REQUEST);
+        sendSyncFrame(&h, sizeof(h), false, 0);
+        Serial.println("❄ Freeze requested from coordinator");
+    }
+}
+
+static void publishSnapshot(const CornerSnapshotPacket& s) {
+    if (pSnapshotChar) {
+        pSnapshotChar->setValue((uint8_t*)&s, sizeof(s));
+        if (deviceConnected) {
+            pSnapshotChar->notify();
+        }
+    }
+
+    Serial.printf("\n=== ❄ SNAPSHOT #%u ===\n", s.snapshotId);
+    for (uint8_t c = 0; c < SYNC_CORNERS; c++) {
+        if (s.present & (1 << c)) {
+            Serial.printf("%s: %8.2f lbs %s\n", CORNER_NAMES[c], s.cornerCenti[c] / 100.0f,
+                (s.stable & (1 << c)) ? "" : "(moving)");
+        } else {
+            Serial.printf("%s:   (no report)\n", CORNER_NAMES[c]);
+        }
+    }
+    Serial.printf("Total: %.2f lbs\n", s.totalCenti / 100.0f);
+    if (s.crossPct != SNAPSHOT_PCT_NA) {
+        Serial.printf("Cross: %.2f%% | Left: %.2f%% | Rear: %.2f%%\n",
+            s.crossPct / 100.0f, s.leftPct / 100.0f, s.rearPct / 100.0f);
+    }
+    if (s.maxSyncErrUs == 0xFFFF) {
+        Serial.println("⚠ A corner was not time-synced");
+    } else {
+        Serial.printf("Sync jitter: %u us\n", s.maxSyncErrUs);
+    }
+    Serial.println("=====================\n");
+}
+
+static void handleSyncFrame(const SyncRxFrame& f) {
+    SyncHeader h;
+    memcpy(&h, f.data, sizeof(h));
+    if (h.magic != SYNC_MAGIC || h.group != SYNC_GROUP) {
+        return;
+    }
+    if (h.corner == cornerIDInt) {
+        if (!cornerConflictWarned) {
+            Serial.printf("⚠ Another scale in group %d is also %s\n", SYNC_GROUP, cornerID.c_str());
+            cornerConflictWarned = true;
+        }
+        return;
+    }
+
+    if (h.type == SYNC_BEACON && f.len == sizeof(SyncBeaconPacket)) {
+        if (!syncCoordinator && h.corner == SYNC_COORDINATOR_CORNER) {
+            SyncBeaconPacket b;
+            memcpy(&b, f.data, sizeof(b));
+            syncClock.onBeacon(b, f.rxUs);
+        }
+    } else if (h.type == SYNC_FREEZE && f.len == sizeof(SyncFreezePacket)) {
+        SyncFreezePacket p;
+        memcpy(&p, f.data, sizeof(p));
+        // Repeats of the same freeze carry the same time
+        if (!syncCoordinator && h.corner == SYNC_COORDINATOR_CORNER && p.atUs != freezeAtUs) {
+            freezeAtUs = p.atUs;
+            armFreeze(p.snapshotId, p.atUs);
+        }
+    } else if (h.type == SYNC_FREEZE_REQUEST) {
+        if (syncCoordinator) {
+            Serial.printf("❄ Freeze requested by %s\n", CORNER_NAMES[h.corner % SYNC_CORNERS]);
+            startFreeze();
+        }
+    } else if (h.type == SYNC_REPORT && f.len == sizeof(SyncReportPacket)) {
+        if (syncCoordinator) {
+            SyncReportPacket r;
+            memcpy(&r, f.data, sizeof(r));
+            snapshot.report(r.snapshotId, h.corner, r.weightCenti, r.flags, r.syncErrUs);
+        }
+    }
+}
+
+// Own latch done: report it (followers) or add it (coordinator)
+static void handleLatch() {
+    FreezeLatch::State state = freezeLatch.getState();
+    if (state == FreezeLatch::MISSED) {
+        Serial.printf("⚠ Freeze #%u missed (freeze time outside sample history)\n", latchId);
+        freezeLatch.disarm();
+        return;
+    }
+    if (state != FreezeLatch::LATCHED) {
+        return;
+    }
+    int32_t centi = (int32_t)lroundf(freezeLatch.weight() * 100.0f);
+    uint8_t flags = (freezeLatch.stable() ? SYNC_FLAG_STABLE : 0) |
+                    (latchSynced ? SYNC_FLAG_SYNCED : 0);
+    uint16_t err = syncClock.jitter() > 0xFFFE ? 0xFFFE : (uint16_t)syncClock.jitter();
+    freezeLatch.disarm();
+    Serial.printf("❄ Freeze #%u: %.2f lbs%s\n", latchId, centi / 100.0f,
+        latchSynced ? "" : " (clock not synced)");
+
+    if (syncCoordinator) {
+        snapshot.report(latchId, cornerIDInt, centi, flags, err);
+        return;
+    }
+    fillSyncHeader(pendingReport.hdr, SYNC_REPORT);
+    pendingReport.snapshotId = latchId;
+    pendingReport.weightCenti = centi;
+    pendingReport.flags = flags;
+    pendingReport.syncErrUs = err;
+    sendSyncFrame(&pendingReport, sizeof(pendingReport), false, 0);
+    reportResendsLeft = ScaleConfig::FREEZE_REPEATS - 1;
+    lastReportMs = millis();
+}
+
+void processSync() {
+    if (!syncReady) return;
+    unsigned long now = millis();
+
+    SyncRxFrame frame;
+    while (xQueueReceive(syncRxQueue, &frame, 0) == pdTRUE) {
+        handleSyncFrame(frame);
+    }
+
+    handleLatch();
+
+    // Broadcasts are not acknowledged; send freezes and reports a few times
+    if (reportResendsLeft > 0 && now - lastReportMs >= ScaleConfig::FREEZE_REPEAT_MS) {
+        sendSyncFrame(&pendingReport, sizeof(pendingReport), false, 0);
+        reportResendsLeft--;
+        lastReportMs = now;
+    }
+
+    if (!syncCoordinator) return;
+
+    if (now - lastBeaconMs >= ScaleConfig::SYNC_BEACON_MS) {
+        sendBeacon();
+        lastBeaconMs = now;
+    }
+    if (freezeRepeatsLeft > 0 && now - lastFreezeSendMs >= ScaleConfig::FREEZE_REPEAT_MS) {
+        sendFreeze();
+        freezeRepeatsLeft--;
+        lastFreezeSendMs = now;
+    }
+    if (snapshot.complete() || snapshot.expired(now, ScaleConfig::SNAPSHOT_TIMEOUT_MS)) {
+        publishSnapshot(snapshot.finish());
+    }
+}
+
+void initSync() {
+    if (!ScaleConfig::SYNC_ENABLED) {
+        return;
+    }
+    syncCoordinator = (cornerIDInt == SYNC_COORDINATOR_CORNER);
+    syncClock.setCoordinator(syncCoordinator);
+
+    WiFi.mode(WIFI_STA);
+    WiFi.disconnect();
+    esp_wifi_set_channel(ScaleConfig::SYNC_CHANNEL, WIFI_SECOND_CHAN_NONE);
+
+    syncRxQueue = xQueueCreate(8, sizeof(SyncRxFrame));
+    if (esp_now_init() != ESP_OK) {
+        Serial.println("❌ ESP-NOW init failed - four-corner sync disabled");
+        return;
+    }
+    esp_now_register_recv_cb(onSyncRecv);
+    esp_now_register_send_cb(onSyncSent);
+
+    esp_now_peer_info_t peer = {};
+    memcpy(peer.peer_addr, SYNC_BROADCAST, sizeof(SYNC_BROADCAST));
+    peer.channel = ScaleConfig::SYNC_CHANNEL;
+    peer.ifidx = WIFI_IF_STA;
+    peer.encrypt = false;
+    esp_now_add_peer(&peer);
+
+    syncReady = true;
+    Serial.printf("✓ Four-corner sync: %s (group %d, channel %d)\n",
+        syncCoordinator ? "coordinator" : "follower", SYNC_GROUP, ScaleConfig::SYNC_CHANNEL);
+}
+
+void printSyncStats() {
+    if (!syncReady) {
+        Serial.println("Sync: disabled");
+        return;
+    }
+    if (syncCoordinator) {
+        Serial.printf("Sync: coordinator (group %d), %u beacons sent\n", SYNC_GROUP, beaconSeq);
+        return;
+    }
+    const SyncClockStats& s = syncClock.getStats();
+    Serial.printf("Sync: follower (group %d), %s, offset %lld us, jitter %lu us\n",
+        SYNC_GROUP, syncClock.synced((uint64_t)esp_timer_get_time()) ? "synced" : "NOT synced",
+        (long long)syncClock.offset(), (unsigned long)syncClock.jitter());
+    Serial.printf("      %lu beacon pairs, %lu outliers, %lu relocks\n",
+        (unsigned long)s.updates, (unsigned long)s.outliers, (unsigned long)s.relocks);
+}
+
 // ================================================================
 // NVS PERSISTENCE
 // ================================================================
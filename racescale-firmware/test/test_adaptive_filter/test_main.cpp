@@ -0,0 +1,295 @@
+// Host tests and benchmark for AdaptiveFilter on simulated HX711 traces,
+// against the window scan it replaced (pio test -e native)
+
+#include <stdio.h>
+#include <math.h>
+#include <chrono>
+#include <unity.h>
+#include "adaptive_filter.h"
+
+// Filter tuning from config.h (which pulls in Arduino.h)
+struct TestConfig {
+    static constexpr float FAST_FILTER_ALPHA = 0.7f;
+    static constexpr float SLOW_FILTER_ALPHA = 0.20f;
+    static constexpr float CHANGE_DETECT_THRESHOLD = 0.3f;
+    static constexpr float STABILITY_RANGE = 0.15f;
+    static constexpr uint8_t STABILITY_WINDOW = 5;
+    static constexpr uint32_t SETTLE_TIME_MS = 1500;
+};
+
+constexpr float TestConfig::FAST_FILTER_ALPHA;
+constexpr float TestConfig::SLOW_FILTER_ALPHA;
+constexpr float TestConfig::CHANGE_DETECT_THRESHOLD;
+constexpr float TestConfig::STABILITY_RANGE;
+constexpr uint32_t TestConfig::SETTLE_TIME_MS;
+
+typedef AdaptiveFilter<TestConfig, TestConfig::STABILITY_WINDOW> ScaleFilter;
+
+// The previous filter: same EMA, stability by scanning the whole window on
+// every isStable() call. Timestamps and the primed flag as in the new one,
+// so the two must agree sample for sample.
+template <typename Config, uint8_t WINDOW>
+class ScanFilter {
+private:
+    bool primed = false;
+    float lastValue = 0;
+    float lastRawValue = 0;
+    uint32_t lastChangeUs = 0;
+    bool inTransition = false;
+    float stabilityBuffer[WINDOW] = {0};
+    uint8_t stabilityIndex = 0;
+    uint32_t samples = 0;
+
+public:
+    float update(float raw, uint32_t nowUs) {
+        if (!primed) {
+            primed = true;
+            lastValue = raw;
+            lastRawValue = raw;
+        }
+        if (fabsf(raw - lastRawValue) > Config::CHANGE_DETECT_THRESHOLD) {
+            inTransition = true;
+            lastChangeUs = nowUs;
+        }
+        if (inTransition && (nowUs - lastChangeUs > Config::SETTLE_TIME_MS * 1000UL)) {
+            inTransition = false;
+        }
+        float alpha = inTransition ? Config::FAST_FILTER_ALPHA : Config::SLOW_FILTER_ALPHA;
+        lastValue = (alpha * raw) + ((1.0f - alpha) * lastValue);
+        lastRawValue = raw;
+
+        stabilityBuffer[stabilityIndex] = lastValue;
+        stabilityIndex = (uint8_t)((stabilityIndex + 1) % WINDOW);
+        samples++;
+        return lastValue;
+    }
+
+    bool isStable() const {
+        if (inTransition || samples < WINDOW) return false;
+        float minVal = stabilityBuffer[0];
+        float maxVal = stabilityBuffer[0];
+        for (int i = 1; i < WINDOW; i++) {
+            if (stabilityBuffer[i] < minVal) minVal = stabilityBuffer[i];
+            if (stabilityBuffer[i] > maxVal) maxVal = stabilityBuffer[i];
+        }
+        return (maxVal - minVal) < Config::STABILITY_RANGE;
+    }
+};
+
+// ================================================================
+// HX711 TRACE
+// ================================================================
+// One corner scale at 80 Hz, averaged in pairs as processWeightSamples()
+// does, so the filter runs at 40 Hz. Counts carry about 60 counts of noise
+// (0.02 lb at the default calibration) plus a 4 Hz rocking of the car.
+// The load script: empty scale, car rolled on, settled, a crew member
+// leaning on the fender, car rolled off.
+
+static const float COUNTS_PER_LB = 2843.0f;
+static const uint32_t CONVERSION_US = 12500;
+static const uint8_t BLOCK = 2;
+
+struct Hx711Trace {
+    uint32_t state;
+    uint32_t conversion = 0;
+    uint32_t startUs;
+
+    explicit Hx711Trace(uint32_t seed, uint32_t startUs = 0)
+        : state(seed * 2654435761u + 1), startUs(startUs) {}
+
+    float uniform() {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return (state & 0xFFFFFF) / (float)0x1000000;
+    }
+
+    // Corner load in lb at t seconds
+    static float load(float t) {
+        if (t < 3.0f) return 0.0f;
+        if (t < 3.5f) return 412.0f * (t - 3.0f) / 0.5f;
+        if (t < 10.0f) return 412.0f + 6.0f * expf(-(t - 3.5f) * 2.0f) * sinf(25.0f * t);
+        if (t < 11.0f) return 442.0f;
+        if (t < 16.0f) return 412.0f;
+        if (t < 16.5f) return 412.0f * (16.5f - t) / 0.5f;
+        return 0.0f;
+    }
+
+    static const uint32_t DURATION_US = 20000000;
+
+    // Next block average in lb, and its timestamp
+    float next(uint32_t& timestampUs, float& trueLb) {
+        int64_t sum = 0;
+        for (uint8_t i = 0; i < BLOCK; i++) {
+            float t = conversion * (CONVERSION_US / 1e6f);
+            float noise = (uniform() + uniform() + uniform() - 1.5f) * 120.0f;
+            sum += (int64_t)lroundf(load(t) * COUNTS_PER_LB + noise);
+            conversion++;
+        }
+        uint32_t elapsed = (conversion - 1) * CONVERSION_US;
+        timestampUs = startUs + elapsed;
+        trueLb = load(elapsed / 1e6f);
+        return (float)sum / BLOCK / COUNTS_PER_LB;
+    }
+
+    bool done() const { return conversion * CONVERSION_US >= DURATION_US; }
+};
+
+void setUp(void) {}
+void tearDown(void) {}
+
+// The deques must give exactly what a scan of the window gives
+template <uint8_t WINDOW>
+static void checkMatchesScan(void) {
+    for (uint32_t seed = 1; seed <= 4; seed++) {
+        AdaptiveFilter<TestConfig, WINDOW> filter;
+        ScanFilter<TestConfig, WINDOW> scan;
+        Hx711Trace trace(seed);
+        uint32_t stableSamples = 0;
+        while (!trace.done()) {
+            uint32_t us;
+            float trueLb;
+            float raw = trace.next(us, trueLb);
+            float expected = scan.update(raw, us);
+            float out = filter.update(raw, us);
+            TEST_ASSERT_EQUAL_FLOAT(expected, out);
+            TEST_ASSERT_EQUAL(scan.isStable(), filter.isStable());
+            if (filter.isStable()) stableSamples++;
+        }
+        TEST_ASSERT_GREATER_THAN_UINT32(0, stableSamples);
+    }
+}
+
+void test_matches_scan_window_2(void) { checkMatchesScan<2>(); }
+void test_matches_scan_window_5(void) { checkMatchesScan<5>(); }
+void test_matches_scan_window_40(void) { checkMatchesScan<40>(); }
+void test_matches_scan_window_100(void) { checkMatchesScan<100>(); }
+
+// Loaded and left alone: stable within settle time plus a window, reading
+// within the stability range of the true load; never stable mid-ramp
+void test_stable_after_car_settles(void) {
+    ScaleFilter filter;
+    Hx711Trace trace(7);
+    float stableAtS = -1;
+    while (!trace.done()) {
+        uint32_t us;
+        float trueLb;
+        float raw = trace.next(us, trueLb);
+        float out = filter.update(raw, us);
+        float t = us / 1e6f;
+        bool ramping = (t > 3.0f && t < 3.5f) || (t > 16.0f && t < 16.5f);
+        if (ramping) {
+            TEST_ASSERT_FALSE(filter.isStable());
+        }
+        if (t > 3.5f && t < 10.0f && filter.isStable() && stableAtS < 0) {
+            stableAtS = t;
+        }
+        if (t > 9.0f && t < 10.0f) {
+            TEST_ASSERT_TRUE(filter.isStable());
+            TEST_ASSERT_FLOAT_WITHIN(TestConfig::STABILITY_RANGE, 412.0f, out);
+        }
+        if (t > 19.0f) {
+            TEST_ASSERT_FLOAT_WITHIN(TestConfig::STABILITY_RANGE, 0.0f, out);
+        }
+    }
+    char msg[64];
+    snprintf(msg, sizeof(msg), "stable %.2f s after the car is on", stableAtS - 3.5f);
+    TEST_MESSAGE(msg);
+    TEST_ASSERT_TRUE(stableAtS > 0);
+    TEST_ASSERT_LESS_THAN_FLOAT(TestConfig::SETTLE_TIME_MS / 1000.0f + 2.0f, stableAtS - 3.5f);
+}
+
+// An empty scale reads exactly zero; the old lastValue == 0 test re-primed
+// the filter there, so the first loaded sample jumped straight through
+void test_exact_zero_does_not_reprime(void) {
+    ScaleFilter filter;
+    uint32_t us = 0;
+    for (int i = 0; i < 100; i++, us += 25000) filter.update(0.0f, us);
+    float out = filter.update(100.0f, us);
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, 100.0f * TestConfig::FAST_FILTER_ALPHA, out);
+}
+
+// Settling is timed on the acquisition clock, which wraps every 71 min
+void test_settle_across_timestamp_wrap(void) {
+    ScaleFilter filter;
+    Hx711Trace trace(3, 0xFFFFFFFFu - 3500000u);    // Wraps as the car rolls on
+    float stableAtS = -1;
+    while (!trace.done()) {
+        uint32_t us;
+        float trueLb;
+        float raw = trace.next(us, trueLb);
+        filter.update(raw, us);
+        float t = (us - (0xFFFFFFFFu - 3500000u)) / 1e6f;
+        if (t > 3.5f && t < 10.0f && filter.isStable() && stableAtS < 0) {
+            stableAtS = t;
+        }
+    }
+    TEST_ASSERT_TRUE(stableAtS > 0);
+    TEST_ASSERT_LESS_THAN_FLOAT(TestConfig::SETTLE_TIME_MS / 1000.0f + 2.0f, stableAtS - 3.5f);
+}
+
+// A reset (tare) needs a full window again before reporting stable
+void test_reset_needs_full_window(void) {
+    ScaleFilter filter;
+    uint32_t us = 0;
+    for (int i = 0; i < 100; i++, us += 25000) filter.update(50.0f, us);
+    TEST_ASSERT_TRUE(filter.isStable());
+
+    filter.reset();
+    for (int i = 0; i < TestConfig::STABILITY_WINDOW - 1; i++, us += 25000) {
+        filter.update(0.0f, us);
+        TEST_ASSERT_FALSE(filter.isStable());
+    }
+    filter.update(0.0f, us);
+    TEST_ASSERT_TRUE(filter.isStable());
+}
+
+// update() + isStable() per sample, as processWeightSamples() calls them.
+// Host figures, relative only.
+template <typename Filter>
+static double nsPerSample(Filter& filter, int samples) {
+    volatile float sinkF = 0;
+    volatile bool sinkB = false;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < samples; i++) {
+        sinkF = filter.update(412.0f + (i & 15) * 0.01f, (uint32_t)i * 25000u);
+        sinkB = filter.isStable();
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    (void)sinkF;
+    (void)sinkB;
+    return std::chrono::duration<double, std::nano>(t1 - t0).count() / samples;
+}
+
+void test_benchmark_cost_per_sample(void) {
+    const int SAMPLES = 2000000;
+    AdaptiveFilter<TestConfig, 5> deque5;
+    ScanFilter<TestConfig, 5> scan5;
+    AdaptiveFilter<TestConfig, 80> deque80;
+    ScanFilter<TestConfig, 80> scan80;
+
+    double d5 = nsPerSample(deque5, SAMPLES);
+    double s5 = nsPerSample(scan5, SAMPLES);
+    double d80 = nsPerSample(deque80, SAMPLES);
+    double s80 = nsPerSample(scan80, SAMPLES);
+
+    char msg[96];
+    snprintf(msg, sizeof(msg), "window 5: deques %.1f ns, scan %.1f ns per sample", d5, s5);
+    TEST_MESSAGE(msg);
+    snprintf(msg, sizeof(msg), "window 80 (2 s): deques %.1f ns, scan %.1f ns per sample", d80, s80);
+    TEST_MESSAGE(msg);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_matches_scan_window_2);
+    RUN_TEST(test_matches_scan_window_5);
+    RUN_TEST(test_matches_scan_window_40);
+    RUN_TEST(test_matches_scan_window_100);
+    RUN_TEST(test_stable_after_car_settles);
+    RUN_TEST(test_exact_zero_does_not_reprime);
+    RUN_TEST(test_settle_across_timestamp_wrap);
+    RUN_TEST(test_reset_needs_full_window);
+    RUN_TEST(test_benchmark_cost_per_sample);
+    return UNITY_END();
+}